@@ -0,0 +1,38 @@
+#include "AllocationCount.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Kept apart from code that allocates, so the compiler never sees the
+// replacement operators inlined next to library allocations
+namespace {
+std::atomic<uint64_t> g_allocations = 0;
+std::atomic<uint64_t> g_allocatedBytes = 0;
+}  // namespace
+
+// Every operator new overload without an explicit alignment ends up here
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace benchmarks {
+AllocationCount AllocationCount::current() {
+  return {
+      g_allocations.load(std::memory_order_relaxed),
+      g_allocatedBytes.load(std::memory_order_relaxed)};
+}
+}  // namespace benchmarks
@@ -0,0 +1,21 @@
+#ifndef ALLOCATION_COUNT_HPP
+#define ALLOCATION_COUNT_HPP
+
+#include <cstdint>
+
+namespace benchmarks {
+
+/**
+ * Heap allocations made by the process so far, counted by the replaced global
+ * operator new
+ */
+struct AllocationCount {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+
+  static AllocationCount current();
+};
+
+}  // namespace benchmarks
+
+#endif  // ALLOCATION_COUNT_HPP
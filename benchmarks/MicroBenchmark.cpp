@@ -0,0 +1,81 @@
+#include "MicroBenchmark.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+
+#include "Json.hpp"
+
+namespace {
+double perSecond(double amount, double milliseconds) {
+  return milliseconds > 0.0 ? amount * 1000.0 / milliseconds : 0.0;
+}
+}  // namespace
+
+namespace benchmarks {
+MicroBenchmark::MicroBenchmark(uint32_t iterations, std::string filter)
+    : m_iterations(iterations), m_filter(std::move(filter)) {}
+
+void MicroBenchmark::report(const Result& result) {
+  double median = result.milliseconds.percentile(50.0);
+
+  // Printed directly, release builds compile informational logging out
+  fmt::print(
+      "{:<28} p50 {:>9.4f}ms  p95 {:>9.4f}ms  {:>12.0f} items/s  "
+      "{:>9.1f} MB/s  {:>8.1f} allocs  {:>11.0f} B\n",
+      result.name,
+      median,
+      result.milliseconds.percentile(95.0),
+      perSecond(static_cast<double>(result.workload.items), median),
+      perSecond(static_cast<double>(result.workload.bytes), median) / 1e6,
+      result.allocationsPerIteration,
+      result.allocatedBytesPerIteration
+  );
+}
+
+void MicroBenchmark::writeJson(
+    const std::filesystem::path& path,
+    const std::vector<std::pair<std::string, std::string>>& properties
+) const {
+  std::ofstream out(path);
+
+  if (!out.is_open()) {
+    SPDLOG_ERROR("Failed to write {}", path.string());
+    return;
+  }
+
+  out << "{\n  \"iterations\": " << m_iterations;
+
+  for (const auto& [key, value] : properties) {
+    out << ",\n  ";
+    engine::writeJsonString(out, key);
+    out << ": ";
+    engine::writeJsonString(out, value);
+  }
+
+  out << ",\n  \"benchmarks\": [";
+
+  for (std::size_t i = 0; i < m_results.size(); ++i) {
+    const auto& result = m_results[i];
+    double median = result.milliseconds.percentile(50.0);
+
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+    engine::writeJsonString(out, result.name);
+    out << ", \"mean\": " << result.milliseconds.average()
+        << ", \"p50\": " << median
+        << ", \"p95\": " << result.milliseconds.percentile(95.0)
+        << ", \"max\": " << result.milliseconds.max()
+        << ", \"itemsPerSecond\": "
+        << perSecond(static_cast<double>(result.workload.items), median)
+        << ", \"bytesPerSecond\": "
+        << perSecond(static_cast<double>(result.workload.bytes), median)
+        << ", \"allocations\": " << result.allocationsPerIteration
+        << ", \"allocatedBytes\": " << result.allocatedBytesPerIteration
+        << "}";
+  }
+
+  out << "\n  ]\n}\n";
+
+  fmt::print("Results written to {}\n", path.string());
+}
+}  // namespace benchmarks
@@ -0,0 +1,103 @@
+#ifndef MICRO_BENCHMARK_HPP
+#define MICRO_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AllocationCount.hpp"
+#include "Statistics.hpp"
+
+namespace benchmarks {
+
+/**
+ * Amount of work done by one iteration, to report throughput
+ */
+struct Workload {
+  uint64_t items = 0;
+  uint64_t bytes = 0;
+};
+
+/**
+ * Runs each benchmark body for a fixed number of iterations after one
+ * unmeasured warmup iteration, and keeps per-iteration timings and heap
+ * allocations.
+ */
+class MicroBenchmark {
+ public:
+  struct Result {
+    std::string name;
+    Workload workload;
+    engine::RollingStatistics milliseconds;
+    double allocationsPerIteration;
+    double allocatedBytesPerIteration;
+  };
+
+  /**
+   * @param filter only benchmarks whose name contains it are run
+   */
+  MicroBenchmark(uint32_t iterations, std::string filter);
+
+  template <typename Body>
+  void run(const std::string& name, Workload workload, Body&& body) {
+    if (name.find(m_filter) == std::string::npos) {
+      return;
+    }
+
+    body();
+
+    Result result{
+        name, workload, engine::RollingStatistics(m_iterations), 0.0, 0.0};
+    auto allocationsBefore = AllocationCount::current();
+
+    for (uint32_t i = 0; i < m_iterations; ++i) {
+      auto start = Clock::now();
+      body();
+      result.milliseconds.add(Milliseconds(Clock::now() - start).count());
+    }
+
+    auto allocationsAfter = AllocationCount::current();
+    result.allocationsPerIteration =
+        static_cast<double>(
+            allocationsAfter.allocations - allocationsBefore.allocations
+        ) /
+        m_iterations;
+    result.allocatedBytesPerIteration =
+        static_cast<double>(allocationsAfter.bytes - allocationsBefore.bytes) /
+        m_iterations;
+
+    report(result);
+    m_results.push_back(std::move(result));
+  }
+
+  void writeJson(
+      const std::filesystem::path& path,
+      const std::vector<std::pair<std::string, std::string>>& properties
+  ) const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  uint32_t m_iterations;
+  std::string m_filter;
+  std::vector<Result> m_results;
+
+  static void report(const Result& result);
+};
+
+/**
+ * Keeps the compiler from optimizing away a result that is never read
+ */
+template <typename T>
+void doNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace benchmarks
+
+#endif  // MICRO_BENCHMARK_HPP
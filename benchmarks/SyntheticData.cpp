@@ -0,0 +1,228 @@
+#include "SyntheticData.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+namespace benchmarks {
+namespace {
+constexpr std::size_t MAX_STORED_BLOCK_SIZE = 65535;
+
+float gridHeight(uint32_t x, uint32_t y, uint32_t gridSize) {
+  float u = static_cast<float>(x) / gridSize;
+  float v = static_cast<float>(y) / gridSize;
+  return 0.1f * std::sin(u * 12.0f) * std::cos(v * 9.0f);
+}
+
+engine::Vertex gridVertex(uint32_t x, uint32_t y, uint32_t gridSize) {
+  float u = static_cast<float>(x) / gridSize;
+  float v = static_cast<float>(y) / gridSize;
+
+  engine::Vertex vertex{};
+  vertex.pos = {u * 2.0f - 1.0f, gridHeight(x, y, gridSize), v * 2.0f - 1.0f};
+  vertex.color = {1.0f, 1.0f, 1.0f};
+  vertex.texCoord = {u, 1.0f - v};
+  return vertex;
+}
+
+// Corners of the two triangles of quad (x, y), as grid coordinates
+constexpr std::array<std::array<uint32_t, 2>, 6> QUAD_CORNERS = {{
+    {0, 0},
+    {1, 0},
+    {1, 1},
+    {0, 0},
+    {1, 1},
+    {0, 1},
+}};
+
+uint32_t crc32(const uint8_t* data, std::size_t size, uint32_t crc = 0) {
+  static const auto table = [] {
+    std::array<uint32_t, 256> values{};
+
+    for (uint32_t i = 0; i < values.size(); ++i) {
+      uint32_t value = i;
+
+      for (int bit = 0; bit < 8; ++bit) {
+        value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+      }
+
+      values[i] = value;
+    }
+
+    return values;
+  }();
+
+  crc = ~crc;
+
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+
+  return ~crc;
+}
+
+uint32_t adler32(const std::vector<uint8_t>& data) {
+  uint32_t a = 1;
+  uint32_t b = 0;
+
+  for (uint8_t byte : data) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+
+  return (b << 16) | a;
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void appendChunk(
+    std::vector<uint8_t>& out,
+    const char* type,
+    const std::vector<uint8_t>& data
+) {
+  appendBigEndian(out, static_cast<uint32_t>(data.size()));
+
+  std::size_t typeOffset = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+
+  appendBigEndian(
+      out, crc32(out.data() + typeOffset, out.size() - typeOffset)
+  );
+}
+}  // namespace
+
+std::string SyntheticData::generateObj(uint32_t gridSize) {
+  std::ostringstream obj;
+  uint32_t rowLength = gridSize + 1;
+
+  for (uint32_t y = 0; y <= gridSize; ++y) {
+    for (uint32_t x = 0; x <= gridSize; ++x) {
+      auto vertex = gridVertex(x, y, gridSize);
+      obj << "v " << vertex.pos.x << ' ' << vertex.pos.y << ' ' << vertex.pos.z
+          << "\nvt " << vertex.texCoord.x << ' ' << 1.0f - vertex.texCoord.y
+          << '\n';
+    }
+  }
+
+  for (uint32_t y = 0; y < gridSize; ++y) {
+    for (uint32_t x = 0; x < gridSize; ++x) {
+      for (std::size_t corner = 0; corner < QUAD_CORNERS.size(); ++corner) {
+        // OBJ indices start at 1
+        uint32_t index = (y + QUAD_CORNERS[corner][1]) * rowLength + x +
+                         QUAD_CORNERS[corner][0] + 1;
+
+        obj << (corner % 3 == 0 ? "f" : "") << ' ' << index << '/' << index
+            << (corner % 3 == 2 ? "\n" : "");
+      }
+    }
+  }
+
+  return obj.str();
+}
+
+std::vector<engine::Vertex> SyntheticData::generateVertexStream(
+    uint32_t gridSize
+) {
+  std::vector<engine::Vertex> vertices;
+  vertices.reserve(std::size_t{gridSize} * gridSize * QUAD_CORNERS.size());
+
+  for (uint32_t y = 0; y < gridSize; ++y) {
+    for (uint32_t x = 0; x < gridSize; ++x) {
+      for (const auto& corner : QUAD_CORNERS) {
+        vertices.push_back(
+            gridVertex(x + corner[0], y + corner[1], gridSize)
+        );
+      }
+    }
+  }
+
+  return vertices;
+}
+
+std::vector<uint8_t> SyntheticData::generateImage(
+    uint32_t width, uint32_t height
+) {
+  std::vector<uint8_t> pixels(std::size_t{width} * height * 4);
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> noise(-8, 8);
+
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint8_t* pixel = &pixels[(std::size_t{y} * width + x) * 4];
+      int gradient[3] = {
+          static_cast<int>(255 * x / std::max(width, 1u)),
+          static_cast<int>(255 * y / std::max(height, 1u)),
+          static_cast<int>(255 * ((x ^ y) & 0xFF) / 255)};
+
+      for (int c = 0; c < 3; ++c) {
+        int value = std::clamp(gradient[c] + noise(random), 0, 255);
+        pixel[c] = static_cast<uint8_t>(value);
+      }
+
+      pixel[3] = 255;
+    }
+  }
+
+  return pixels;
+}
+
+std::vector<uint8_t> SyntheticData::encodePng(
+    const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height
+) {
+  // Every row starts with its filter type, 0 is no filtering
+  std::size_t rowSize = std::size_t{width} * 4;
+  std::vector<uint8_t> raw;
+  raw.reserve((rowSize + 1) * height);
+
+  for (uint32_t y = 0; y < height; ++y) {
+    raw.push_back(0);
+    raw.insert(
+        raw.end(),
+        pixels.begin() + static_cast<std::ptrdiff_t>(y * rowSize),
+        pixels.begin() + static_cast<std::ptrdiff_t>((y + 1) * rowSize)
+    );
+  }
+
+  // zlib stream: header, stored deflate blocks and the Adler-32 of the data
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+
+  for (std::size_t offset = 0; offset < raw.size() || offset == 0;
+       offset += MAX_STORED_BLOCK_SIZE) {
+    std::size_t size = std::min(MAX_STORED_BLOCK_SIZE, raw.size() - offset);
+    bool isLast = offset + size >= raw.size();
+
+    zlib.push_back(isLast ? 1 : 0);
+    zlib.push_back(static_cast<uint8_t>(size));
+    zlib.push_back(static_cast<uint8_t>(size >> 8));
+    zlib.push_back(static_cast<uint8_t>(~size));
+    zlib.push_back(static_cast<uint8_t>(~size >> 8));
+    zlib.insert(
+        zlib.end(),
+        raw.begin() + static_cast<std::ptrdiff_t>(offset),
+        raw.begin() + static_cast<std::ptrdiff_t>(offset + size)
+    );
+  }
+
+  appendBigEndian(zlib, adler32(raw));
+
+  std::vector<uint8_t> header;
+  appendBigEndian(header, width);
+  appendBigEndian(header, height);
+  // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlacing
+  header.insert(header.end(), {8, 6, 0, 0, 0});
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  appendChunk(png, "IHDR", header);
+  appendChunk(png, "IDAT", zlib);
+  appendChunk(png, "IEND", {});
+
+  return png;
+}
+}  // namespace benchmarks
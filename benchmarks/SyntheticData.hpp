@@ -0,0 +1,47 @@
+#ifndef SYNTHETIC_DATA_HPP
+#define SYNTHETIC_DATA_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Vertex.hpp"
+
+namespace benchmarks {
+
+/**
+ * Inputs of configurable size, generated instead of loaded so every run and
+ * every machine measures the same data
+ */
+class SyntheticData {
+ public:
+  /**
+   * Wavy grid of gridSize x gridSize quads with texture coordinates, two
+   * triangles per quad, as Wavefront OBJ
+   */
+  static std::string generateObj(uint32_t gridSize);
+
+  /**
+   * Triangle corners of the same grid as generateObj, every inner vertex is
+   * repeated by all triangles sharing it
+   */
+  static std::vector<engine::Vertex> generateVertexStream(uint32_t gridSize);
+
+  /**
+   * Tightly packed RGBA8 gradient with some noise, so it does not compress
+   * to nothing
+   */
+  static std::vector<uint8_t> generateImage(uint32_t width, uint32_t height);
+
+  /**
+   * Encodes RGBA8 pixels as PNG with uncompressed deflate blocks, which only
+   * needs a checksum implementation instead of a compressor
+   */
+  static std::vector<uint8_t> encodePng(
+      const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height
+  );
+};
+
+}  // namespace benchmarks
+
+#endif  // SYNTHETIC_DATA_HPP
@@ -0,0 +1,455 @@
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+#include "Abort.hpp"
+#include "BinaryLoader.hpp"
+#include "Camera.hpp"
+#include "Config.hpp"
+#include "MicroBenchmark.hpp"
+#include "MipChain.hpp"
+#include "ModelLoader.hpp"
+#include "SoftwareOcclusion.hpp"
+#include "SyntheticData.hpp"
+#include "UniformBufferObject.hpp"
+
+namespace {
+// Camera and uniform buffer updates are too short to time one by one
+constexpr uint32_t MATH_BATCH_SIZE = 1000;
+
+// Triangles of the synthetic mesh per box tested against the occluders, like
+// the chunks of occlusion culling
+constexpr uint32_t OCCLUSION_BOX_TRIANGLES = 64;
+
+struct Options {
+  uint32_t iterations = 50;
+  uint32_t meshSize = 256;
+  uint32_t textureSize = 1024;
+  std::string filter;
+  std::filesystem::path outputPath;
+  bool showHelp = false;
+};
+
+uint32_t parseCount(std::string_view option, std::string_view value) {
+  uint32_t count = 0;
+  auto [end, error] =
+      std::from_chars(value.data(), value.data() + value.size(), count);
+
+  if (error != std::errc() || end != value.data() + value.size() ||
+      count == 0) {
+    ABORT("Invalid value '{}' for {}", value, option);
+  }
+
+  return count;
+}
+
+Options parseOptions(int argc, char** argv) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view option = argv[i];
+
+    if (option == "-h" || option == "--help") {
+      options.showHelp = true;
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      ABORT("Unknown option or missing value: {}", option);
+    }
+
+    std::string_view value = argv[++i];
+
+    if (option == "--iterations") {
+      options.iterations = parseCount(option, value);
+    } else if (option == "--mesh-size") {
+      options.meshSize = parseCount(option, value);
+    } else if (option == "--texture-size") {
+      options.textureSize = parseCount(option, value);
+    } else if (option == "--filter") {
+      options.filter = value;
+    } else if (option == "--output") {
+      options.outputPath = value;
+    } else {
+      ABORT("Unknown option: {}", option);
+    }
+  }
+
+  return options;
+}
+
+void printUsage(const char* programName) {
+  std::cout
+      << "Usage: " << programName << " [options]\n"
+      << "\n"
+      << "Options:\n"
+      << "  --iterations <n>     measured iterations per benchmark, "
+         "default 50\n"
+      << "  --mesh-size <n>      quads per side of the synthetic mesh, "
+         "default 256\n"
+      << "  --texture-size <n>   width and height of the synthetic texture, "
+         "default 1024\n"
+      << "  --filter <text>      only run benchmarks whose name contains text\n"
+      << "  --output <path>      also write the results as JSON\n"
+      << "  -h, --help           show this help\n";
+}
+
+void writeFile(
+    const std::filesystem::path& path, const void* data, size_t size
+) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(
+      static_cast<const char*>(data), static_cast<std::streamsize>(size)
+  );
+
+  if (!file) {
+    ABORT("Failed to write {}", path.string());
+  }
+}
+
+/**
+ * Aborts unless every rasterization path the CPU runs, on one thread and on
+ * several, fills in the same buffer for the occluders, and unless boxes
+ * around a single quad come out as they should
+ */
+void checkSoftwareOcclusion(
+    const std::vector<glm::vec3>& positions,
+    const std::vector<uint32_t>& indices,
+    const glm::mat4& transform
+) {
+  using engine::SoftwareOcclusion;
+  using InstructionSet = SoftwareOcclusion::InstructionSet;
+
+  // A quad at z = 0 seen from z = 3, with boxes in front of it, hidden
+  // behind it, behind it but off to its side, and off to its side but past
+  // the far plane 10 away
+  std::vector<glm::vec3> quad = {
+      {-1.0f, -1.0f, 0.0f},
+      {1.0f, -1.0f, 0.0f},
+      {1.0f, 1.0f, 0.0f},
+      {-1.0f, 1.0f, 0.0f}};
+  std::vector<uint32_t> quadIndices = {0, 1, 2, 0, 2, 3};
+
+  auto ubo = engine::UniformBufferObject::create(
+      glm::lookAt(
+          glm::vec3(0.0f, 0.0f, 3.0f),
+          glm::vec3(0.0f, 0.0f, 0.0f),
+          glm::vec3(0.0f, 1.0f, 0.0f)
+      ),
+      {1920, 1080}
+  );
+  glm::mat4 quadTransform = ubo.proj * ubo.view * ubo.model;
+
+  struct Box {
+    const char* name;
+    glm::vec3 min;
+    glm::vec3 max;
+    bool visible;
+  };
+
+  const Box boxes[] = {
+      {"in front of", {-0.2f, -0.2f, 1.0f}, {0.2f, 0.2f, 1.2f}, true},
+      {"behind", {-0.2f, -0.2f, -1.2f}, {0.2f, 0.2f, -1.0f}, false},
+      {"beside", {1.5f, -0.2f, -1.2f}, {1.8f, 0.2f, -1.0f}, true},
+      {"past the far plane beside",
+       {5.0f, -0.2f, -8.5f},
+       {5.5f, 0.2f, -8.0f},
+       false}};
+
+  std::vector<float> reference;
+
+  for (InstructionSet instructionSet :
+       {InstructionSet::Scalar, InstructionSet::Sse41, InstructionSet::Avx2}) {
+    if (!SoftwareOcclusion::isSupported(instructionSet)) {
+      continue;
+    }
+
+    for (uint32_t threads : {1u, 4u}) {
+      SoftwareOcclusion occlusion(
+          engine::Config::SOFTWARE_OCCLUSION_WIDTH,
+          engine::Config::SOFTWARE_OCCLUSION_HEIGHT,
+          threads,
+          instructionSet
+      );
+      auto label = fmt::format(
+          "{} x{}", SoftwareOcclusion::toString(instructionSet), threads
+      );
+
+      occlusion.renderOccluders(positions, indices, transform, false);
+
+      std::vector<float> depth;
+      depth.reserve(occlusion.getWidth() * occlusion.getHeight());
+
+      for (uint32_t y = 0; y < occlusion.getHeight(); ++y) {
+        for (uint32_t x = 0; x < occlusion.getWidth(); ++x) {
+          depth.push_back(occlusion.getDepth(x, y));
+        }
+      }
+
+      // The first configuration, scalar on one thread, is the reference
+      if (reference.empty()) {
+        reference = std::move(depth);
+      } else if (depth != reference) {
+        auto mismatch =
+            std::mismatch(depth.begin(), depth.end(), reference.begin());
+        auto pixel = static_cast<uint32_t>(mismatch.first - depth.begin());
+
+        ABORT(
+            "SoftwareOcclusion {} differs from Scalar x1 at pixel ({}, {})",
+            label,
+            pixel % occlusion.getWidth(),
+            pixel / occlusion.getWidth()
+        );
+      }
+
+      occlusion.clear();
+      occlusion.renderOccluders(quad, quadIndices, quadTransform, false);
+
+      for (const Box& box : boxes) {
+        if (occlusion.isVisible(box.min, box.max, quadTransform) !=
+            box.visible) {
+          ABORT(
+              "SoftwareOcclusion {} gets a box {} an occluder wrong",
+              label,
+              box.name
+          );
+        }
+      }
+    }
+  }
+}
+
+void runBenchmarks(const Options& options) {
+  using benchmarks::doNotOptimize;
+  using benchmarks::SyntheticData;
+  using benchmarks::Workload;
+
+  auto directory =
+      std::filesystem::temp_directory_path() / "engine-benchmarks";
+  std::filesystem::create_directories(directory);
+
+  benchmarks::MicroBenchmark benchmark(options.iterations, options.filter);
+
+  // Loaders, reading the synthetic mesh written to disk
+  std::string obj = SyntheticData::generateObj(options.meshSize);
+  auto objPath = directory / "mesh.obj";
+  writeFile(objPath, obj.data(), obj.size());
+
+  uint64_t quads = uint64_t{options.meshSize} * options.meshSize;
+
+  benchmark.run("BinaryLoader::load", {1, obj.size()}, [&] {
+    doNotOptimize(engine::BinaryLoader::load(objPath.string()));
+  });
+
+  benchmark.run("ModelLoader::loadObj", {quads * 6, obj.size()}, [&] {
+    std::vector<engine::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    engine::ModelLoader::loadObj(objPath.string(), vertices, indices);
+    doNotOptimize(indices.data());
+  });
+
+  auto stream = SyntheticData::generateVertexStream(options.meshSize);
+
+  benchmark.run(
+      "VertexDeduplicator::add",
+      {stream.size(), stream.size() * sizeof(engine::Vertex)},
+      [&] {
+        std::vector<engine::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        engine::VertexDeduplicator deduplicator(vertices, indices);
+
+        for (const auto& vertex : stream) {
+          deduplicator.add(vertex);
+        }
+
+        doNotOptimize(indices.data());
+      }
+  );
+
+  // Texture decode and mip generation
+  uint32_t size = options.textureSize;
+  auto pixels = SyntheticData::generateImage(size, size);
+  auto png = SyntheticData::encodePng(pixels, size, size);
+  auto pngPath = directory / "texture.png";
+  writeFile(pngPath, png.data(), png.size());
+
+  uint64_t texels = uint64_t{size} * size;
+
+  benchmark.run("stbi_load", {texels, pixels.size()}, [&] {
+    int width, height, channels;
+    stbi_uc* decoded = stbi_load(
+        pngPath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha
+    );
+
+    if (!decoded) {
+      ABORT("Failed to decode {}", pngPath.string());
+    }
+
+    doNotOptimize(decoded);
+    stbi_image_free(decoded);
+  });
+
+  std::vector<uint8_t> mipPixels;
+
+  // Refilling level 0 reuses the capacity reserved by the previous iteration
+  benchmark.run("MipChain::generate", {texels, pixels.size()}, [&] {
+    mipPixels.assign(pixels.begin(), pixels.end());
+    doNotOptimize(engine::MipChain::generate(mipPixels, size, size));
+  });
+
+  // Per-frame math
+  engine::Camera camera(nullptr);
+  engine::CameraInput input;
+  input.movement = {0.5f, 0.0f, 1.0f};
+
+  benchmark.run("Camera::apply", {MATH_BATCH_SIZE, 0}, [&] {
+    for (uint32_t i = 0; i < MATH_BATCH_SIZE; ++i) {
+      input.cursor.x += 1.0f;
+      camera.apply(input, 1.0f / 60.0f);
+    }
+
+    doNotOptimize(camera.getViewMatrix());
+  });
+
+  VkExtent2D extent{1920, 1080};
+
+  benchmark.run("UniformBufferObject::create", {MATH_BATCH_SIZE, 0}, [&] {
+    glm::mat4 view = camera.getViewMatrix();
+
+    for (uint32_t i = 0; i < MATH_BATCH_SIZE; ++i) {
+      auto ubo = engine::UniformBufferObject::create(view, extent);
+      doNotOptimize(ubo);
+      view[3][0] += 0.001f;
+    }
+  });
+
+  // CPU occlusion culling, the mesh seen from above as the occluder of boxes
+  // below it. Triangles per millisecond are items per second / 1000.
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> occluderIndices;
+  positions.reserve(stream.size());
+  occluderIndices.reserve(stream.size());
+
+  for (const auto& vertex : stream) {
+    occluderIndices.push_back(static_cast<uint32_t>(positions.size()));
+    positions.push_back(vertex.pos);
+  }
+
+  std::vector<std::pair<glm::vec3, glm::vec3>> boxes;
+
+  size_t boxVertices = OCCLUSION_BOX_TRIANGLES * 3;
+
+  for (size_t first = 0; first < positions.size(); first += boxVertices) {
+    size_t last = std::min(first + boxVertices, positions.size());
+    glm::vec3 lower = positions[first];
+    glm::vec3 upper = positions[first];
+
+    for (size_t i = first; i < last; ++i) {
+      lower = glm::min(lower, positions[i]);
+      upper = glm::max(upper, positions[i]);
+    }
+
+    glm::vec3 below(0.0f, -0.5f, 0.0f);
+    boxes.emplace_back(lower + below, upper + below);
+  }
+
+  auto ubo = engine::UniformBufferObject::create(
+      glm::lookAt(
+          glm::vec3(0.0f, 2.0f, 0.5f),
+          glm::vec3(0.0f, 0.0f, 0.0f),
+          glm::vec3(0.0f, 1.0f, 0.0f)
+      ),
+      extent
+  );
+  glm::mat4 transform = ubo.proj * ubo.view * ubo.model;
+
+  checkSoftwareOcclusion(positions, occluderIndices, transform);
+
+  Workload occluders{
+      occluderIndices.size() / 3, positions.size() * sizeof(glm::vec3)};
+
+  auto renderOccluders = [&](engine::SoftwareOcclusion& occlusion) {
+    auto name = fmt::format(
+        "SoftwareOcclusion::renderOccluders {} x{}",
+        engine::SoftwareOcclusion::toString(occlusion.getInstructionSet()),
+        occlusion.getThreadCount()
+    );
+
+    benchmark.run(name, occluders, [&] {
+      occlusion.clear();
+      occlusion.renderOccluders(positions, occluderIndices, transform, false);
+    });
+  };
+
+  engine::SoftwareOcclusion occlusion(
+      engine::Config::SOFTWARE_OCCLUSION_WIDTH,
+      engine::Config::SOFTWARE_OCCLUSION_HEIGHT,
+      1
+  );
+  renderOccluders(occlusion);
+
+  // Also when the filter skipped rendering
+  occlusion.clear();
+  occlusion.renderOccluders(positions, occluderIndices, transform, false);
+
+  benchmark.run("SoftwareOcclusion::isVisible", {boxes.size(), 0}, [&] {
+    uint32_t visible = 0;
+
+    for (const auto& [lower, upper] : boxes) {
+      visible += occlusion.isVisible(lower, upper, transform) ? 1 : 0;
+    }
+
+    doNotOptimize(visible);
+  });
+
+  if (uint32_t threads = std::thread::hardware_concurrency(); threads > 1) {
+    engine::SoftwareOcclusion threadedOcclusion(
+        engine::Config::SOFTWARE_OCCLUSION_WIDTH,
+        engine::Config::SOFTWARE_OCCLUSION_HEIGHT,
+        threads
+    );
+    renderOccluders(threadedOcclusion);
+  }
+
+  if (!options.outputPath.empty()) {
+    benchmark.writeJson(
+        options.outputPath,
+        {
+            {"meshSize", std::to_string(options.meshSize)},
+            {"textureSize", std::to_string(options.textureSize)},
+        }
+    );
+  }
+
+  std::filesystem::remove_all(directory);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  spdlog::set_level(spdlog::level::info);
+
+  try {
+    auto options = parseOptions(argc, argv);
+
+    if (options.showHelp) {
+      printUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+
+    runBenchmarks(options);
+  } catch (const std::exception& e) {
+    SPDLOG_CRITICAL(e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,18 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+  mat4 model;
+  mat4 view;
+  mat4 proj;
+}
+ubo;
+
+layout(location = 0) in vec3 inPosition;
+
+// Computed the same way as in shader.vert, so the main pass can test for
+// EQUAL depth
+invariant gl_Position;
+
+void main() {
+  gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+}
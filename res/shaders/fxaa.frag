@@ -0,0 +1,64 @@
+#version 450
+
+layout(set = 0, binding = 1) uniform sampler2D sceneColor;
+
+layout(push_constant) uniform PostProcess {
+  // Part of the image covered by the scene, which may be larger than it
+  vec2 uvScale;
+  vec2 texelSize;
+}
+post;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+const float SPAN_MAX = 8.0;
+const float REDUCE_MUL = 1.0 / 8.0;
+const float REDUCE_MIN = 1.0 / 128.0;
+
+vec3 sampleScene(vec2 uv) {
+  // Never filter in texels outside of the scene
+  vec2 maxUv = post.uvScale - 0.5 * post.texelSize;
+  return texture(sceneColor, clamp(uv, 0.5 * post.texelSize, maxUv)).rgb;
+}
+
+float luma(vec3 color) { return dot(color, vec3(0.299, 0.587, 0.114)); }
+
+void main() {
+  vec2 uv = fragTexCoord * post.uvScale;
+  vec2 texel = post.texelSize;
+
+  vec3 colorM = sampleScene(uv);
+  float lumaM = luma(colorM);
+  float lumaNW = luma(sampleScene(uv + vec2(-1.0, -1.0) * texel));
+  float lumaNE = luma(sampleScene(uv + vec2(1.0, -1.0) * texel));
+  float lumaSW = luma(sampleScene(uv + vec2(-1.0, 1.0) * texel));
+  float lumaSE = luma(sampleScene(uv + vec2(1.0, 1.0) * texel));
+
+  float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+  float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+  // Blur along the edge, which runs perpendicular to the luma gradient
+  vec2 direction = vec2(
+      (lumaSW + lumaSE) - (lumaNW + lumaNE),
+      (lumaNW + lumaSW) - (lumaNE + lumaSE)
+  );
+
+  float directionReduce = max(
+      (lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * REDUCE_MUL, REDUCE_MIN
+  );
+  float inverseDirectionMin =
+      1.0 / (min(abs(direction.x), abs(direction.y)) + directionReduce);
+  direction =
+      clamp(direction * inverseDirectionMin, -SPAN_MAX, SPAN_MAX) * texel;
+
+  vec3 colorA = 0.5 * (sampleScene(uv + direction * (1.0 / 3.0 - 0.5)) +
+                       sampleScene(uv + direction * (2.0 / 3.0 - 0.5)));
+  vec3 colorB = 0.5 * colorA + 0.25 * (sampleScene(uv - 0.5 * direction) +
+                                       sampleScene(uv + 0.5 * direction));
+
+  // The wider blur crossed another edge, fall back to the narrow one
+  float lumaB = luma(colorB);
+  outColor = vec4(lumaB < lumaMin || lumaB > lumaMax ? colorA : colorB, 1.0);
+}
@@ -1,10 +1,16 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform Material { uint textureIndex; }
+material;
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
 
 layout(location = 0) out vec4 outColor;
 
-void main() { outColor = texture(texSampler, fragTexCoord); }
+void main() {
+  outColor = texture(textures[material.textureIndex], fragTexCoord);
+}
@@ -0,0 +1,51 @@
+#version 450
+
+layout(set = 0, binding = 1) uniform sampler2D sceneColor;
+
+layout(push_constant) uniform PostProcess {
+  // Part of the image covered by the scene, which may be larger than it
+  vec2 uvScale;
+  vec2 texelSize;
+}
+post;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+vec3 sampleScene(vec2 uv) {
+  // Never filter in texels outside of the scene
+  vec2 maxUv = post.uvScale - 0.5 * post.texelSize;
+  return texture(sceneColor, clamp(uv, 0.5 * post.texelSize, maxUv)).rgb;
+}
+
+// Catmull-Rom filter, which stays sharper than bilinear filtering when
+// stretching the scene. The 16 taps are folded into 9 bilinear samples.
+void main() {
+  vec2 position = fragTexCoord * post.uvScale / post.texelSize;
+  vec2 center = floor(position - 0.5) + 0.5;
+  vec2 f = position - center;
+
+  vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+  vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+  vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+  vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+  vec2 w12 = w1 + w2;
+  vec2 uv0 = (center - 1.0) * post.texelSize;
+  vec2 uv12 = (center + w2 / w12) * post.texelSize;
+  vec2 uv3 = (center + 2.0) * post.texelSize;
+
+  vec3 color = sampleScene(vec2(uv0.x, uv0.y)) * w0.x * w0.y +
+               sampleScene(vec2(uv12.x, uv0.y)) * w12.x * w0.y +
+               sampleScene(vec2(uv3.x, uv0.y)) * w3.x * w0.y +
+               sampleScene(vec2(uv0.x, uv12.y)) * w0.x * w12.y +
+               sampleScene(vec2(uv12.x, uv12.y)) * w12.x * w12.y +
+               sampleScene(vec2(uv3.x, uv12.y)) * w3.x * w12.y +
+               sampleScene(vec2(uv0.x, uv3.y)) * w0.x * w3.y +
+               sampleScene(vec2(uv12.x, uv3.y)) * w12.x * w3.y +
+               sampleScene(vec2(uv3.x, uv3.y)) * w3.x * w3.y;
+
+  // The negative lobes can overshoot below black
+  outColor = vec4(max(color, 0.0), 1.0);
+}
@@ -5,18 +5,44 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
+#include <optional>
 #include <set>
 #include <sstream>
+#include <thread>
+#include <utility>
 
-#include "BinaryLoader.hpp"
+#include "AntiAliasing.hpp"
+#include "Benchmark.hpp"
+#include "BindlessTextureTable.hpp"
 #include "Camera.hpp"
 #include "Config.hpp"
+#include "DeletionQueue.hpp"
+#include "DescriptorAllocator.hpp"
 #include "Device.hpp"
+#include "DynamicRendering.hpp"
+#include "DynamicResolution.hpp"
+#include "EmbeddedShaders.hpp"
+#include "FramePacing.hpp"
+#include "GpuProfiler.hpp"
 #include "Instance.hpp"
+#include "LaunchOptions.hpp"
+#include "MipChain.hpp"
 #include "ModelLoader.hpp"
+#include "OcclusionCulling.hpp"
 #include "PhysicalDevice.hpp"
+#include "PipelineCache.hpp"
+#include "PipelineKey.hpp"
+#include "PipelineLibrary.hpp"
+#include "Profiler.hpp"
 #include "QueueFamily.hpp"
+#include "RenderGraph.hpp"
+#include "ShaderHotReload.hpp"
+#include "Simulation.hpp"
+#include "SoftwareOcclusion.hpp"
+#include "Statistics.hpp"
 #include "Time.hpp"
+#include "TimelineSemaphore.hpp"
+#include "UniformBufferObject.hpp"
 #include "Utils.hpp"
 #include "ValidationLayer.hpp"
 #include "Vertex.hpp"
@@ -30,6 +56,10 @@ using namespace engine;
 
 constexpr char MODEL_PATH[] = "res/models/viking_room.obj";
 constexpr char TEXTURE_PATH[] = "res/textures/viking_room.png";
+constexpr char VERT_SHADER_PATH[] = "res/shaders/shader.vert";
+constexpr char FRAG_SHADER_PATH[] = "res/shaders/shader.frag";
+constexpr char SHADER_CACHE_DIR[] = ".shader-cache";
+constexpr char CPU_TRACE_PATH[] = "cpu-trace.json";
 
 struct SwapChainSupportDetails {
   VkSurfaceCapabilitiesKHR capabilities{};
@@ -37,16 +67,71 @@ struct SwapChainSupportDetails {
   std::vector<VkPresentModeKHR> presentModes{};
 };
 
-struct UniformBufferObject {
-  glm::mat4 model;
-  glm::mat4 view;
-  glm::mat4 proj;
+struct MaterialPushConstants {
+  uint32_t textureIndex;
+};
+
+struct PostProcessPushConstants {
+  glm::vec2 uvScale;
+  glm::vec2 texelSize;
+};
+
+/**
+ * Memory held by the render attachments
+ */
+struct AttachmentMemory {
+  VkDeviceSize size = 0;
+  /**
+   * Bytes actually backed, less than size while lazily allocated memory is
+   * not fully committed
+   */
+  VkDeviceSize committed = 0;
+  std::string summary;
+};
+
+/**
+ * Source data of the per frame descriptor set, laid out for
+ * vkUpdateDescriptorSetWithTemplate
+ */
+struct FrameDescriptors {
+  VkDescriptorBufferInfo uniformBuffer;
+  VkDescriptorImageInfo sceneColor;
 };
 
 class Application {
  public:
+  explicit Application(LaunchOptions options)
+      : m_headless(options.headless),
+        m_frameLimit(options.frameCount),
+        m_framePacing(std::move(options.framePacing)),
+        m_antiAliasing(options.antiAliasing),
+        m_targetFrameTime(options.targetFrameTime),
+        m_renderScaling(
+            options.renderScale < 1.0f || options.dynamicResolution
+        ),
+        m_renderScale(options.renderScale),
+        m_depthPrepass(options.depthPrepass || options.occlusionCulling),
+        m_occlusionCulling(options.occlusionCulling),
+        m_cpuOcclusion(options.cpuOcclusion),
+        m_asyncCompute(options.asyncCompute) {
+    if (options.benchmark) {
+      m_benchmark = std::make_unique<Benchmark>(std::move(*options.benchmark));
+      m_frameLimit = m_benchmark->getTotalFrames();
+    }
+
+    // Benchmarks have to measure the same work on every run
+    if (options.dynamicResolution && !m_benchmark) {
+      m_dynamicResolution = std::make_unique<DynamicResolution>(
+          m_targetFrameTime, Config::MIN_RENDER_SCALE, m_renderScale
+      );
+    }
+  }
+
   void run() {
-    initWindow();
+    if (!m_headless) {
+      initWindow();
+    }
+
     initVulkan();
     initCamera();
     mainLoop();
@@ -60,7 +145,19 @@ class Application {
   VkPhysicalDevice m_physicalDevice;
   std::unique_ptr<Device> m_device;
   VkQueue m_graphicsQueue;
+  std::unique_ptr<TimelineSemaphore> m_graphicsTimeline;
   VkQueue m_presentQueue;
+  /**
+   * Queue of a family without graphics that async compute passes run on,
+   * only created with m_asyncCompute
+   */
+  VkQueue m_computeQueue = VK_NULL_HANDLE;
+  std::unique_ptr<TimelineSemaphore> m_computeTimeline;
+  /**
+   * Graphics and compute family when both queues use buffers, empty with a
+   * single queue
+   */
+  std::vector<uint32_t> m_sharedQueueFamilies;
 
   std::unique_ptr<SwapChain> m_swapChain;
   std::vector<VkImage> m_swapChainImages;
@@ -69,31 +166,90 @@ class Application {
   VkFormat m_swapChainImageFormat;
   VkExtent2D m_swapChainExtent;
 
-  VkSurfaceKHR m_surface;
+  VkSurfaceKHR m_surface = VK_NULL_HANDLE;
+
+  /**
+   * Renders into offscreen images instead of a window. There is no surface
+   * and no swap chain, m_swapChainImages holds the offscreen images.
+   */
+  bool m_headless;
+  uint64_t m_frameLimit;
+  std::vector<std::unique_ptr<Image>> m_offscreenImages;
+  std::vector<std::unique_ptr<DeviceMemory>> m_offscreenImagesMemory;
 
   std::unique_ptr<RenderPass> m_renderPass;
-  std::unique_ptr<DescriptorPool> m_descriptorPool;
-  std::vector<VkDescriptorSet> m_descriptorSets;
+  /**
+   * Replaces m_renderPass and the framebuffers on devices supporting dynamic
+   * rendering
+   */
+  std::unique_ptr<DynamicRendering> m_dynamicRendering;
+  std::vector<std::unique_ptr<DescriptorAllocator>> m_frameDescriptorAllocators;
+  std::vector<VkDescriptorSet> m_frameDescriptorSets;
   std::unique_ptr<DescriptorSetLayout> m_descriptorSetLayout;
+  std::unique_ptr<DescriptorUpdateTemplate> m_descriptorUpdateTemplate;
+  std::unique_ptr<BindlessTextureTable> m_textureTable;
+  uint32_t m_textureIndex = 0;
   std::unique_ptr<PipelineLayout> m_pipelineLayout;
-  std::unique_ptr<GraphicsPipeline> m_graphicsPipeline;
+  std::unique_ptr<ShaderModule> m_vertShaderModule;
+  std::unique_ptr<ShaderModule> m_fragShaderModule;
+  std::unique_ptr<PipelineCache> m_pipelineCache;
+  PipelineKey m_pipelineKey;
+  std::unique_ptr<ShaderHotReload> m_shaderHotReload;
 
   std::vector<FrameBuffer> m_swapChainFrameBuffers;
   std::unique_ptr<CommandPool> m_commandPool;
-  std::vector<VkCommandBuffer> m_commandBuffers;
+  std::unique_ptr<CommandPool> m_computeCommandPool;
+  std::unique_ptr<GpuProfiler> m_gpuProfiler;
+  std::unique_ptr<Benchmark> m_benchmark;
+  /**
+   * A command buffer per batch of the frame graph for every frame in flight,
+   * from the pool of the batch's queue
+   */
+  std::vector<std::vector<VkCommandBuffer>> m_commandBuffers;
 
   std::vector<Semaphore> m_imageAvailableSemaphores;
   std::vector<Semaphore> m_renderFinishedSemaphores;
-  std::vector<Fence> m_inFlightFences;
+  /**
+   * Graphics timeline value of the last submission of each frame in flight
+   */
+  std::vector<uint64_t> m_frameTimelineValues;
+  /**
+   * Compute timeline value of the last compute submission of each frame in
+   * flight, which no graphics submission has to wait for
+   */
+  std::vector<uint64_t> m_frameComputeTimelineValues;
+  /**
+   * Timeline value each batch of the frame graph was last submitted with, on
+   * its queue's timeline. Empty until the graph is first executed.
+   */
+  std::vector<uint64_t> m_batchTimelineValues;
 
   bool m_framebufferResized = false;
+  /**
+   * Set by F12, the trace is written between frames
+   */
+  bool m_traceRequested = false;
+
+  FramePacing m_framePacing;
+  std::optional<FramePacing> m_pendingFramePacing;
 
   uint32_t m_currentFrame = 0;
 
+  /**
+   * Resources replaced at runtime, destroyed once the graphics submissions
+   * made before the replacement finished
+   */
+  DeletionQueue m_deletionQueue;
+
   std::vector<Vertex> m_vertices;
   std::vector<uint32_t> m_indices;
   std::unique_ptr<Buffer> m_vertexBuffer;
   std::unique_ptr<DeviceMemory> m_vertexBufferMemory;
+  /**
+   * VertexPosition of every vertex, for passes that only need positions
+   */
+  std::unique_ptr<Buffer> m_positionBuffer;
+  std::unique_ptr<DeviceMemory> m_positionBufferMemory;
 
   std::unique_ptr<Buffer> m_indexBuffer;
   std::unique_ptr<DeviceMemory> m_indexBufferMemory;
@@ -109,17 +265,169 @@ class Application {
   std::unique_ptr<ImageView> m_textureImageView;
   std::unique_ptr<Sampler> m_textureSampler;
 
-  std::unique_ptr<Image> m_depthImage;
-  std::unique_ptr<DeviceMemory> m_depthImageMemory;
-  std::unique_ptr<ImageView> m_depthImageView;
-
   std::unique_ptr<Camera> m_camera;
+  /**
+   * Steps the camera while the main loop runs, except in benchmark mode
+   * where the camera follows the scripted path frame by frame
+   */
+  std::unique_ptr<Simulation> m_simulation;
+  /**
+   * Camera the current frame is rendered with
+   */
+  CameraState m_cameraState;
+  bool m_cameraActive = false;
+  /**
+   * Input the current frame's camera was latched from, unset while the
+   * camera is not driven by input
+   */
+  std::optional<SimulationInput> m_latchedInput;
+  /**
+   * Milliseconds from reading input to the return of vkQueuePresentKHR for
+   * the frame showing it, for the latched mouse look and for input that went
+   * through the simulation. This is the CPU side only, when the frame reaches
+   * the display is not measured.
+   */
+  RollingStatistics m_latchedInputAge;
+  RollingStatistics m_simulatedInputAge;
 
   VkSampleCountFlagBits m_msaaSamples = VK_SAMPLE_COUNT_1_BIT;
-
-  std::unique_ptr<Image> m_colorImage;
-  std::unique_ptr<DeviceMemory> m_colorImageMemory;
-  std::unique_ptr<ImageView> m_colorImageView;
+  /**
+   * Current tier, m_msaaSamples follows it
+   */
+  AntiAliasingMode m_antiAliasing;
+  std::vector<AntiAliasingMode> m_supportedAntiAliasing;
+  std::optional<AntiAliasingMode> m_pendingAntiAliasing;
+  double m_targetFrameTime;
+  /**
+   * Adapts the tier to m_targetFrameTime, unset when the tier is fixed
+   */
+  std::unique_ptr<AntiAliasingGovernor> m_antiAliasingGovernor;
+
+  bool m_pipelineLibrarySupported = false;
+  bool m_dynamicRenderingSupported = false;
+  bool m_synchronization2Supported = false;
+
+  /**
+   * Passes of a frame and the attachments between them. The graph owns the
+   * attachments, so it is rebuilt whenever they change.
+   */
+  std::unique_ptr<RenderGraph> m_frameGraph;
+  /**
+   * Swap chain image the frame ends up in, set before every execution
+   */
+  RenderGraph::ImageHandle m_frameTarget = 0;
+  RenderGraph::ImageHandle m_depthAttachment = 0;
+  /**
+   * Uniform buffer of the frame being recorded, set before every execution
+   */
+  RenderGraph::BufferHandle m_frameUniforms = 0;
+  /**
+   * Multisampled color, only exists with MSAA
+   */
+  RenderGraph::ImageHandle m_colorAttachment = 0;
+  /**
+   * Resolved scene the post pass reads, only exists while there is one
+   */
+  RenderGraph::ImageHandle m_sceneColor = 0;
+  std::unique_ptr<Sampler> m_sceneColorSampler;
+  /**
+   * Swap chain image of the frame being recorded
+   */
+  uint32_t m_imageIndex = 0;
+
+  std::unique_ptr<RenderPass> m_postRenderPass;
+  std::vector<FrameBuffer> m_postFrameBuffers;
+  std::unique_ptr<PipelineLayout> m_postPipelineLayout;
+  std::unique_ptr<ShaderModule> m_fullscreenVertShaderModule;
+  std::unique_ptr<ShaderModule> m_fxaaFragShaderModule;
+  std::unique_ptr<ShaderModule> m_upscaleFragShaderModule;
+  PipelineKey m_postPipelineKey;
+
+  /**
+   * Size of the color and depth attachments, the swap chain extent rounded up
+   * to Config::ATTACHMENT_SIZE_GRANULARITY so small resizes keep them
+   */
+  VkExtent2D m_attachmentExtent{};
+
+  /**
+   * The scene covers m_renderExtent, m_renderScale of the swap chain extent,
+   * and the post pass stretches it over the whole swap chain image. Without
+   * m_renderScaling both always match the swap chain.
+   */
+  bool m_renderScaling;
+  float m_renderScale;
+  VkExtent2D m_renderExtent{};
+  /**
+   * Adapts m_renderScale to m_targetFrameTime, unset for a fixed scale
+   */
+  std::unique_ptr<DynamicResolution> m_dynamicResolution;
+
+  /**
+   * Whether depth is laid down by a position-only pass before the main pass,
+   * which then only shades fragments with EQUAL depth and writes none
+   */
+  bool m_depthPrepass;
+  std::unique_ptr<RenderPass> m_depthRenderPass;
+  /**
+   * Same as m_depthRenderPass, but loads the depth the pre-pass left
+   */
+  std::unique_ptr<RenderPass> m_depthLoadRenderPass;
+  std::unique_ptr<FrameBuffer> m_depthFrameBuffer;
+  std::unique_ptr<ShaderModule> m_depthVertShaderModule;
+  PipelineKey m_depthPipelineKey;
+
+  /**
+   * Whether the mesh is drawn in chunks that OcclusionCulling tests against
+   * a depth pyramid of the pre-pass, which is always on with it
+   */
+  bool m_occlusionCulling;
+  /**
+   * Whether the depth pyramid and the culling run on m_computeQueue
+   */
+  bool m_asyncCompute;
+  std::unique_ptr<OcclusionCulling> m_culling;
+  OcclusionCulling::DrawLists m_drawLists;
+  std::unique_ptr<Buffer> m_chunkBoundsBuffer;
+  std::unique_ptr<DeviceMemory> m_chunkBoundsBufferMemory;
+  /**
+   * Chunks to draw, rewritten by the culling every frame. With async compute
+   * the early culling of a frame runs while earlier frames still draw, so
+   * every frame in flight has its own list
+   */
+  std::vector<std::unique_ptr<Buffer>> m_visibleDrawBuffers;
+  std::vector<std::unique_ptr<DeviceMemory>> m_visibleDrawBuffersMemory;
+  std::unique_ptr<Buffer> m_disoccludedDrawBuffer;
+  std::unique_ptr<DeviceMemory> m_disoccludedDrawBufferMemory;
+  RenderGraph::BufferHandle m_visibleDraws = 0;
+  RenderGraph::BufferHandle m_disoccludedDraws = 0;
+  /**
+   * Built from the pre-pass for the culling of the same frame, and with
+   * async compute for the early culling of the next one as well
+   */
+  RenderGraph::ImageHandle m_depthPyramid = 0;
+  uint32_t m_depthPyramidLevels = 0;
+  /**
+   * Extent of the depth the pyramid was last built from
+   */
+  VkExtent2D m_depthPyramidExtent{};
+  /**
+   * Camera of the last frame submitted, the one the early culling of the
+   * next frame finds its chunks in the pyramid with
+   */
+  glm::mat4 m_previousViewProjection{1.0f};
+
+  /**
+   * Whether the same chunks are tested on the CPU instead, against the mesh
+   * rasterized by SoftwareOcclusion before the frame is recorded
+   */
+  bool m_cpuOcclusion;
+  std::unique_ptr<SoftwareOcclusion> m_softwareOcclusion;
+  std::vector<glm::vec3> m_occluderPositions;
+  OcclusionCulling::Chunks m_chunks;
+  /**
+   * Draws of the chunks left by the CPU, consecutive ones merged
+   */
+  std::vector<VkDrawIndexedIndirectCommand> m_visibleChunks;
 
   void initWindow() {
     m_window = std::make_unique<Window>(
@@ -129,54 +437,257 @@ class Application {
     glfwSetWindowUserPointer(*m_window, this);
     glfwSetFramebufferSizeCallback(*m_window, framebufferResizeCallback);
     glfwSetMouseButtonCallback(*m_window, mouseCallback);
+    glfwSetKeyCallback(*m_window, keyCallback);
   }
 
   void initVulkan() {
+    PROFILE_FUNCTION();
+
     createInstance();
     setupDebugMessenger();
-    createSurface();
+
+    if (!m_headless) {
+      createSurface();
+    }
+
     pickPhysicalDevice();
     createLogicalDevice();
-    createSwapChain();
+
+    if (m_headless) {
+      createOffscreenImages();
+    } else {
+      createSwapChain();
+    }
+
     createImageViews();
     createRenderPass();
     createDescriptorSetLayout();
+    createPostPipeline();
     createGraphicsPipeline();
-    createColorResources();
-    createDepthResources();
+    m_attachmentExtent = getAttachmentExtent(m_swapChainExtent);
+    createFrameGraph();
     createFrameBuffers();
     createCommandPool();
+    createGpuProfiler();
     createTextureImage();
     createTextureImageView();
     createTextureSampler();
     loadModel();
     createVertexBuffer();
+    createPositionBuffer();
     createIndexBuffer();
+    createOcclusionCulling();
+    createSoftwareOcclusion();
     createUniformBuffers();
-    createDescriptorPool();
+    createDescriptorAllocators();
     createDescriptorSets();
     createCommandBuffers();
     createSyncObjects();
+    createShaderHotReload();
   }
 
-  void initCamera() { m_camera = std::make_unique<Camera>(*m_window); }
+  void initCamera() {
+    GLFWwindow* window = nullptr;
+
+    if (m_window) {
+      window = *m_window;
+    }
+
+    m_camera = std::make_unique<Camera>(window);
+    m_cameraState = m_camera->getState();
+
+    if (!m_benchmark) {
+      m_simulation =
+          std::make_unique<Simulation>(*m_camera, Config::SIMULATION_TICK_RATE);
+    }
+  }
 
   void mainLoop() {
-    Time time;
+    uint64_t frameCount = 0;
+
+    while (shouldRun(frameCount)) {
+      PROFILE_SCOPE("frame");
+
+      if (m_window) {
+        m_window->pollEvents();
+      }
+
+      if (m_traceRequested) {
+        m_traceRequested = false;
+        Profiler::writeChromeTrace(CPU_TRACE_PATH);
+      }
+
+      if (m_benchmark) {
+        beginBenchmarkFrame(frameCount);
+      }
 
-    while (m_window->isOpen()) {
-      m_window->pollEvents();
       drawFrame();
-      m_camera->update(time.deltaTime());
-      m_currentFrame = (m_currentFrame + 1) % Config::MAX_FRAMES_IN_FLIGHT;
+
+      if (m_benchmark) {
+        m_benchmark->endFrame();
+      }
+
+      m_currentFrame = (m_currentFrame + 1) % m_framePacing.framesInFlight;
+      frameCount++;
     }
 
+    m_simulation.reset();
     vkDeviceWaitIdle(*m_device);
+
+    logAttachmentMemory();
+
+    if (m_benchmark) {
+      writeBenchmarkReport();
+    }
+
+    if (m_headless) {
+      SPDLOG_INFO("Rendered {} headless frames", frameCount);
+    }
+
+    logInputAge("latched", m_latchedInputAge);
+    logInputAge("simulated", m_simulatedInputAge);
+  }
+
+  void beginBenchmarkFrame(uint64_t frame) {
+    if (m_benchmark->beginFrame(frame)) {
+      // Drop GPU timings of the warmup, including frames still in flight
+      vkDeviceWaitIdle(*m_device);
+      m_gpuProfiler->flush();
+      m_gpuProfiler->resetStatistics();
+    }
+
+    const auto& settings = m_benchmark->getSettings();
+    auto keyframe = m_benchmark->getCameraPath().sample(
+        static_cast<float>(frame) * settings.timestep
+    );
+    m_camera->lookAt(keyframe.position, keyframe.target);
+    m_cameraState = m_camera->getState();
+  }
+
+  /**
+   * Reads input, hands it to the simulation thread and picks up the camera to
+   * render with. Called right before submitting, so the frame shows the
+   * freshest input possible.
+   */
+  void latchCamera() {
+    PROFILE_FUNCTION();
+
+    m_latchedInput.reset();
+
+    if (!m_simulation) {
+      return;
+    }
+
+    // The callbacks only note what happened and the main loop acts on it
+    // between frames, so events can be dispatched in the middle of one. The
+    // cursor and keys read below then include what arrived while the frame
+    // was recorded.
+    if (m_window) {
+      m_window->pollEvents();
+    }
+
+    SimulationInput input;
+    input.cameraActive = m_cameraActive;
+
+    if (m_cameraActive) {
+      input.camera = m_camera->readInput();
+    }
+
+    input.time = Simulation::Clock::now();
+    m_simulation->setInput(input);
+    m_cameraState = m_simulation->sampleCamera(input);
+
+    if (input.cameraActive) {
+      m_latchedInput = input;
+    }
+  }
+
+  void recordInputAge() {
+    if (!m_latchedInput) {
+      return;
+    }
+
+    auto now = Simulation::Clock::now();
+    auto milliseconds = [now](Simulation::Clock::time_point time) {
+      return std::chrono::duration<double, std::milli>(now - time).count();
+    };
+
+    m_latchedInputAge.add(milliseconds(m_latchedInput->time));
+
+    const auto& simulatedInput = m_simulation->getSampledInput();
+
+    if (simulatedInput.cameraActive) {
+      m_simulatedInputAge.add(milliseconds(simulatedInput.time));
+    }
+  }
+
+  static void logInputAge(
+      const char* name, const RollingStatistics& statistics
+  ) {
+    if (statistics.count() == 0) {
+      return;
+    }
+
+    SPDLOG_INFO(
+        "Input age at present call {}: min {:.3f}ms, avg {:.3f}ms, "
+        "p99 {:.3f}ms ({} samples)",
+        name,
+        statistics.min(),
+        statistics.average(),
+        statistics.percentile(99.0),
+        statistics.count()
+    );
+  }
+
+  void writeBenchmarkReport() {
+    m_gpuProfiler->flush();
+
+    const auto& gpuStatistics = m_gpuProfiler->getStatistics();
+    auto gpuFrameTime = gpuStatistics.find("frame");
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+    AttachmentMemory attachmentMemory = getAttachmentMemory();
+
+    m_benchmark->writeReport(
+        gpuFrameTime != gpuStatistics.end() ? &gpuFrameTime->second : nullptr,
+        {
+            {"device", properties.deviceName},
+            {"headless", m_headless ? "true" : "false"},
+            {"framePacing", FramePacing::toString(m_framePacing.policy)},
+            {"resolution",
+             fmt::format(
+                 "{}x{}", m_swapChainExtent.width, m_swapChainExtent.height
+             )},
+            {"antiAliasing", AntiAliasing::toString(m_antiAliasing)},
+            {"renderScale", fmt::format("{:.3f}", m_renderScale)},
+            {"depthPrepass", m_depthPrepass ? "true" : "false"},
+            {"occlusionCulling", m_occlusionCulling ? "true" : "false"},
+            {"cpuOcclusion", m_cpuOcclusion ? "true" : "false"},
+            {"asyncCompute", m_asyncCompute ? "true" : "false"},
+            {"attachmentMemory", std::to_string(attachmentMemory.size)},
+            {"attachmentMemoryCommitted",
+             std::to_string(attachmentMemory.committed)},
+        }
+    );
+  }
+
+  [[nodiscard]] bool shouldRun(uint64_t frameCount) const {
+    if (m_frameLimit > 0 && frameCount >= m_frameLimit) {
+      return false;
+    }
+
+    return m_headless || m_window->isOpen();
   }
 
   void cleanup() {
+    m_shaderHotReload.reset();
+    m_deletionQueue.flush();
+
     cleanupSwapChain();
 
+    m_sceneColorSampler.reset();
     m_textureSampler.reset();
     m_textureImageView.reset();
 
@@ -186,25 +697,51 @@ class Application {
     m_uniformBuffers.clear();
     m_uniformBuffersMemory.clear();
 
-    m_descriptorPool.reset();
+    m_descriptorUpdateTemplate.reset();
+    m_frameDescriptorAllocators.clear();
+    m_textureTable.reset();
     m_descriptorSetLayout.reset();
 
-    m_descriptorSetLayout.reset();
-
-    m_graphicsPipeline.reset();
+    m_pipelineCache.reset();
+    m_upscaleFragShaderModule.reset();
+    m_fxaaFragShaderModule.reset();
+    m_fullscreenVertShaderModule.reset();
+    m_postPipelineLayout.reset();
+    m_depthVertShaderModule.reset();
+    m_fragShaderModule.reset();
+    m_vertShaderModule.reset();
     m_pipelineLayout.reset();
+    m_postRenderPass.reset();
+    m_depthLoadRenderPass.reset();
+    m_depthRenderPass.reset();
     m_renderPass.reset();
+    m_dynamicRendering.reset();
+
+    m_softwareOcclusion.reset();
+    m_culling.reset();
+    m_disoccludedDrawBuffer.reset();
+    m_disoccludedDrawBufferMemory.reset();
+    m_visibleDrawBuffers.clear();
+    m_visibleDrawBuffersMemory.clear();
+    m_chunkBoundsBuffer.reset();
+    m_chunkBoundsBufferMemory.reset();
 
     m_indexBuffer.reset();
     m_indexBufferMemory.reset();
 
+    m_positionBuffer.reset();
+    m_positionBufferMemory.reset();
+
     m_vertexBuffer.reset();
     m_vertexBufferMemory.reset();
 
     m_renderFinishedSemaphores.clear();
     m_imageAvailableSemaphores.clear();
-    m_inFlightFences.clear();
+    m_graphicsTimeline.reset();
+    m_computeTimeline.reset();
 
+    m_gpuProfiler.reset();
+    m_computeCommandPool.reset();
     m_commandPool.reset();
 
     m_device.reset();
@@ -228,13 +765,20 @@ class Application {
     appInfo.applicationVersion = Config::APP_VERSION;
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_API_VERSION(0, 1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = Config::VULKAN_API_VERSION;
 
     VkInstanceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     createInfo.pApplicationInfo = &appInfo;
 
-    auto extensions = Window::getRequiredExtensions();
+    std::vector<const char*> extensions;
+
+    if (!m_headless) {
+      extensions = Window::getRequiredExtensions();
+    } else if (Config::IS_VALIDATION_LAYERS_ENABLED) {
+      extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
+
     createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     createInfo.ppEnabledExtensionNames = extensions.data();
 
@@ -272,7 +816,13 @@ class Application {
     for (const auto& device : devices) {
       if (isDeviceSuitable(device, m_surface)) {
         m_physicalDevice = device;
-        m_msaaSamples = getMaxUsableSampleCount();
+        m_pipelineLibrarySupported = Config::IS_PIPELINE_LIBRARY_ENABLED &&
+                                     PipelineLibrary::isSupported(device);
+        m_dynamicRenderingSupported = Config::IS_DYNAMIC_RENDERING_ENABLED &&
+                                      DynamicRendering::isSupported(device);
+        m_synchronization2Supported =
+            Config::IS_SYNCHRONIZATION2_ENABLED &&
+            RenderGraph::isSynchronization2Supported(device);
         break;
       }
     }
@@ -281,11 +831,85 @@ class Application {
       ABORT("Failed to find a suitable GPU");
     }
 
-    SPDLOG_DEBUG("Using MSAAx{}", static_cast<uint8_t>(m_msaaSamples));
+    chooseAntiAliasing();
+
+    if (m_occlusionCulling &&
+        !OcclusionCulling::isSupported(m_physicalDevice)) {
+      SPDLOG_WARN("Occlusion culling needs multiDrawIndirect, disabling it");
+      m_occlusionCulling = false;
+    }
+
+    if (m_occlusionCulling && m_cpuOcclusion) {
+      SPDLOG_WARN("Culling on the GPU, ignoring --cpu-occlusion");
+      m_cpuOcclusion = false;
+    }
+
+    if (m_asyncCompute && !m_occlusionCulling) {
+      SPDLOG_WARN("No culling passes to run async, ignoring --async-compute");
+      m_asyncCompute = false;
+    }
+
+    if (m_asyncCompute &&
+        !QueueFamily::findSuitableQueueFamilies(m_physicalDevice, m_surface)
+             .computeFamily) {
+      SPDLOG_WARN("No separate compute queue, culling on the graphics queue");
+      m_asyncCompute = false;
+    }
+
+    SPDLOG_DEBUG(
+        "Using anti-aliasing {}", AntiAliasing::toString(m_antiAliasing)
+    );
+    SPDLOG_DEBUG(
+        "Graphics pipeline library {}",
+        m_pipelineLibrarySupported ? "enabled" : "not available"
+    );
+    SPDLOG_DEBUG(
+        "Dynamic rendering {}",
+        m_dynamicRenderingSupported ? "enabled" : "not available"
+    );
+    SPDLOG_DEBUG(
+        "Synchronization2 {}",
+        m_synchronization2Supported ? "enabled" : "not available"
+    );
 
     Utils::printPhysicalDeviceInfo(m_physicalDevice);
   }
 
+  /**
+   * Settles on the requested tier, or on the most expensive supported one
+   * below it
+   */
+  void chooseAntiAliasing() {
+    m_supportedAntiAliasing =
+        AntiAliasing::getSupportedModes(getUsableSampleCounts());
+
+    AntiAliasingMode requested = m_antiAliasing;
+
+    for (auto mode : m_supportedAntiAliasing) {
+      if (mode <= requested) {
+        m_antiAliasing = mode;
+      }
+    }
+
+    if (m_antiAliasing != requested) {
+      SPDLOG_WARN(
+          "Anti-aliasing {} is not supported, falling back to {}",
+          AntiAliasing::toString(requested),
+          AntiAliasing::toString(m_antiAliasing)
+      );
+    }
+
+    m_msaaSamples = AntiAliasing::getSampleCount(m_antiAliasing);
+
+    // Dynamic resolution holds the frame time on its own, two controllers
+    // chasing the same target would fight
+    if (m_targetFrameTime > 0.0 && !m_benchmark && !m_dynamicResolution) {
+      m_antiAliasingGovernor = std::make_unique<AntiAliasingGovernor>(
+          m_supportedAntiAliasing, m_antiAliasing, m_targetFrameTime
+      );
+    }
+  }
+
   static VkSurfaceFormatKHR chooseSwapSurfaceFormat(
       const std::vector<VkSurfaceFormatKHR>& availableFormats
   ) {
@@ -299,18 +923,6 @@ class Application {
     return availableFormats.front();
   }
 
-  static VkPresentModeKHR chooseSwapPresentMode(
-      const std::vector<VkPresentModeKHR>& availablePresentModes
-  ) {
-    for (const auto& availablePresentMode : availablePresentModes) {
-      if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-        return availablePresentMode;
-      }
-    }
-
-    return VK_PRESENT_MODE_FIFO_KHR;
-  }
-
   VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) {
     if (capabilities.currentExtent.width !=
         std::numeric_limits<uint32_t>::max()) {
@@ -348,6 +960,10 @@ class Application {
         familyIndices.graphicsFamily.value(),
         familyIndices.presentFamily.value()};
 
+    if (m_asyncCompute) {
+      uniqueQueueFamilies.insert(familyIndices.computeFamily.value());
+    }
+
     float queuePriority = 1.0f;
 
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -359,25 +975,78 @@ class Application {
       queueCreateInfos.emplace_back(queueCreateInfo);
     }
 
-    VkPhysicalDeviceFeatures deviceFeatures{};
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+    vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+    vulkan12Features.descriptorBindingVariableDescriptorCount = VK_TRUE;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    vulkan12Features.hostQueryReset = VK_TRUE;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures{};
+    deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures.pNext = &vulkan12Features;
+    deviceFeatures.features.samplerAnisotropy = VK_TRUE;
+    deviceFeatures.features.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+    deviceFeatures.features.multiDrawIndirect =
+        m_occlusionCulling ? VK_TRUE : VK_FALSE;
+
+    std::vector<const char*> extensions;
+
+    if (!m_headless) {
+      extensions.assign(
+          Config::DEVICE_EXTENSIONS.begin(), Config::DEVICE_EXTENSIONS.end()
+      );
+    }
 
-    VkDeviceCreateInfo deviceCreateInfo{};
-    deviceFeatures.samplerAnisotropy = VK_TRUE;
-    deviceFeatures.sampleRateShading = VK_TRUE;
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT libraryFeatures{};
+    libraryFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
 
+    if (m_pipelineLibrarySupported) {
+      libraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+      vulkan12Features.pNext = &libraryFeatures;
+      extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+      extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    if (m_dynamicRenderingSupported) {
+      dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+      dynamicRenderingFeatures.pNext = vulkan12Features.pNext;
+      vulkan12Features.pNext = &dynamicRenderingFeatures;
+      extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    }
+
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+    synchronization2Features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+
+    if (m_synchronization2Supported) {
+      synchronization2Features.synchronization2 = VK_TRUE;
+      synchronization2Features.pNext = vulkan12Features.pNext;
+      vulkan12Features.pNext = &synchronization2Features;
+      extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    }
+
+    VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext = &deviceFeatures;
 
     deviceCreateInfo.queueCreateInfoCount =
         static_cast<uint32_t>(queueCreateInfos.size());
 
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 
-    deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-
     deviceCreateInfo.enabledExtensionCount =
-        static_cast<uint32_t>(Config::DEVICE_EXTENSIONS.size());
+        static_cast<uint32_t>(extensions.size());
 
-    deviceCreateInfo.ppEnabledExtensionNames = Config::DEVICE_EXTENSIONS.data();
+    deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
 
     const auto& layers = Config::VALIDATION_LAYERS;
 
@@ -390,6 +1059,22 @@ class Application {
 
     m_graphicsQueue = m_device->getQueue(familyIndices.graphicsFamily.value());
     m_presentQueue = m_device->getQueue(familyIndices.presentFamily.value());
+
+    m_graphicsTimeline =
+        std::make_unique<TimelineSemaphore>(*m_device, m_graphicsQueue);
+
+    if (m_asyncCompute) {
+      m_computeQueue = m_device->getQueue(familyIndices.computeFamily.value());
+      m_computeTimeline =
+          std::make_unique<TimelineSemaphore>(*m_device, m_computeQueue);
+      m_sharedQueueFamilies = {
+          familyIndices.graphicsFamily.value(),
+          familyIndices.computeFamily.value()};
+    }
+
+    if (m_dynamicRenderingSupported) {
+      m_dynamicRendering = std::make_unique<DynamicRendering>(*m_device);
+    }
   }
 
   static SwapChainSupportDetails querySwapChainSupport(
@@ -425,15 +1110,20 @@ class Application {
     return requiredExtensions.empty();
   }
 
+  /**
+   * @param surface VK_NULL_HANDLE when rendering headless, which needs neither
+   * presentation nor the swap chain extension
+   */
   static bool isDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface) {
     QueueFamilyIndices indices =
         QueueFamily::findSuitableQueueFamilies(device, surface);
 
-    bool extensionsSupported = checkDeviceExtensionSupport(device);
+    bool headless = surface == VK_NULL_HANDLE;
+    bool extensionsSupported = headless || checkDeviceExtensionSupport(device);
 
-    bool swapChainAdequate;
+    bool swapChainAdequate = headless;
 
-    if (extensionsSupported) {
+    if (extensionsSupported && !headless) {
       SwapChainSupportDetails swapChainSupport =
           querySwapChainSupport(device, surface);
 
@@ -441,14 +1131,36 @@ class Application {
                           !swapChainSupport.presentModes.empty();
     }
 
-    VkPhysicalDeviceFeatures supportedFeatures;
-    vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    if (properties.apiVersion < Config::VULKAN_API_VERSION) {
+      return false;
+    }
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
+
+    bool bindlessSupported =
+        supportedFeatures.features.shaderSampledImageArrayDynamicIndexing &&
+        vulkan12Features.runtimeDescriptorArray &&
+        vulkan12Features.descriptorBindingPartiallyBound &&
+        vulkan12Features.descriptorBindingVariableDescriptorCount &&
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind;
 
     return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-           supportedFeatures.samplerAnisotropy;
+           supportedFeatures.features.samplerAnisotropy && bindlessSupported &&
+           vulkan12Features.hostQueryReset &&
+           vulkan12Features.timelineSemaphore;
   }
 
-  void createSwapChain() {
+  void createSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE) {
     SwapChainSupportDetails swapChainSupport =
         querySwapChainSupport(m_physicalDevice, m_surface);
 
@@ -456,16 +1168,12 @@ class Application {
         chooseSwapSurfaceFormat(swapChainSupport.formats);
 
     VkPresentModeKHR presentMode =
-        chooseSwapPresentMode(swapChainSupport.presentModes);
+        m_framePacing.choosePresentMode(swapChainSupport.presentModes);
 
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
-
-    if (swapChainSupport.capabilities.maxImageCount > 0 &&
-        imageCount > swapChainSupport.capabilities.maxImageCount) {
-      imageCount = swapChainSupport.capabilities.maxImageCount;
-    }
+    uint32_t imageCount =
+        m_framePacing.chooseImageCount(swapChainSupport.capabilities);
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -498,19 +1206,67 @@ class Application {
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
 
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    // Lets the presentation engine hand over images still being presented
+    createInfo.oldSwapchain = oldSwapChain;
 
     m_swapChain = std::make_unique<SwapChain>(*m_device, createInfo);
 
     m_swapChainImages =
         vkCall(vkGetSwapchainImagesKHR, *m_device, *m_swapChain);
 
-    SPDLOG_DEBUG("Got {} swap chain images", m_swapChainImages.size());
+    SPDLOG_INFO(
+        "Frame pacing {}: {} frames in flight, {} swap chain images, {}",
+        FramePacing::toString(m_framePacing.policy),
+        m_framePacing.framesInFlight,
+        m_swapChainImages.size(),
+        string_VkPresentModeKHR(presentMode)
+    );
 
     m_swapChainImageFormat = surfaceFormat.format;
     m_swapChainExtent = extent;
   }
 
+  /**
+   * Headless replacement of the swap chain: one color image per frame in
+   * flight, so an image is never rendered to while an earlier frame still
+   * uses it
+   */
+  void createOffscreenImages() {
+    m_swapChainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    m_swapChainExtent = {
+        static_cast<uint32_t>(Config::WINDOW_WIDTH),
+        static_cast<uint32_t>(Config::WINDOW_HEIGHT)};
+
+    m_offscreenImages.resize(m_framePacing.framesInFlight);
+    m_offscreenImagesMemory.resize(m_framePacing.framesInFlight);
+    m_swapChainImages.clear();
+
+    for (uint32_t i = 0; i < m_framePacing.framesInFlight; ++i) {
+      createImage(
+          m_swapChainExtent.width,
+          m_swapChainExtent.height,
+          1,
+          VK_SAMPLE_COUNT_1_BIT,
+          m_swapChainImageFormat,
+          VK_IMAGE_TILING_OPTIMAL,
+          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+              VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+          m_offscreenImages[i],
+          m_offscreenImagesMemory[i]
+      );
+
+      m_swapChainImages.push_back(*m_offscreenImages[i]);
+    }
+
+    SPDLOG_INFO(
+        "Rendering headless into {} offscreen images of {}x{}",
+        m_swapChainImages.size(),
+        m_swapChainExtent.width,
+        m_swapChainExtent.height
+    );
+  }
+
   void createImageViews() {
     m_swapChainImageViews.reserve(m_swapChainImages.size());
 
@@ -522,35 +1278,67 @@ class Application {
     }
   }
 
-  ShaderModule createShaderModule(const std::vector<char>& code) {
+  ShaderModule createShaderModule(const uint32_t* code, std::size_t codeSize) {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    createInfo.codeSize = codeSize;
+    createInfo.pCode = code;
 
     ShaderModule module(*m_device, createInfo);
     return module;
   }
 
   void createRenderPass() {
+    if (m_dynamicRendering) {
+      return;
+    }
+
+    m_renderPass = createSceneRenderPass();
+
+    if (m_depthPrepass) {
+      m_depthRenderPass = createDepthRenderPass(VK_ATTACHMENT_LOAD_OP_CLEAR);
+    }
+
+    if (m_occlusionCulling) {
+      m_depthLoadRenderPass = createDepthRenderPass(VK_ATTACHMENT_LOAD_OP_LOAD);
+    }
+
+    if (hasPostPass()) {
+      m_postRenderPass = createPostRenderPass();
+    }
+  }
+
+  /**
+   * Renders into the swap chain image, or into the scene color image when a
+   * post pass follows. With MSAA the multisampled color is resolved into it.
+   *
+   * The frame graph transitions the attachments around the pass, so they
+   * start and end in the layouts the subpass uses and there are no external
+   * dependencies.
+   */
+  std::unique_ptr<RenderPass> createSceneRenderPass() {
+    // Only the resolved samples are kept
     VkAttachmentDescription colorAttachment{};
     colorAttachment.format = m_swapChainImageFormat;
     colorAttachment.samples = m_msaaSamples;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    // After a pre-pass the depth is only tested against
     VkAttachmentDescription depthAttachment{};
     depthAttachment.format = findDepthFormat();
     depthAttachment.samples = m_msaaSamples;
-    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.loadOp = m_depthPrepass ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                            : VK_ATTACHMENT_LOAD_OP_CLEAR;
     depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.initialLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     depthAttachment.finalLayout =
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
@@ -561,8 +1349,15 @@ class Application {
     colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachmentResolve.initialLayout =
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachmentResolve.finalLayout =
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    // Without MSAA the single sampled target is the color attachment itself
+    if (!isMultisampled()) {
+      colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
 
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
@@ -582,22 +1377,14 @@ class Application {
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
     subpass.pDepthStencilAttachment = &depthAttachmentRef;
-    subpass.pResolveAttachments = &colorAttachmentResolveRef;
-
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                              VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                              VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-    std::array<VkAttachmentDescription, 3> attachments = {
-        colorAttachment, depthAttachment, colorAttachmentResolve};
+
+    std::vector<VkAttachmentDescription> attachments = {
+        colorAttachment, depthAttachment};
+
+    if (isMultisampled()) {
+      subpass.pResolveAttachments = &colorAttachmentResolveRef;
+      attachments.push_back(colorAttachmentResolve);
+    }
 
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -605,245 +1392,680 @@ class Application {
     renderPassInfo.pAttachments = attachments.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
 
-    m_renderPass = std::make_unique<RenderPass>(*m_device, renderPassInfo);
+    return std::make_unique<RenderPass>(*m_device, renderPassInfo);
   }
 
-  void createGraphicsPipeline() {
-    auto vertShaderCode = BinaryLoader::load("res/shaders/shader.vert.spv");
-    auto fragShaderCode = BinaryLoader::load("res/shaders/shader.frag.spv");
-
-    ShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-    ShaderModule fragShaderModule = createShaderModule(fragShaderCode);
-
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = {
-        vertShaderStageInfo, fragShaderStageInfo};
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.vertexAttributeDescriptionCount =
-        static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = m_msaaSamples;
-    multisampling.sampleShadingEnable = VK_TRUE;
-    multisampling.minSampleShading = .2f;
-
-    VkPipelineDepthStencilStateCreateInfo depthStencil{};
-    depthStencil.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_TRUE;
-    depthStencil.depthWriteEnable = VK_TRUE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-    depthStencil.depthBoundsTestEnable = VK_FALSE;
-    depthStencil.stencilTestEnable = VK_FALSE;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType =
-        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-    colorBlending.blendConstants[0] = 0.0f;
-    colorBlending.blendConstants[1] = 0.0f;
-    colorBlending.blendConstants[2] = 0.0f;
-    colorBlending.blendConstants[3] = 0.0f;
-
-    std::vector<VkDynamicState> dynamicStates = {
-        VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
-    VkPipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount =
-        static_cast<uint32_t>(dynamicStates.size());
-    dynamicState.pDynamicStates = dynamicStates.data();
+  /**
+   * Writes the depth attachment alone, the scene pass loads it afterwards.
+   * Render passes differing only in loadOp are compatible, so they share the
+   * framebuffer and the pipeline.
+   */
+  std::unique_ptr<RenderPass> createDepthRenderPass(VkAttachmentLoadOp loadOp) {
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = findDepthFormat();
+    depthAttachment.samples = m_msaaSamples;
+    depthAttachment.loadOp = loadOp;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.finalLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout->getHandle();
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 0;
+    depthAttachmentRef.layout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
-    m_pipelineLayout =
-        std::make_unique<PipelineLayout>(*m_device, pipelineLayoutInfo);
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &depthAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
 
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = &depthStencil;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.layout = *m_pipelineLayout;
-    pipelineInfo.renderPass = *m_renderPass;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-
-    m_graphicsPipeline =
-        std::make_unique<GraphicsPipeline>(*m_device, pipelineInfo);
+    return std::make_unique<RenderPass>(*m_device, renderPassInfo);
   }
 
-  void createFrameBuffers() {
-    m_swapChainFrameBuffers.reserve(m_swapChainImageViews.size());
+  /**
+   * Writes every pixel of the swap chain image, so its contents are not
+   * loaded. Transitions are up to the frame graph like in the scene pass.
+   */
+  std::unique_ptr<RenderPass> createPostRenderPass() {
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = m_swapChainImageFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-    for (const auto& imageView : m_swapChainImageViews) {
-      std::array<VkImageView, 3> attachments = {
-          *m_colorImageView, *m_depthImageView, imageView.getHandle()};
+    VkAttachmentReference colorAttachmentRef{};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-      VkFramebufferCreateInfo framebufferInfo{};
-      framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-      framebufferInfo.renderPass = *m_renderPass;
-      framebufferInfo.attachmentCount =
-          static_cast<uint32_t>(attachments.size());
-      framebufferInfo.pAttachments = attachments.data();
-      framebufferInfo.width = m_swapChainExtent.width;
-      framebufferInfo.height = m_swapChainExtent.height;
-      framebufferInfo.layers = 1;
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
 
-      m_swapChainFrameBuffers.emplace_back(*m_device, framebufferInfo);
-    }
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+
+    return std::make_unique<RenderPass>(*m_device, renderPassInfo);
   }
 
-  void createCommandPool() {
-    QueueFamilyIndices queueFamilyIndices =
-        QueueFamily::findSuitableQueueFamilies(m_physicalDevice, m_surface);
+  [[nodiscard]] bool isMultisampled() const {
+    return m_msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+  }
 
-    VkCommandPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  /**
+   * Whether the scene is rendered into the scene color image and filtered
+   * into the swap chain image by a fullscreen pass
+   */
+  [[nodiscard]] bool hasPostPass() const {
+    return m_renderScaling || AntiAliasing::isPostProcess(m_antiAliasing);
+  }
+
+  [[nodiscard]] VkImageLayout getPresentLayout() const {
+    return m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                      : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  }
+
+  void createGraphicsPipeline() {
+    m_vertShaderModule = std::make_unique<ShaderModule>(createShaderModule(
+        EmbeddedShaders::SHADER_VERT, sizeof(EmbeddedShaders::SHADER_VERT)
+    ));
+    m_fragShaderModule = std::make_unique<ShaderModule>(createShaderModule(
+        EmbeddedShaders::SHADER_FRAG, sizeof(EmbeddedShaders::SHADER_FRAG)
+    ));
+    m_depthVertShaderModule = std::make_unique<ShaderModule>(createShaderModule(
+        EmbeddedShaders::DEPTH_VERT, sizeof(EmbeddedShaders::DEPTH_VERT)
+    ));
+
+    std::array<VkDescriptorSetLayout, 2> setLayouts = {
+        *m_descriptorSetLayout, m_textureTable->getLayout()};
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(MaterialPushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount =
+        static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    m_pipelineLayout =
+        std::make_unique<PipelineLayout>(*m_device, pipelineLayoutInfo);
+
+    m_pipelineKey = PipelineKey{};
+    m_pipelineKey.vertexShader = *m_vertShaderModule;
+    m_pipelineKey.fragmentShader = *m_fragShaderModule;
+    m_pipelineKey.setVertexLayout(
+        Vertex::getBindingDescription(), Vertex::getAttributeDescriptions()
+    );
+    m_pipelineKey.layout = *m_pipelineLayout;
+
+    // Same layout as the main pass, so the frame descriptors are shared.
+    // Without a fragment shader only depth is written.
+    m_depthPipelineKey = PipelineKey{};
+    m_depthPipelineKey.vertexShader = *m_depthVertShaderModule;
+    m_depthPipelineKey.setVertexLayout(
+        VertexPosition::getBindingDescription(),
+        VertexPosition::getAttributeDescriptions()
+    );
+    m_depthPipelineKey.colorAttachmentCount = 0;
+    m_depthPipelineKey.layout = *m_pipelineLayout;
+
+    if (m_dynamicRendering) {
+      m_pipelineKey.colorFormat = m_swapChainImageFormat;
+      m_pipelineKey.depthFormat = findDepthFormat();
+      m_depthPipelineKey.depthFormat = m_pipelineKey.depthFormat;
+    }
+
+    if (m_depthPrepass) {
+      m_pipelineKey.depthWriteEnable = VK_FALSE;
+      m_pipelineKey.depthCompareOp = VK_COMPARE_OP_EQUAL;
+    }
+
+    updatePipelineKeys();
+
+    m_pipelineCache = std::make_unique<PipelineCache>(
+        *m_device, m_pipelineLibrarySupported
+    );
+
+    // Compile the pipelines up front so the first frame does not hitch
+    m_pipelineCache->get(m_pipelineKey);
+
+    if (m_depthPrepass) {
+      m_pipelineCache->get(m_depthPipelineKey);
+    }
+  }
+
+  /**
+   * Fullscreen pass applying post-process anti-aliasing or upscaling to the
+   * scene color. Its pipelines are only compiled once they are used.
+   */
+  void createPostPipeline() {
+    m_fullscreenVertShaderModule =
+        std::make_unique<ShaderModule>(createShaderModule(
+            EmbeddedShaders::FULLSCREEN_VERT,
+            sizeof(EmbeddedShaders::FULLSCREEN_VERT)
+        ));
+    m_fxaaFragShaderModule = std::make_unique<ShaderModule>(createShaderModule(
+        EmbeddedShaders::FXAA_FRAG, sizeof(EmbeddedShaders::FXAA_FRAG)
+    ));
+    m_upscaleFragShaderModule =
+        std::make_unique<ShaderModule>(createShaderModule(
+            EmbeddedShaders::UPSCALE_FRAG, sizeof(EmbeddedShaders::UPSCALE_FRAG)
+        ));
+
+    VkDescriptorSetLayout setLayout = *m_descriptorSetLayout;
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PostProcessPushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    m_postPipelineLayout =
+        std::make_unique<PipelineLayout>(*m_device, pipelineLayoutInfo);
+
+    m_postPipelineKey = PipelineKey{};
+    m_postPipelineKey.vertexShader = *m_fullscreenVertShaderModule;
+    m_postPipelineKey.cullMode = VK_CULL_MODE_NONE;
+    m_postPipelineKey.depthTestEnable = VK_FALSE;
+    m_postPipelineKey.depthWriteEnable = VK_FALSE;
+    m_postPipelineKey.layout = *m_postPipelineLayout;
+
+    if (m_dynamicRendering) {
+      m_postPipelineKey.colorFormat = m_swapChainImageFormat;
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+
+    m_sceneColorSampler = std::make_unique<Sampler>(*m_device, samplerInfo);
+  }
+
+  /**
+   * Points the pipeline keys at the current sample count, post filter and
+   * render passes
+   */
+  void updatePipelineKeys() {
+    m_pipelineKey.sampleCount = m_msaaSamples;
+    m_depthPipelineKey.sampleCount = m_msaaSamples;
+
+    // FXAA samples the scene at its own resolution, so it upscales as well
+    m_postPipelineKey.fragmentShader =
+        AntiAliasing::isPostProcess(m_antiAliasing)
+            ? *m_fxaaFragShaderModule
+            : *m_upscaleFragShaderModule;
+
+    if (!m_dynamicRendering) {
+      m_pipelineKey.renderPass = *m_renderPass;
+      m_depthPipelineKey.renderPass =
+          m_depthRenderPass ? m_depthRenderPass->getHandle() : VK_NULL_HANDLE;
+      m_postPipelineKey.renderPass =
+          m_postRenderPass ? m_postRenderPass->getHandle() : VK_NULL_HANDLE;
+    }
+  }
+
+  void createShaderHotReload() {
+    if (Config::IS_SHADER_HOT_RELOAD_ENABLED) {
+      m_shaderHotReload = std::make_unique<ShaderHotReload>(
+          std::vector<std::string>{VERT_SHADER_PATH, FRAG_SHADER_PATH},
+          std::vector<std::string>{},
+          SHADER_CACHE_DIR
+      );
+    }
+  }
+
+  /**
+   * Swaps in shaders recompiled since the last frame. Only the pipelines using
+   * a changed module are rebuilt, and the replaced ones go through the
+   * deletion queue, so the GPU never has to be idled.
+   */
+  void reloadShaders() {
+    if (!m_shaderHotReload) {
+      return;
+    }
+
+    for (const auto& update : m_shaderHotReload->takeUpdates()) {
+      std::unique_ptr<ShaderModule>& module =
+          update.sourcePath == VERT_SHADER_PATH ? m_vertShaderModule
+                                                : m_fragShaderModule;
+
+      auto newModule = std::make_unique<ShaderModule>(createShaderModule(
+          update.spirv.data(), update.spirv.size() * sizeof(uint32_t)
+      ));
+
+      std::size_t rebuilt =
+          m_pipelineCache->replaceShader(*module, *newModule);
+
+      if (m_pipelineKey.vertexShader == *module) {
+        m_pipelineKey.vertexShader = *newModule;
+      }
+
+      if (m_pipelineKey.fragmentShader == *module) {
+        m_pipelineKey.fragmentShader = *newModule;
+      }
+
+      // Deferred like the pipelines, so its handle cannot be reused by a new
+      // module while cache keys of frames in flight still refer to it
+      retire(std::exchange(module, std::move(newModule)));
+
+      SPDLOG_INFO(
+          "Hot reloaded {}, rebuilt {} pipelines", update.sourcePath, rebuilt
+      );
+    }
+  }
+
+  void createFrameBuffers() {
+    // Dynamic rendering begins on the image views themselves, so resizing
+    // never has to rebuild framebuffers
+    if (m_dynamicRendering) {
+      return;
+    }
+
+    if (m_depthRenderPass) {
+      VkImageView depth = m_frameGraph->getImageView(m_depthAttachment);
+
+      VkFramebufferCreateInfo framebufferInfo{};
+      framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+      framebufferInfo.renderPass = *m_depthRenderPass;
+      framebufferInfo.attachmentCount = 1;
+      framebufferInfo.pAttachments = &depth;
+      framebufferInfo.width = m_swapChainExtent.width;
+      framebufferInfo.height = m_swapChainExtent.height;
+      framebufferInfo.layers = 1;
+
+      m_depthFrameBuffer =
+          std::make_unique<FrameBuffer>(*m_device, framebufferInfo);
+    }
+
+    m_swapChainFrameBuffers.reserve(m_swapChainImageViews.size());
+
+    for (const auto& imageView : m_swapChainImageViews) {
+      // The scene goes to the swap chain image unless a post pass follows
+      VkImageView target = imageView.getHandle();
+
+      if (hasPostPass()) {
+        target = m_frameGraph->getImageView(m_sceneColor);
+      }
+
+      VkImageView depth = m_frameGraph->getImageView(m_depthAttachment);
+      std::vector<VkImageView> attachments = {target, depth};
+
+      if (isMultisampled()) {
+        attachments = {
+            m_frameGraph->getImageView(m_colorAttachment), depth, target};
+      }
+
+      VkFramebufferCreateInfo framebufferInfo{};
+      framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+      framebufferInfo.renderPass = *m_renderPass;
+      framebufferInfo.attachmentCount =
+          static_cast<uint32_t>(attachments.size());
+      framebufferInfo.pAttachments = attachments.data();
+      framebufferInfo.width = m_swapChainExtent.width;
+      framebufferInfo.height = m_swapChainExtent.height;
+      framebufferInfo.layers = 1;
+
+      m_swapChainFrameBuffers.emplace_back(*m_device, framebufferInfo);
+
+      if (!m_postRenderPass) {
+        continue;
+      }
+
+      VkImageView postAttachment = imageView.getHandle();
+      framebufferInfo.renderPass = *m_postRenderPass;
+      framebufferInfo.attachmentCount = 1;
+      framebufferInfo.pAttachments = &postAttachment;
+
+      m_postFrameBuffers.emplace_back(*m_device, framebufferInfo);
+    }
+  }
+
+  void createCommandPool() {
+    QueueFamilyIndices queueFamilyIndices =
+        QueueFamily::findSuitableQueueFamilies(m_physicalDevice, m_surface);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
 
     m_commandPool = std::make_unique<CommandPool>(*m_device, poolInfo);
+
+    if (m_asyncCompute) {
+      poolInfo.queueFamilyIndex = queueFamilyIndices.computeFamily.value();
+      m_computeCommandPool = std::make_unique<CommandPool>(*m_device, poolInfo);
+    }
   }
 
-  void copyBufferToImage(
-      VkBuffer buffer, VkImage image, uint32_t width, uint32_t height
-  ) {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  void createGpuProfiler() {
+    QueueFamilyIndices queueFamilyIndices =
+        QueueFamily::findSuitableQueueFamilies(m_physicalDevice, m_surface);
 
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
+    m_gpuProfiler = std::make_unique<GpuProfiler>(
+        *m_device,
+        m_physicalDevice,
+        queueFamilyIndices.graphicsFamily.value(),
+        Config::MAX_FRAMES_IN_FLIGHT,
+        /*maxScopesPerFrame=*/32,
+        // Keep every measured frame of a benchmark for the percentiles
+        m_benchmark ? std::max<std::size_t>(
+                          256, m_benchmark->getSettings().measuredFrames
+                      )
+                    : 256
+    );
+
+    // Uploads during initialization land in slot 0 and are read back by the
+    // first frame using it
+    m_gpuProfiler->beginFrame(0);
+  }
+
+  /**
+   * Copies tightly packed mip levels, each level i of levels goes to mip
+   * level i of the image
+   */
+  static void copyBufferToImage(
+      VkCommandBuffer commandBuffer,
+      VkBuffer buffer,
+      VkImage image,
+      const std::vector<MipChain::Level>& levels
+  ) {
+    std::vector<VkBufferImageCopy> regions(levels.size());
+
+    for (size_t i = 0; i < levels.size(); i++) {
+      VkBufferImageCopy& region = regions[i];
+      region.bufferOffset = levels[i].offset;
+      region.bufferRowLength = 0;
+      region.bufferImageHeight = 0;
+      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      region.imageSubresource.mipLevel = static_cast<uint32_t>(i);
+      region.imageSubresource.baseArrayLayer = 0;
+      region.imageSubresource.layerCount = 1;
+      region.imageOffset = {0, 0, 0};
+      region.imageExtent = {levels[i].width, levels[i].height, 1};
+    }
 
     vkCmdCopyBufferToImage(
         commandBuffer,
         buffer,
         image,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region
+        static_cast<uint32_t>(regions.size()),
+        regions.data()
     );
-
-    endSingleTimeCommands(commandBuffer);
   }
 
-  void createColorResources() {
-    VkFormat colorFormat = m_swapChainImageFormat;
+  /**
+   * Builds the passes of a frame and the attachments between them for the
+   * current extent, sample count and post pass
+   */
+  void createFrameGraph() {
+    m_frameGraph = std::make_unique<RenderGraph>(
+        *m_device, m_physicalDevice, m_synchronization2Supported
+    );
 
-    createImage(
-        m_swapChainExtent.width,
-        m_swapChainExtent.height,
-        1,
-        m_msaaSamples,
-        colorFormat,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
-            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_colorImage,
-        m_colorImageMemory
+    if (m_asyncCompute) {
+      m_frameGraph->setQueueFamilies(
+          m_sharedQueueFamilies[0], m_sharedQueueFamilies[1]
+      );
+    }
+
+    VkImageSubresourceRange colorRange{};
+    colorRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    colorRange.levelCount = 1;
+    colorRange.layerCount = 1;
+
+    // Presentation waits for the image semaphore at the color output stage,
+    // so that is where the image is first available
+    ImageState acquired;
+    acquired.stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+
+    ImageState presented;
+    presented.layout = getPresentLayout();
+
+    m_frameTarget = m_frameGraph->importImage(
+        "swap chain image", colorRange, acquired, presented
     );
+    m_frameUniforms = m_frameGraph->importBuffer("uniforms", true);
+    m_batchTimelineValues.clear();
 
-    m_colorImageView = std::make_unique<ImageView>(createImageView(
-        *m_colorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1
-    ));
+    VkFormat depthFormat = findDepthFormat();
+    VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+    if (hasStencilComponent(depthFormat)) {
+      depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    // A pre-pass stores depth for the main pass, otherwise it never leaves
+    // the scene pass
+    VkImageUsageFlags depthUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    if (!m_depthPrepass) {
+      depthUsage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+
+    if (m_occlusionCulling) {
+      depthUsage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    }
+
+    m_depthAttachment = m_frameGraph->createImage(
+        "depth",
+        {depthFormat,
+         m_attachmentExtent,
+         m_msaaSamples,
+         depthUsage,
+         depthAspect}
+    );
+
+    RenderGraph::ImageHandle sceneTarget = m_frameTarget;
+
+    if (hasPostPass()) {
+      m_sceneColor = m_frameGraph->createImage(
+          "scene color",
+          {m_swapChainImageFormat,
+           m_attachmentExtent,
+           VK_SAMPLE_COUNT_1_BIT,
+           VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+           VK_IMAGE_ASPECT_COLOR_BIT}
+      );
+      sceneTarget = m_sceneColor;
+    }
+
+    if (m_occlusionCulling) {
+      createOcclusionCullingResources();
+    }
+
+    // The early culling of a frame does not wait for its depth, so it
+    // overlaps the shading of the frame before
+    if (m_occlusionCulling && m_asyncCompute) {
+      addCullingPass(true);
+    }
+
+    if (m_depthPrepass) {
+      auto prepass = m_frameGraph->addPass(
+          "depth pre-pass",
+          [this](VkCommandBuffer commandBuffer) {
+            recordDepthPrepass(commandBuffer, false);
+          }
+      );
+      prepass.write(m_depthAttachment, ImageUsage::DepthAttachment)
+          .read(m_frameUniforms, BufferUsage::GraphicsUniformRead);
+
+      if (m_occlusionCulling) {
+        prepass.read(m_visibleDraws, BufferUsage::IndirectRead);
+      }
+    }
+
+    if (m_occlusionCulling) {
+      addOcclusionCullingPasses();
+    }
+
+    auto scenePass = m_frameGraph->addPass(
+        "scene",
+        [this](VkCommandBuffer commandBuffer) {
+          recordScenePass(commandBuffer, m_imageIndex);
+        }
+    );
+    scenePass.write(sceneTarget, ImageUsage::ColorAttachment)
+        .read(m_frameUniforms, BufferUsage::GraphicsUniformRead);
+
+    if (m_occlusionCulling) {
+      scenePass.read(m_visibleDraws, BufferUsage::IndirectRead);
+    }
+
+    if (m_depthPrepass) {
+      scenePass.read(m_depthAttachment, ImageUsage::DepthAttachment);
+    } else {
+      scenePass.write(m_depthAttachment, ImageUsage::DepthAttachment);
+    }
+
+    // Without MSAA the scene is rendered straight into its target
+    if (isMultisampled()) {
+      m_colorAttachment = m_frameGraph->createImage(
+          "multisampled color",
+          {m_swapChainImageFormat,
+           m_attachmentExtent,
+           m_msaaSamples,
+           VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+           VK_IMAGE_ASPECT_COLOR_BIT}
+      );
+      scenePass.write(m_colorAttachment, ImageUsage::ColorAttachment);
+    }
+
+    if (hasPostPass()) {
+      m_frameGraph
+          ->addPass(
+              "post process",
+              [this](VkCommandBuffer commandBuffer) {
+                recordPostPass(commandBuffer, m_imageIndex);
+              }
+          )
+          .read(m_sceneColor, ImageUsage::FragmentShaderRead)
+          .write(m_frameTarget, ImageUsage::ColorAttachment);
+    }
+
+    m_frameGraph->compile();
   }
 
-  void createDepthResources() {
-    VkFormat depthFormat = findDepthFormat();
+  /**
+   * The depth pyramid and the draw lists the culling passes share. With async
+   * compute the pyramid is built for the culling of the next frame, so it
+   * keeps its contents between executions.
+   */
+  void createOcclusionCullingResources() {
+    VkExtent2D pyramidExtent =
+        OcclusionCulling::getPyramidExtent(m_attachmentExtent);
+    m_depthPyramidLevels =
+        OcclusionCulling::getPyramidLevelCount(pyramidExtent);
+
+    RenderGraph::TransientImageInfo pyramidInfo{
+        VK_FORMAT_R32_SFLOAT,
+        pyramidExtent,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        m_depthPyramidLevels};
 
-    createImage(
-        m_swapChainExtent.width,
-        m_swapChainExtent.height,
-        1,
-        m_msaaSamples,
-        depthFormat,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_depthImage,
-        m_depthImageMemory
+    m_depthPyramid =
+        m_asyncCompute
+            ? m_frameGraph->createPersistentImage("depth pyramid", pyramidInfo)
+            : m_frameGraph->createImage("depth pyramid", pyramidInfo);
+
+    m_visibleDraws =
+        m_frameGraph->importBuffer("visible draws", m_asyncCompute);
+    m_disoccludedDraws =
+        m_frameGraph->importBuffer("disoccluded draws", false);
+  }
+
+  /**
+   * @param early whether the pass picks the chunks for the pre-pass from the
+   * previous frame's pyramid, and leaves the disoccluded list alone
+   */
+  void addCullingPass(bool early) {
+    auto culling = m_frameGraph->addPass(
+        early ? "early occlusion culling" : "occlusion culling",
+        [this, early](VkCommandBuffer commandBuffer) {
+          recordOcclusionCulling(commandBuffer, early);
+        }
     );
+    culling.read(m_depthPyramid, ImageUsage::ComputeShaderRead)
+        .read(m_frameUniforms, BufferUsage::ComputeUniformRead)
+        .write(m_visibleDraws, BufferUsage::ComputeShaderWrite)
+        .asyncCompute();
 
-    m_depthImageView = std::make_unique<ImageView>(createImageView(
-        *m_depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1
-    ));
+    if (!early) {
+      culling.write(m_disoccludedDraws, BufferUsage::ComputeShaderWrite);
+    }
+  }
+
+  /**
+   * Passes between the depth pre-pass and the scene: the depth pyramid, the
+   * culling, and the depth of the chunks the culling found disoccluded
+   */
+  void addOcclusionCullingPasses() {
+    m_frameGraph
+        ->addPass(
+            "depth pyramid",
+            [this](VkCommandBuffer commandBuffer) {
+              recordDepthPyramid(commandBuffer);
+            }
+        )
+        .read(m_depthAttachment, ImageUsage::ComputeShaderRead)
+        .write(m_depthPyramid, ImageUsage::ComputeShaderWrite)
+        .asyncCompute();
+
+    addCullingPass(false);
+
+    m_frameGraph
+        ->addPass(
+            "disoccluded depth",
+            [this](VkCommandBuffer commandBuffer) {
+              recordDepthPrepass(commandBuffer, true);
+            }
+        )
+        .write(m_depthAttachment, ImageUsage::DepthAttachment)
+        .read(m_frameUniforms, BufferUsage::GraphicsUniformRead)
+        .read(m_disoccludedDraws, BufferUsage::IndirectRead);
   }
 
   VkFormat findSupportedFormat(
@@ -875,10 +2097,16 @@ class Application {
         VK_FORMAT_D32_SFLOAT_S8_UINT,
         VK_FORMAT_D24_UNORM_S8_UINT};
 
+    VkFormatFeatureFlags features =
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    // The depth pyramid is built by sampling depth
+    if (m_occlusionCulling) {
+      features |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    }
+
     VkFormat optimalDepthFormat = findSupportedFormat(
-        candidates,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT
+        candidates, VK_IMAGE_TILING_OPTIMAL, features
     );
 
     return optimalDepthFormat;
@@ -890,23 +2118,40 @@ class Application {
   }
 
   void createTextureImage() {
-    using std::floor;
-    using std::log2;
-    using std::max;
+    PROFILE_FUNCTION();
 
     int texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load(
-        TEXTURE_PATH, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha
-    );
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
+    stbi_uc* pixels = nullptr;
 
-    m_mipLevels =
-        static_cast<uint32_t>(floor(log2(max(texWidth, texHeight)))) + 1;
+    {
+      PROFILE_SCOPE("stbi_load");
+      pixels = stbi_load(
+          TEXTURE_PATH, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha
+      );
+    }
 
     if (!pixels) {
       ABORT("Failed to load texture image");
     }
 
+    auto width = static_cast<uint32_t>(texWidth);
+    auto height = static_cast<uint32_t>(texHeight);
+    VkDeviceSize imageSize = VkDeviceSize{width} * height * 4;
+
+    m_mipLevels = MipChain::getLevelCount(width, height);
+
+    std::vector<MipChain::Level> levels = {{width, height, 0}};
+    std::vector<uint8_t> mipPixels;
+    bool blitMips = isLinearBlitSupported(VK_FORMAT_R8G8B8A8_SRGB);
+
+    if (!blitMips) {
+      SPDLOG_DEBUG("Generating texture mip levels on the CPU");
+
+      mipPixels.assign(pixels, pixels + imageSize);
+      levels = MipChain::generate(mipPixels, width, height);
+      imageSize = mipPixels.size();
+    }
+
     std::unique_ptr<Buffer> stagingBuffer;
     std::unique_ptr<DeviceMemory> stagingBufferMemory;
     createBuffer(
@@ -920,14 +2165,18 @@ class Application {
 
     void* data;
     vkMapMemory(*m_device, *stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
+    memcpy(
+        data,
+        blitMips ? pixels : mipPixels.data(),
+        static_cast<size_t>(imageSize)
+    );
     vkUnmapMemory(*m_device, *stagingBufferMemory);
 
     stbi_image_free(pixels);
 
     createImage(
-        texWidth,
-        texHeight,
+        width,
+        height,
         m_mipLevels,
         VK_SAMPLE_COUNT_1_BIT,
         VK_FORMAT_R8G8B8A8_SRGB,
@@ -939,171 +2188,125 @@ class Application {
         m_textureImageMemory
     );
 
-    transitionImageLayout(
-        *m_textureImage,
-        VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        m_mipLevels
-    );
-
-    copyBufferToImage(
-        *stagingBuffer,
-        *m_textureImage,
-        static_cast<uint32_t>(texWidth),
-        static_cast<uint32_t>(texHeight)
-    );
-
-    transitionImageLayout(
-        *m_textureImage,
-        VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        m_mipLevels
-    );
-
-    copyBufferToImage(
-        *stagingBuffer,
-        *m_textureImage,
-        static_cast<uint32_t>(texWidth),
-        static_cast<uint32_t>(texHeight)
-    );
-
-    generateMipmaps(
-        *m_textureImage,
-        VK_FORMAT_R8G8B8A8_SRGB,
-        texWidth,
-        texHeight,
-        m_mipLevels
-    );
+    uploadTexture(*stagingBuffer, levels, width, height, blitMips);
   }
 
-  void generateMipmaps(
-      VkImage image,
-      VkFormat imageFormat,
-      int32_t texWidth,
-      int32_t texHeight,
-      uint32_t mipLevels
+  /**
+   * Copies the levels into the texture image and blits the rest of the mip
+   * chain from them if blitMips. Every mip level is an image of its own to
+   * the graph, so each blit only waits for the level it reads.
+   */
+  void uploadTexture(
+      VkBuffer stagingBuffer,
+      const std::vector<MipChain::Level>& levels,
+      uint32_t width,
+      uint32_t height,
+      bool blitMips
   ) {
-    // Check if image format supports linear blitting
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(
-        m_physicalDevice, imageFormat, &formatProperties
-    );
-
-    if (!(formatProperties.optimalTilingFeatures &
-          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
-      throw std::runtime_error(
-          "texture image format does not support linear blitting!"
-      );
-    }
-
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.image = image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = 1;
-
-    int32_t mipWidth = texWidth;
-    int32_t mipHeight = texHeight;
-
-    for (uint32_t i = 1; i < mipLevels; i++) {
-      barrier.subresourceRange.baseMipLevel = i - 1;
-      barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-      barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-      vkCmdPipelineBarrier(
-          commandBuffer,
-          VK_PIPELINE_STAGE_TRANSFER_BIT,
-          VK_PIPELINE_STAGE_TRANSFER_BIT,
-          0,
-          0,
-          nullptr,
-          0,
-          nullptr,
-          1,
-          &barrier
-      );
-
-      VkImageBlit blit{};
-      blit.srcOffsets[0] = {0, 0, 0};
-      blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-      blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-      blit.srcSubresource.mipLevel = i - 1;
-      blit.srcSubresource.baseArrayLayer = 0;
-      blit.srcSubresource.layerCount = 1;
-      blit.dstOffsets[0] = {0, 0, 0};
-      blit.dstOffsets[1] = {
-          mipWidth > 1 ? mipWidth / 2 : 1,
-          mipHeight > 1 ? mipHeight / 2 : 1,
-          1};
-      blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-      blit.dstSubresource.mipLevel = i;
-      blit.dstSubresource.baseArrayLayer = 0;
-      blit.dstSubresource.layerCount = 1;
-
-      vkCmdBlitImage(
-          commandBuffer,
-          image,
-          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-          image,
-          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-          1,
-          &blit,
-          VK_FILTER_LINEAR
+    RenderGraph graph(*m_device, m_physicalDevice, m_synchronization2Supported);
+    std::vector<RenderGraph::ImageHandle> mips(m_mipLevels);
+
+    for (uint32_t i = 0; i < m_mipLevels; i++) {
+      VkImageSubresourceRange range{};
+      range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      range.baseMipLevel = i;
+      range.levelCount = 1;
+      range.layerCount = 1;
+
+      mips[i] = graph.importImage(
+          fmt::format("texture level {}", i),
+          range,
+          {},
+          ImageState::of(ImageUsage::FragmentShaderRead)
       );
+      graph.setImage(mips[i], *m_textureImage);
+    }
 
-      barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-      barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-      barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    auto upload = graph.addPass(
+        "copy",
+        [&](VkCommandBuffer commandBuffer) {
+          copyBufferToImage(
+              commandBuffer, stagingBuffer, *m_textureImage, levels
+          );
+        }
+    );
 
-      vkCmdPipelineBarrier(
-          commandBuffer,
-          VK_PIPELINE_STAGE_TRANSFER_BIT,
-          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-          0,
-          0,
-          nullptr,
-          0,
-          nullptr,
-          1,
-          &barrier
-      );
+    for (size_t i = 0; i < levels.size(); i++) {
+      upload.write(mips[i], ImageUsage::TransferDst);
+    }
 
-      if (mipWidth > 1) mipWidth /= 2;
-      if (mipHeight > 1) mipHeight /= 2;
+    // Without blitMips every level was generated on the CPU and copied
+    for (uint32_t i = 1; blitMips && i < m_mipLevels; i++) {
+      graph
+          .addPass(
+              fmt::format("blit level {}", i),
+              [this, i, width, height](VkCommandBuffer commandBuffer) {
+                blitMipLevel(commandBuffer, i, width, height);
+              }
+          )
+          .read(mips[i - 1], ImageUsage::TransferSrc)
+          .write(mips[i], ImageUsage::TransferDst);
     }
 
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    graph.compile();
+
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    m_gpuProfiler->beginScope(commandBuffer, "texture upload");
+    graph.execute(commandBuffer);
+    m_gpuProfiler->endScope(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+  }
+
+  /**
+   * Downsamples mip level - 1 of the texture image into level
+   */
+  void blitMipLevel(
+      VkCommandBuffer commandBuffer,
+      uint32_t level,
+      uint32_t width,
+      uint32_t height
+  ) {
+    auto mipSize = [](uint32_t size, uint32_t level) {
+      return static_cast<int32_t>(std::max(1u, size >> level));
+    };
 
-    vkCmdPipelineBarrier(
+    VkImageBlit blit{};
+    blit.srcOffsets[0] = {0, 0, 0};
+    blit.srcOffsets[1] = {
+        mipSize(width, level - 1), mipSize(height, level - 1), 1};
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.mipLevel = level - 1;
+    blit.srcSubresource.baseArrayLayer = 0;
+    blit.srcSubresource.layerCount = 1;
+    blit.dstOffsets[0] = {0, 0, 0};
+    blit.dstOffsets[1] = {mipSize(width, level), mipSize(height, level), 1};
+    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.dstSubresource.mipLevel = level;
+    blit.dstSubresource.baseArrayLayer = 0;
+    blit.dstSubresource.layerCount = 1;
+
+    vkCmdBlitImage(
         commandBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
+        *m_textureImage,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        *m_textureImage,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         1,
-        &barrier
+        &blit,
+        VK_FILTER_LINEAR
+    );
+  }
+
+  bool isLinearBlitSupported(VkFormat format) {
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(
+        m_physicalDevice, format, &formatProperties
     );
 
-    endSingleTimeCommands(commandBuffer);
+    return (formatProperties.optimalTilingFeatures &
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
   }
+
   void createImage(
       uint32_t width,
       uint32_t height,
@@ -1206,39 +2409,141 @@ class Application {
   void loadModel() { ModelLoader::loadObj(MODEL_PATH, m_vertices, m_indices); }
 
   void createVertexBuffer() {
-    VkDeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
+    createDeviceLocalBuffer(
+        m_vertices.data(),
+        sizeof(m_vertices[0]) * m_vertices.size(),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        m_vertexBuffer,
+        m_vertexBufferMemory
+    );
+  }
 
-    std::unique_ptr<Buffer> stagingBuffer;
-    std::unique_ptr<DeviceMemory> stagingBufferMemory;
+  void createPositionBuffer() {
+    std::vector<VertexPosition> positions;
+    positions.reserve(m_vertices.size());
 
-    createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
-        stagingBufferMemory
+    for (const Vertex& vertex : m_vertices) {
+      positions.push_back({vertex.pos});
+    }
+
+    createDeviceLocalBuffer(
+        positions.data(),
+        sizeof(positions[0]) * positions.size(),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        m_positionBuffer,
+        m_positionBufferMemory
     );
+  }
 
-    void* data;
-    vkMapMemory(*m_device, *stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, m_vertices.data(), (size_t)bufferSize);
-    vkUnmapMemory(*m_device, *stagingBufferMemory);
+  void createIndexBuffer() {
+    createDeviceLocalBuffer(
+        m_indices.data(),
+        sizeof(m_indices[0]) * m_indices.size(),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        m_indexBuffer,
+        m_indexBufferMemory
+    );
+  }
 
-    createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_vertexBuffer,
-        m_vertexBufferMemory
+  /**
+   * Splits the mesh into chunks and uploads their bounds and draw lists, with
+   * every chunk visible to start with
+   */
+  void createOcclusionCulling() {
+    if (!m_occlusionCulling) {
+      return;
+    }
+
+    m_culling = std::make_unique<OcclusionCulling>(*m_device);
+
+    OcclusionCulling::Chunks chunks = OcclusionCulling::buildChunks(
+        m_vertices, m_indices, Config::OCCLUSION_CHUNK_TRIANGLES
+    );
+
+    createDeviceLocalBuffer(
+        chunks.bounds.data(),
+        sizeof(chunks.bounds[0]) * chunks.bounds.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        m_chunkBoundsBuffer,
+        m_chunkBoundsBufferMemory
+    );
+
+    VkDeviceSize drawsSize = sizeof(chunks.draws[0]) * chunks.draws.size();
+    VkBufferUsageFlags drawsUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+    // Sized for the most frames in flight, which can change at runtime
+    size_t visibleListCount = m_asyncCompute ? Config::MAX_FRAMES_IN_FLIGHT : 1;
+    m_visibleDrawBuffers.resize(visibleListCount);
+    m_visibleDrawBuffersMemory.resize(visibleListCount);
+
+    for (size_t i = 0; i < visibleListCount; ++i) {
+      createDeviceLocalBuffer(
+          chunks.draws.data(),
+          drawsSize,
+          drawsUsage,
+          m_visibleDrawBuffers[i],
+          m_visibleDrawBuffersMemory[i]
+      );
+    }
+
+    // Rewritten by the culling before every draw, only the rest of the
+    // commands matter
+    createDeviceLocalBuffer(
+        chunks.draws.data(),
+        drawsSize,
+        drawsUsage,
+        m_disoccludedDrawBuffer,
+        m_disoccludedDrawBufferMemory
     );
 
-    copyBuffer(stagingBuffer, m_vertexBuffer, bufferSize);
+    m_drawLists.bounds = *m_chunkBoundsBuffer;
+    m_drawLists.disoccluded = *m_disoccludedDrawBuffer;
+    m_drawLists.chunkCount = static_cast<uint32_t>(chunks.draws.size());
   }
 
-  void createIndexBuffer() {
-    VkDeviceSize bufferSize = sizeof(m_indices[0]) * m_indices.size();
+  /**
+   * Splits the mesh into the same chunks as createOcclusionCulling(), kept on
+   * the CPU along with the positions the mesh occludes itself with
+   */
+  void createSoftwareOcclusion() {
+    if (!m_cpuOcclusion) {
+      return;
+    }
+
+    m_softwareOcclusion = std::make_unique<SoftwareOcclusion>(
+        Config::SOFTWARE_OCCLUSION_WIDTH,
+        Config::SOFTWARE_OCCLUSION_HEIGHT,
+        std::clamp(
+            std::thread::hardware_concurrency(),
+            1u,
+            Config::SOFTWARE_OCCLUSION_THREADS
+        )
+    );
+
+    m_chunks = OcclusionCulling::buildChunks(
+        m_vertices, m_indices, Config::OCCLUSION_CHUNK_TRIANGLES
+    );
+
+    m_occluderPositions.reserve(m_vertices.size());
+
+    for (const Vertex& vertex : m_vertices) {
+      m_occluderPositions.push_back(vertex.pos);
+    }
 
+    m_visibleChunks.reserve(m_chunks.draws.size());
+  }
+
+  /**
+   * Uploads data into a new device local buffer through a staging buffer
+   */
+  void createDeviceLocalBuffer(
+      const void* source,
+      VkDeviceSize bufferSize,
+      VkBufferUsageFlags usage,
+      std::unique_ptr<Buffer>& buffer,
+      std::unique_ptr<DeviceMemory>& bufferMemory
+  ) {
     std::unique_ptr<Buffer> stagingBuffer;
     std::unique_ptr<DeviceMemory> stagingBufferMemory;
     createBuffer(
@@ -1252,28 +2557,28 @@ class Application {
 
     void* data;
     vkMapMemory(*m_device, *stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, m_indices.data(), (size_t)bufferSize);
+    memcpy(data, source, (size_t)bufferSize);
     vkUnmapMemory(*m_device, *stagingBufferMemory);
 
     createBuffer(
         bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_indexBuffer,
-        m_indexBufferMemory
+        buffer,
+        bufferMemory
     );
 
-    copyBuffer(stagingBuffer, m_indexBuffer, bufferSize);
+    copyBuffer(stagingBuffer, buffer, bufferSize);
   }
 
   void createUniformBuffers() {
     VkDeviceSize bufferSize = sizeof(UniformBufferObject);
 
-    m_uniformBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
-    m_uniformBuffersMemory.resize(Config::MAX_FRAMES_IN_FLIGHT);
-    m_uniformBuffersMapped.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_uniformBuffers.resize(m_framePacing.framesInFlight);
+    m_uniformBuffersMemory.resize(m_framePacing.framesInFlight);
+    m_uniformBuffersMapped.resize(m_framePacing.framesInFlight);
 
-    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < m_framePacing.framesInFlight; i++) {
       createBuffer(
           bufferSize,
           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
@@ -1294,83 +2599,94 @@ class Application {
     }
   }
 
-  void createDescriptorPool() {
-    auto MAX_FRAMES_IN_FLIGHT =
-        static_cast<uint32_t>(Config::MAX_FRAMES_IN_FLIGHT);
-
-    std::array<VkDescriptorPoolSize, 2> poolSizes{};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = MAX_FRAMES_IN_FLIGHT;
+  void createDescriptorAllocators() {
+    std::vector<DescriptorAllocator::PoolSizeRatio> ratios = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f}};
 
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = MAX_FRAMES_IN_FLIGHT;
+    // The culling sets of a frame: one per pyramid level and the draw lists
+    if (m_occlusionCulling) {
+      ratios.push_back({VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f});
+      ratios.push_back({VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f});
+    }
 
+    m_frameDescriptorAllocators.reserve(m_framePacing.framesInFlight);
 
-    VkDescriptorPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    for (size_t i = 0; i < m_framePacing.framesInFlight; i++) {
+      m_frameDescriptorAllocators.emplace_back(
+          std::make_unique<DescriptorAllocator>(*m_device, ratios)
+      );
+    }
 
-    m_descriptorPool = std::make_unique<DescriptorPool>(*m_device, poolInfo);
+    m_frameDescriptorSets.resize(m_framePacing.framesInFlight);
   }
 
   void createDescriptorSets() {
-    std::vector<VkDescriptorSetLayout> layouts(
-        Config::MAX_FRAMES_IN_FLIGHT, *m_descriptorSetLayout
-    );
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = *m_descriptorPool;
-    allocInfo.descriptorSetCount =
-        static_cast<uint32_t>(Config::MAX_FRAMES_IN_FLIGHT);
-    allocInfo.pSetLayouts = layouts.data();
-
-    m_descriptorSets.resize(Config::MAX_FRAMES_IN_FLIGHT);
-    if (vkAllocateDescriptorSets(
-            *m_device, &allocInfo, m_descriptorSets.data()
-        ) != VK_SUCCESS) {
-      ABORT("Failed to allocate descriptor sets");
-    }
-
-    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++) {
-      VkDescriptorBufferInfo bufferInfo{};
-      bufferInfo.buffer = *m_uniformBuffers[i];
-      bufferInfo.offset = 0;
-      bufferInfo.range = sizeof(UniformBufferObject);
-
-      VkDescriptorImageInfo imageInfo{};
-      imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-      imageInfo.imageView = *m_textureImageView;
-      imageInfo.sampler = *m_textureSampler;
-
-      std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-      descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptorWrites[0].dstSet = m_descriptorSets[i];
-      descriptorWrites[0].dstBinding = 0;
-      descriptorWrites[0].dstArrayElement = 0;
-      descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-      descriptorWrites[0].descriptorCount = 1;
-      descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-      descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptorWrites[1].dstSet = m_descriptorSets[i];
-      descriptorWrites[1].dstBinding = 1;
-      descriptorWrites[1].dstArrayElement = 0;
-      descriptorWrites[1].descriptorType =
-          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-      descriptorWrites[1].descriptorCount = 1;
-      descriptorWrites[1].pImageInfo = &imageInfo;
-
-      vkUpdateDescriptorSets(
-          *m_device,
-          static_cast<uint32_t>(descriptorWrites.size()),
-          descriptorWrites.data(),
-          0,
-          nullptr
-      );
-    }
+    VkDescriptorUpdateTemplateEntry uniformBufferEntry{};
+    uniformBufferEntry.dstBinding = 0;
+    uniformBufferEntry.dstArrayElement = 0;
+    uniformBufferEntry.descriptorCount = 1;
+    uniformBufferEntry.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uniformBufferEntry.offset = offsetof(FrameDescriptors, uniformBuffer);
+    uniformBufferEntry.stride = sizeof(VkDescriptorBufferInfo);
+
+    VkDescriptorUpdateTemplateEntry sceneColorEntry{};
+    sceneColorEntry.dstBinding = 1;
+    sceneColorEntry.dstArrayElement = 0;
+    sceneColorEntry.descriptorCount = 1;
+    sceneColorEntry.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    sceneColorEntry.offset = offsetof(FrameDescriptors, sceneColor);
+    sceneColorEntry.stride = sizeof(VkDescriptorImageInfo);
+
+    std::array<VkDescriptorUpdateTemplateEntry, 2> entries = {
+        uniformBufferEntry, sceneColorEntry};
+
+    VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+    templateInfo.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    templateInfo.descriptorUpdateEntryCount =
+        static_cast<uint32_t>(entries.size());
+    templateInfo.pDescriptorUpdateEntries = entries.data();
+    templateInfo.templateType =
+        VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    templateInfo.descriptorSetLayout = *m_descriptorSetLayout;
+
+    m_descriptorUpdateTemplate =
+        std::make_unique<DescriptorUpdateTemplate>(*m_device, templateInfo);
+
+    m_textureIndex =
+        m_textureTable->add(*m_textureImageView, *m_textureSampler);
+  }
+
+  /**
+   * Per frame sets are transient: the frame's allocator is recycled as soon as
+   * its previous submission has finished and the set is written again.
+   */
+  void updateFrameDescriptors(uint32_t currentFrame) {
+    DescriptorAllocator& allocator = *m_frameDescriptorAllocators[currentFrame];
+    allocator.reset();
+
+    VkDescriptorSet set = allocator.allocate(*m_descriptorSetLayout);
+
+    FrameDescriptors descriptors{};
+    descriptors.uniformBuffer.buffer = *m_uniformBuffers[currentFrame];
+    descriptors.uniformBuffer.offset = 0;
+    descriptors.uniformBuffer.range = sizeof(UniformBufferObject);
+
+    // Only the post pass reads the scene color, without one the descriptor
+    // just has to stay valid
+    descriptors.sceneColor.sampler = *m_sceneColorSampler;
+    descriptors.sceneColor.imageView =
+        hasPostPass() ? m_frameGraph->getImageView(m_sceneColor)
+                      : *m_textureImageView;
+    descriptors.sceneColor.imageLayout =
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    vkUpdateDescriptorSetWithTemplate(
+        *m_device, set, *m_descriptorUpdateTemplate, &descriptors
+    );
+
+    m_frameDescriptorSets[currentFrame] = set;
   }
 
   void createBuffer(
@@ -1386,6 +2702,15 @@ class Application {
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    // The culling reads and writes buffers on the compute queue, which are
+    // shared rather than handed over between the queues
+    if (!m_sharedQueueFamilies.empty()) {
+      bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+      bufferInfo.queueFamilyIndexCount =
+          static_cast<uint32_t>(m_sharedQueueFamilies.size());
+      bufferInfo.pQueueFamilyIndices = m_sharedQueueFamilies.data();
+    }
+
     buffer = std::make_unique<Buffer>(*m_device, bufferInfo);
 
     VkMemoryRequirements memRequirements;
@@ -1408,204 +2733,790 @@ class Application {
       VkDeviceSize size
   ) {
     VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    m_gpuProfiler->beginScope(commandBuffer, "buffer upload");
 
     VkBufferCopy copyRegion{};
     copyRegion.size = size;
     vkCmdCopyBuffer(commandBuffer, *srcBuffer, *dstBuffer, 1, &copyRegion);
 
+    m_gpuProfiler->endScope(commandBuffer);
     endSingleTimeCommands(commandBuffer);
   }
 
   uint32_t findMemoryType(
       uint32_t typeFilter, VkMemoryPropertyFlags properties
   ) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-      if ((typeFilter & (1 << i)) &&
-          (memProperties.memoryTypes[i].propertyFlags & properties) ==
-              properties) {
-        return i;
+    return PhysicalDevice::findMemoryType(
+        m_physicalDevice, typeFilter, properties
+    );
+  }
+
+  /**
+   * The batches of the frame graph and their queues stay the same when it is
+   * rebuilt, so the command buffers are allocated once for them
+   */
+  void createCommandBuffers() {
+    const auto& batches = m_frameGraph->getBatches();
+    m_commandBuffers.assign(
+        m_framePacing.framesInFlight,
+        std::vector<VkCommandBuffer>(batches.size())
+    );
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    for (auto& commandBuffers : m_commandBuffers) {
+      for (size_t batch = 0; batch < batches.size(); ++batch) {
+        allocInfo.commandPool = batches[batch].asyncCompute
+                                    ? *m_computeCommandPool
+                                    : *m_commandPool;
+
+        ABORT_ON_FAIL(
+            vkAllocateCommandBuffers(
+                *m_device, &allocInfo, &commandBuffers[batch]
+            ),
+            "Failed to allocate command buffers"
+        );
+      }
+    }
+  }
+
+  void freeCommandBuffers() {
+    const auto& batches = m_frameGraph->getBatches();
+
+    for (auto& commandBuffers : m_commandBuffers) {
+      for (size_t batch = 0; batch < batches.size(); ++batch) {
+        vkFreeCommandBuffers(
+            *m_device,
+            batches[batch].asyncCompute ? *m_computeCommandPool
+                                        : *m_commandPool,
+            1,
+            &commandBuffers[batch]
+        );
+      }
+    }
+
+    m_commandBuffers.clear();
+  }
+
+  /**
+   * Records one batch of the frame graph. The frame scope spans from the
+   * first graphics batch to the last, with the compute batches in between.
+   * Compute batches before it may overlap the frame before.
+   */
+  void recordCommandBuffer(VkCommandBuffer commandBuffer, size_t batch) {
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    ABORT_ON_FAIL(
+        vkBeginCommandBuffer(commandBuffer, &beginInfo),
+        "Failed to begin recording command buffer"
+    );
+
+    // The last batch is always a graphics one
+    const auto& batches = m_frameGraph->getBatches();
+    size_t firstGraphicsBatch = 0;
+
+    while (batches[firstGraphicsBatch].asyncCompute) {
+      ++firstGraphicsBatch;
+    }
+
+    if (batch == firstGraphicsBatch) {
+      m_gpuProfiler->beginScope(commandBuffer, "frame");
+    }
+
+    m_frameGraph->execute(commandBuffer, batch);
+
+    if (batch + 1 == batches.size()) {
+      m_gpuProfiler->endScope(commandBuffer);
+    }
+
+    ABORT_ON_FAIL(
+        vkEndCommandBuffer(commandBuffer), "Failed to record command buffer"
+    );
+  }
+
+  /**
+   * Lays down the depth of the scene from the position stream, without
+   * running any fragment shader. With occlusion culling these are the chunks
+   * visible in the last frame, or with async compute the ones the early
+   * culling found, and with disoccluded the chunks that turned visible since,
+   * on top of the existing depth.
+   */
+  void recordDepthPrepass(VkCommandBuffer commandBuffer, bool disoccluded) {
+    m_gpuProfiler->beginScope(
+        commandBuffer, disoccluded ? "disoccluded depth" : "depth pre-pass"
+    );
+
+    VkAttachmentLoadOp loadOp =
+        disoccluded ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+
+    VkClearValue clearValue{};
+    clearValue.depthStencil = {1.0f, 0};
+
+    if (m_dynamicRendering) {
+      VkRenderingAttachmentInfoKHR depthAttachment{};
+      depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+      depthAttachment.imageView =
+          m_frameGraph->getImageView(m_depthAttachment);
+      depthAttachment.imageLayout =
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+      depthAttachment.loadOp = loadOp;
+      depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+      depthAttachment.clearValue = clearValue;
+
+      VkRenderingInfoKHR renderingInfo{};
+      renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+      renderingInfo.renderArea.offset = {0, 0};
+      renderingInfo.renderArea.extent = m_renderExtent;
+      renderingInfo.layerCount = 1;
+      renderingInfo.pDepthAttachment = &depthAttachment;
+
+      m_dynamicRendering->begin(commandBuffer, renderingInfo);
+    } else {
+      VkRenderPassBeginInfo renderPassInfo{};
+      renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+      renderPassInfo.renderPass =
+          disoccluded ? *m_depthLoadRenderPass : *m_depthRenderPass;
+      renderPassInfo.framebuffer = *m_depthFrameBuffer;
+      renderPassInfo.renderArea.offset = {0, 0};
+      renderPassInfo.renderArea.extent = m_renderExtent;
+      renderPassInfo.clearValueCount = 1;
+      renderPassInfo.pClearValues = &clearValue;
+
+      vkCmdBeginRenderPass(
+          commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE
+      );
+    }
+
+    vkCmdBindPipeline(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        m_pipelineCache->get(m_depthPipelineKey)
+    );
+
+    setViewport(commandBuffer, m_renderExtent);
+
+    VkBuffer vertexBuffers[] = {*m_positionBuffer};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+    vkCmdBindIndexBuffer(
+        commandBuffer, *m_indexBuffer, 0, VK_INDEX_TYPE_UINT32
+    );
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        *m_pipelineLayout,
+        0,
+        1,
+        &m_frameDescriptorSets[m_currentFrame],
+        0,
+        nullptr
+    );
+
+    drawMesh(
+        commandBuffer,
+        disoccluded ? *m_disoccludedDrawBuffer : getVisibleDrawBuffer()
+    );
+
+    if (m_dynamicRendering) {
+      m_dynamicRendering->end(commandBuffer);
+    } else {
+      vkCmdEndRenderPass(commandBuffer);
+    }
+
+    m_gpuProfiler->endScope(commandBuffer);
+  }
+
+  /**
+   * Draws the scene into its target, with the attachments already
+   * transitioned by the frame graph
+   */
+  void recordScenePass(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    m_gpuProfiler->beginScope(commandBuffer, "render pass");
+
+    if (m_dynamicRendering) {
+      beginDynamicRendering(commandBuffer, imageIndex, clearValues);
+    } else {
+      VkRenderPassBeginInfo renderPassInfo{};
+      renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+      renderPassInfo.renderPass = *m_renderPass;
+      renderPassInfo.framebuffer = m_swapChainFrameBuffers[imageIndex];
+      renderPassInfo.renderArea.offset = {0, 0};
+      renderPassInfo.renderArea.extent = m_renderExtent;
+      renderPassInfo.clearValueCount =
+          static_cast<uint32_t>(clearValues.size());
+      renderPassInfo.pClearValues = clearValues.data();
+
+      vkCmdBeginRenderPass(
+          commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE
+      );
+    }
+
+    vkCmdBindPipeline(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        m_pipelineCache->get(m_pipelineKey)
+    );
+
+    setViewport(commandBuffer, m_renderExtent);
+
+    VkBuffer vertexBuffers[] = {*m_vertexBuffer};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+    vkCmdBindIndexBuffer(
+        commandBuffer, *m_indexBuffer, 0, VK_INDEX_TYPE_UINT32
+    );
+
+    std::array<VkDescriptorSet, 2> descriptorSets = {
+        m_frameDescriptorSets[m_currentFrame], m_textureTable->getSet()};
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        *m_pipelineLayout,
+        0,
+        static_cast<uint32_t>(descriptorSets.size()),
+        descriptorSets.data(),
+        0,
+        nullptr
+    );
+
+    MaterialPushConstants material{};
+    material.textureIndex = m_textureIndex;
+
+    vkCmdPushConstants(
+        commandBuffer,
+        *m_pipelineLayout,
+        VK_SHADER_STAGE_FRAGMENT_BIT,
+        0,
+        sizeof(material),
+        &material
+    );
+
+    drawMesh(commandBuffer, getVisibleDrawBuffer());
+
+    if (m_dynamicRendering) {
+      m_dynamicRendering->end(commandBuffer);
+    } else {
+      vkCmdEndRenderPass(commandBuffer);
+    }
+
+    m_gpuProfiler->endScope(commandBuffer);
+  }
+
+  /**
+   * List the culling of the frame being recorded writes, none without
+   * occlusion culling
+   */
+  VkBuffer getVisibleDrawBuffer() const {
+    if (m_visibleDrawBuffers.empty()) {
+      return VK_NULL_HANDLE;
+    }
+
+    return *m_visibleDrawBuffers[m_currentFrame % m_visibleDrawBuffers.size()];
+  }
+
+  /**
+   * Draws the whole mesh, the chunks in drawList when there is one, or the
+   * chunks CPU occlusion culling left
+   */
+  void drawMesh(VkCommandBuffer commandBuffer, VkBuffer drawList) {
+    if (m_softwareOcclusion) {
+      for (const VkDrawIndexedIndirectCommand& draw : m_visibleChunks) {
+        vkCmdDrawIndexed(
+            commandBuffer,
+            draw.indexCount,
+            1,
+            draw.firstIndex,
+            draw.vertexOffset,
+            0
+        );
       }
+      return;
+    }
+
+    if (drawList != VK_NULL_HANDLE) {
+      vkCmdDrawIndexedIndirect(
+          commandBuffer,
+          drawList,
+          0,
+          m_drawLists.chunkCount,
+          sizeof(VkDrawIndexedIndirectCommand)
+      );
+      return;
     }
 
-    ABORT("Failed to find suitable memory type");
+    vkCmdDrawIndexed(
+        commandBuffer, static_cast<uint32_t>(m_indices.size()), 1, 0, 0, 0
+    );
+  }
+
+  /**
+   * Rasterizes the mesh as its own occluder with the camera of the frame, and
+   * keeps the chunks in front of it
+   */
+  void cullChunksOnCpu() {
+    PROFILE_FUNCTION();
+
+    auto ubo = UniformBufferObject::create(
+        m_cameraState.getViewMatrix(), m_swapChainExtent
+    );
+    glm::mat4 transform = ubo.proj * ubo.view * ubo.model;
+
+    m_softwareOcclusion->clear();
+    m_softwareOcclusion->renderOccluders(
+        m_occluderPositions, m_indices, transform, true
+    );
+
+    m_visibleChunks.clear();
+
+    for (size_t chunk = 0; chunk < m_chunks.draws.size(); ++chunk) {
+      const OcclusionCulling::ChunkBounds& bounds = m_chunks.bounds[chunk];
+
+      if (!m_softwareOcclusion->isVisible(
+              glm::vec3(bounds.min), glm::vec3(bounds.max), transform
+          )) {
+        continue;
+      }
+
+      const VkDrawIndexedIndirectCommand& draw = m_chunks.draws[chunk];
+      VkDrawIndexedIndirectCommand* last =
+          m_visibleChunks.empty() ? nullptr : &m_visibleChunks.back();
+
+      if (last && last->firstIndex + last->indexCount == draw.firstIndex) {
+        last->indexCount += draw.indexCount;
+      } else {
+        m_visibleChunks.push_back(draw);
+      }
+    }
   }
 
-  void createCommandBuffers() {
-    m_commandBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = *m_commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount =
-        static_cast<uint32_t>(m_commandBuffers.size());
+  void recordDepthPyramid(VkCommandBuffer commandBuffer) {
+    m_gpuProfiler->beginScope(commandBuffer, "depth pyramid");
+
+    std::vector<VkImageView> levels(m_depthPyramidLevels);
+
+    for (uint32_t level = 0; level < m_depthPyramidLevels; ++level) {
+      levels[level] = m_frameGraph->getImageView(m_depthPyramid, level);
+    }
 
-    ABORT_ON_FAIL(
-        vkAllocateCommandBuffers(
-            *m_device, &allocInfo, m_commandBuffers.data()
-        ),
-        "Failed to allocate command buffers"
+    m_culling->recordPyramidBuild(
+        commandBuffer,
+        *m_frameDescriptorAllocators[m_currentFrame],
+        m_frameGraph->getSampledImageView(m_depthAttachment),
+        m_msaaSamples,
+        levels,
+        m_renderExtent
     );
-  }
+    m_depthPyramidExtent = m_renderExtent;
 
-  void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    m_gpuProfiler->endScope(commandBuffer);
+  }
 
-    ABORT_ON_FAIL(
-        vkBeginCommandBuffer(commandBuffer, &beginInfo),
-        "Failed to begin recording command buffer"
+  void recordOcclusionCulling(VkCommandBuffer commandBuffer, bool early) {
+    m_gpuProfiler->beginScope(
+        commandBuffer, early ? "early occlusion culling" : "occlusion culling"
     );
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = *m_renderPass;
-    renderPassInfo.framebuffer = m_swapChainFrameBuffers[imageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = m_swapChainExtent;
+    VkDescriptorBufferInfo uniformBuffer{};
+    uniformBuffer.buffer = *m_uniformBuffers[m_currentFrame];
+    uniformBuffer.offset = 0;
+    uniformBuffer.range = sizeof(UniformBufferObject);
 
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-    clearValues[1].depthStencil = {1.0f, 0};
+    OcclusionCulling::DrawLists drawLists = m_drawLists;
+    drawLists.visible = getVisibleDrawBuffer();
 
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+    // The early culling reads the previous execution's pyramid, which the
+    // first one does not have. The pyramid keeps the extent and camera of the
+    // frame it was built in, which under dynamic resolution need not be the
+    // extent of this frame.
+    bool pyramidBuilt = !early || !m_frameGraph->isFirstExecution();
+    std::optional<glm::mat4> pyramidViewProjection;
 
-    vkCmdBeginRenderPass(
-        commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE
-    );
+    if (early) {
+      pyramidViewProjection = m_previousViewProjection;
+    }
 
-    vkCmdBindPipeline(
-        commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_graphicsPipeline
+    m_culling->recordCulling(
+        commandBuffer,
+        *m_frameDescriptorAllocators[m_currentFrame],
+        uniformBuffer,
+        m_frameGraph->getImageView(m_depthPyramid),
+        pyramidBuilt ? m_depthPyramidLevels : 0,
+        m_depthPyramidExtent,
+        drawLists,
+        pyramidViewProjection
     );
 
+    m_gpuProfiler->endScope(commandBuffer);
+  }
+
+  static void setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent) {
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = (float)m_swapChainExtent.width;
-    viewport.height = (float)m_swapChainExtent.height;
+    viewport.width = (float)extent.width;
+    viewport.height = (float)extent.height;
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
     VkRect2D scissor{};
     scissor.offset = {0, 0};
-    scissor.extent = m_swapChainExtent;
+    scissor.extent = extent;
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+  }
 
-    VkBuffer vertexBuffers[] = {*m_vertexBuffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+  /**
+   * Filters the scene color into the swap chain image, with FXAA or with the
+   * upscaling filter
+   */
+  void recordPostPass(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    m_gpuProfiler->beginScope(commandBuffer, "post process");
 
-    vkCmdBindIndexBuffer(
-        commandBuffer, *m_indexBuffer, 0, VK_INDEX_TYPE_UINT32
+    if (m_dynamicRendering) {
+      beginDynamicPostRendering(commandBuffer, imageIndex);
+    } else {
+      VkRenderPassBeginInfo renderPassInfo{};
+      renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+      renderPassInfo.renderPass = *m_postRenderPass;
+      renderPassInfo.framebuffer = m_postFrameBuffers[imageIndex];
+      renderPassInfo.renderArea.offset = {0, 0};
+      renderPassInfo.renderArea.extent = m_swapChainExtent;
+
+      vkCmdBeginRenderPass(
+          commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE
+      );
+    }
+
+    vkCmdBindPipeline(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        m_pipelineCache->get(m_postPipelineKey)
     );
 
+    setViewport(commandBuffer, m_swapChainExtent);
+
     vkCmdBindDescriptorSets(
         commandBuffer,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
-        *m_pipelineLayout,
+        *m_postPipelineLayout,
         0,
         1,
-        &m_descriptorSets[m_currentFrame],
+        &m_frameDescriptorSets[m_currentFrame],
         0,
         nullptr
     );
 
-    vkCmdDrawIndexed(
-        commandBuffer, static_cast<uint32_t>(m_indices.size()), 1, 0, 0, 0
-    );
+    // The scene only covers the render extent of the larger attachment
+    auto attachmentWidth = static_cast<float>(m_attachmentExtent.width);
+    auto attachmentHeight = static_cast<float>(m_attachmentExtent.height);
 
-    vkCmdEndRenderPass(commandBuffer);
+    PostProcessPushConstants constants{};
+    constants.uvScale = {
+        static_cast<float>(m_renderExtent.width) / attachmentWidth,
+        static_cast<float>(m_renderExtent.height) / attachmentHeight};
+    constants.texelSize = {1.0f / attachmentWidth, 1.0f / attachmentHeight};
 
-    ABORT_ON_FAIL(
-        vkEndCommandBuffer(commandBuffer), "Failed to record command buffer"
+    vkCmdPushConstants(
+        commandBuffer,
+        *m_postPipelineLayout,
+        VK_SHADER_STAGE_FRAGMENT_BIT,
+        0,
+        sizeof(constants),
+        &constants
     );
+
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+    if (m_dynamicRendering) {
+      m_dynamicRendering->end(commandBuffer);
+    } else {
+      vkCmdEndRenderPass(commandBuffer);
+    }
+
+    m_gpuProfiler->endScope(commandBuffer);
+  }
+
+  /**
+   * Begins rendering with the same loads, stores and resolve as the render
+   * pass of createRenderPass()
+   */
+  void beginDynamicRendering(
+      VkCommandBuffer commandBuffer,
+      uint32_t imageIndex,
+      const std::array<VkClearValue, 2>& clearValues
+  ) {
+    VkImageView targetView = m_swapChainImageViews[imageIndex];
+
+    if (hasPostPass()) {
+      targetView = m_frameGraph->getImageView(m_sceneColor);
+    }
+
+    // Without MSAA the single sampled target is the color attachment itself
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = targetView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = clearValues[0];
+
+    if (isMultisampled()) {
+      colorAttachment.imageView =
+          m_frameGraph->getImageView(m_colorAttachment);
+      colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+      colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+      colorAttachment.resolveImageView = targetView;
+      colorAttachment.resolveImageLayout =
+          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
+    VkRenderingAttachmentInfoKHR depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = m_frameGraph->getImageView(m_depthAttachment);
+    depthAttachment.imageLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = m_depthPrepass ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                            : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue = clearValues[1];
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = m_renderExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    m_dynamicRendering->begin(commandBuffer, renderingInfo);
+  }
+
+  /**
+   * Begins rendering into the swap chain image, every pixel of which the post
+   * pass writes
+   */
+  void beginDynamicPostRendering(
+      VkCommandBuffer commandBuffer, uint32_t imageIndex
+  ) {
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = m_swapChainImageViews[imageIndex];
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = m_swapChainExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+
+    m_dynamicRendering->begin(commandBuffer, renderingInfo);
   }
 
   void createSyncObjects() {
-    m_imageAvailableSemaphores.reserve(Config::MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.reserve(Config::MAX_FRAMES_IN_FLIGHT);
-    m_inFlightFences.reserve(Config::MAX_FRAMES_IN_FLIGHT);
+    // Frames wait on the timelines of both queues, only the swap chain needs
+    // binary semaphores
+    m_frameTimelineValues.assign(m_framePacing.framesInFlight, 0);
+    m_frameComputeTimelineValues.assign(m_framePacing.framesInFlight, 0);
+    m_imageAvailableSemaphores.reserve(m_framePacing.framesInFlight);
+    m_renderFinishedSemaphores.reserve(m_framePacing.framesInFlight);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
     VkDevice device = *m_device;
 
-    for (auto i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (uint32_t i = 0; i < m_framePacing.framesInFlight; ++i) {
       m_imageAvailableSemaphores.emplace_back(device, semaphoreInfo);
       m_renderFinishedSemaphores.emplace_back(device, semaphoreInfo);
-      m_inFlightFences.emplace_back(device, fenceInfo);
     }
   }
 
   void drawFrame() {
-    VkFence inFlightFence = m_inFlightFences[m_currentFrame];
+    PROFILE_FUNCTION();
+
+    if (m_pendingFramePacing) {
+      applyFramePacing();
+    }
+
     VkSemaphore imageAvailableSemaphore =
         m_imageAvailableSemaphores[m_currentFrame];
-    VkSwapchainKHR swapChain = *m_swapChain;
     VkDevice device = *m_device;
-    VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+    const std::vector<VkCommandBuffer>& commandBuffers =
+        m_commandBuffers[m_currentFrame];
     VkSemaphore renderFinishedSemaphore =
         m_renderFinishedSemaphores[m_currentFrame];
 
-    vkWaitForFences(device, 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+    {
+      PROFILE_SCOPE("wait for frame");
+      m_graphicsTimeline->wait(m_frameTimelineValues[m_currentFrame]);
+
+      if (m_computeTimeline) {
+        m_computeTimeline->wait(m_frameComputeTimelineValues[m_currentFrame]);
+      }
+    }
 
-    uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(
-        device,
-        swapChain,
-        UINT64_MAX,
-        imageAvailableSemaphore,
-        VK_NULL_HANDLE,
-        &imageIndex
+    m_deletionQueue.collect(
+        {m_graphicsTimeline->getCompletedValue(),
+         m_computeTimeline ? m_computeTimeline->getCompletedValue() : 0}
     );
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-      recreateSwapChain();
-      return;
-    } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-      ABORT_ON_FAIL(result, "Failed to acquire swap chain image");
+    m_gpuProfiler->beginFrame(m_currentFrame);
+    updateAntiAliasing();
+    updateRenderScale();
+
+    // Each frame in flight owns one offscreen image
+    uint32_t imageIndex = m_currentFrame;
+
+    if (!m_headless) {
+      VkResult result = vkAcquireNextImageKHR(
+          device,
+          *m_swapChain,
+          UINT64_MAX,
+          imageAvailableSemaphore,
+          VK_NULL_HANDLE,
+          &imageIndex
+      );
+
+      if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        recreateSwapChain();
+        return;
+      } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        ABORT_ON_FAIL(result, "Failed to acquire swap chain image");
+      }
     }
 
-    updateUniformBuffer(m_currentFrame);
+    updateFrameDescriptors(m_currentFrame);
 
-    vkResetFences(device, 1, &inFlightFence);
+    m_pipelineCache->update();
+    reloadShaders();
 
-    vkResetCommandBuffer(
-        commandBuffer,
-        /*VkCommandBufferResetFlagBits*/ 0
-    );
-    recordCommandBuffer(commandBuffer, imageIndex);
+    if (auto retired = m_pipelineCache->takeRetired(); !retired.empty()) {
+      retire(std::move(retired));
+    }
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    // The draws CPU occlusion culling records depend on the camera, which
+    // then has to be latched first
+    if (m_softwareOcclusion) {
+      latchCamera();
+      cullChunksOnCpu();
+    }
+
+    m_imageIndex = imageIndex;
+    m_frameGraph->setImage(m_frameTarget, m_swapChainImages[imageIndex]);
+    m_frameGraph->setBuffer(m_frameUniforms, *m_uniformBuffers[m_currentFrame]);
+
+    if (m_occlusionCulling) {
+      m_frameGraph->setBuffer(m_visibleDraws, getVisibleDrawBuffer());
+      m_frameGraph->setBuffer(m_disoccludedDraws, *m_disoccludedDrawBuffer);
+    }
+
+    for (size_t batch = 0; batch < commandBuffers.size(); ++batch) {
+      vkResetCommandBuffer(
+          commandBuffers[batch],
+          /*VkCommandBufferResetFlagBits*/ 0
+      );
+      recordCommandBuffer(commandBuffers[batch], batch);
+    }
+
+    // The uniform buffer is only read once the submission executes, so the
+    // camera can be written after recording
+    if (!m_softwareOcclusion) {
+      latchCamera();
+    }
+    updateUniformBuffer(m_currentFrame);
 
     VkSemaphore waitSemaphores[] = {imageAvailableSemaphore};
     VkPipelineStageFlags waitStages[] = {
         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    VkSemaphore signalSemaphores[] = {renderFinishedSemaphore};
 
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
+    // A semaphore wait only covers its own batch, so the acquire is waited
+    // for by the batch drawing to the image
+    size_t acquireBatch = m_frameGraph->getFirstBatch(m_frameTarget);
+    const auto& batches = m_frameGraph->getBatches();
+    std::vector<uint64_t> batchValues(batches.size());
+
+    for (size_t batch = 0; batch < batches.size(); ++batch) {
+      bool asyncCompute = batches[batch].asyncCompute;
+      bool lastBatch = batch + 1 == batches.size();
+
+      VkSubmitInfo submitInfo{};
+      submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+      // Offscreen images are neither acquired nor presented, so there are no
+      // semaphores to wait on or signal
+      if (!m_headless && batch == acquireBatch) {
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = waitSemaphores;
+        submitInfo.pWaitDstStageMask = waitStages;
+      }
 
-    VkSemaphore signalSemaphores[] = {renderFinishedSemaphore};
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
+      submitInfo.commandBufferCount = 1;
+      submitInfo.pCommandBuffers = &commandBuffers[batch];
 
-    ABORT_ON_FAIL(
-        vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, inFlightFence),
-        "Failed to submit draw command buffer"
-    );
+      if (!m_headless && lastBatch) {
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = signalSemaphores;
+      }
+
+      TimelineSemaphore& timeline =
+          asyncCompute ? *m_computeTimeline : *m_graphicsTimeline;
+      std::vector<TimelineSemaphore::Wait> waits;
+
+      if (const auto& wait = batches[batch].wait) {
+        const TimelineSemaphore* otherTimeline =
+            asyncCompute ? m_graphicsTimeline.get() : m_computeTimeline.get();
+        uint64_t waitValue = otherTimeline->getLastSubmittedValue();
+
+        // A graph executed for the first time has no values of its own, the
+        // previous graph's last submission on the other queue covers its
+        // batches
+        if (!wait->previousExecution) {
+          waitValue = batchValues[wait->batch];
+        } else if (!m_batchTimelineValues.empty()) {
+          waitValue = m_batchTimelineValues[wait->batch];
+        }
+
+        if (waitValue > 0) {
+          waits.push_back({otherTimeline, waitValue, wait->stages});
+        }
+      }
+
+      batchValues[batch] = timeline.submit(submitInfo, waits);
+
+      if (asyncCompute) {
+        m_frameComputeTimelineValues[m_currentFrame] = batchValues[batch];
+      }
+    }
+
+    // The last batch is on the graphics queue
+    m_frameTimelineValues[m_currentFrame] = batchValues.back();
+    m_batchTimelineValues = std::move(batchValues);
+
+    if (m_headless) {
+      if (m_benchmark) {
+        m_benchmark->recordPresent();
+      }
+
+      return;
+    }
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -1613,13 +3524,18 @@ class Application {
     presentInfo.waitSemaphoreCount = 1;
     presentInfo.pWaitSemaphores = signalSemaphores;
 
-    VkSwapchainKHR swapChains[] = {swapChain};
+    VkSwapchainKHR swapChains[] = {*m_swapChain};
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = swapChains;
 
     presentInfo.pImageIndices = &imageIndex;
 
-    result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+    VkResult result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+    recordInputAge();
+
+    if (m_benchmark) {
+      m_benchmark->recordPresent();
+    }
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
         m_framebufferResized) {
@@ -1631,36 +3547,265 @@ class Application {
   }
 
   void cleanupSwapChain() {
-    m_colorImageView.reset();
-    m_colorImage.reset();
-    m_colorImageMemory.reset();
-
-    m_depthImageView.reset();
-    m_depthImage.reset();
-    m_depthImageMemory.reset();
+    m_depthFrameBuffer.reset();
     m_swapChainFrameBuffers.clear();
+    m_postFrameBuffers.clear();
+    m_frameGraph.reset();
     m_swapChainImageViews.clear();
     m_swapChain.reset();
+    m_offscreenImages.clear();
+    m_offscreenImagesMemory.clear();
   }
 
   void recreateSwapChain() {
-    int width, height;
-    glfwGetFramebufferSize(*m_window, &width, &height);
-
-    while (width == 0 || height == 0) {
+    if (!m_headless) {
+      int width, height;
       glfwGetFramebufferSize(*m_window, &width, &height);
-      glfwWaitEvents();
+
+      while (width == 0 || height == 0) {
+        glfwGetFramebufferSize(*m_window, &width, &height);
+        glfwWaitEvents();
+      }
     }
 
-    vkDeviceWaitIdle(*m_device);
+    // Frames in flight may still use the old resources, so they are retired
+    // instead of destroyed, users before the resources they use
+    retire(std::move(m_depthFrameBuffer));
+    retire(std::move(m_swapChainFrameBuffers));
+    retire(std::move(m_postFrameBuffers));
+    retire(std::move(m_swapChainImageViews));
+    retire(std::move(m_offscreenImages));
+    retire(std::move(m_offscreenImagesMemory));
+    m_swapChainFrameBuffers.clear();
+    m_postFrameBuffers.clear();
+    m_swapChainImageViews.clear();
+    m_offscreenImages.clear();
+    m_offscreenImagesMemory.clear();
 
-    cleanupSwapChain();
+    std::unique_ptr<SwapChain> oldSwapChain = std::move(m_swapChain);
+    VkFormat previousFormat = m_swapChainImageFormat;
+
+    if (m_headless) {
+      createOffscreenImages();
+    } else {
+      createSwapChain(
+          oldSwapChain ? oldSwapChain->getHandle() : VK_NULL_HANDLE
+      );
+    }
+
+    retire(std::move(oldSwapChain));
 
-    createSwapChain();
     createImageViews();
-    createColorResources();
-    createDepthResources();
+
+    VkExtent2D attachmentExtent = getAttachmentExtent(m_swapChainExtent);
+
+    if (attachmentExtent.width != m_attachmentExtent.width ||
+        attachmentExtent.height != m_attachmentExtent.height ||
+        m_swapChainImageFormat != previousFormat) {
+      logAttachmentMemory();
+      retire(std::move(m_frameGraph));
+
+      m_attachmentExtent = attachmentExtent;
+      createFrameGraph();
+    }
+
+    createFrameBuffers();
+  }
+
+  /**
+   * Destroys the resource once the work submitted so far finished on both
+   * queues. Async compute batches that no graphics batch waits for, like the
+   * depth pyramid built for the next frame, may still use it after the
+   * graphics queue is done.
+   */
+  template <typename T>
+  void retire(T resource) {
+    m_deletionQueue.push(
+        {m_graphicsTimeline->getLastSubmittedValue(),
+         m_computeTimeline ? m_computeTimeline->getLastSubmittedValue() : 0},
+        std::move(resource)
+    );
+  }
+
+  static double toMiB(VkDeviceSize bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+  }
+
+  /**
+   * Footprint of the attachments at the current size and anti-aliasing tier,
+   * per memory block of the frame graph. Lazily allocated memory grows on
+   * use, so this is meaningful once frames were rendered with them.
+   */
+  AttachmentMemory getAttachmentMemory() {
+    AttachmentMemory total;
+
+    for (const auto& block : m_frameGraph->getMemoryBlocks()) {
+      VkDeviceSize committed = block.size;
+
+      if (block.lazy) {
+        vkGetDeviceMemoryCommitment(*m_device, *block.memory, &committed);
+      }
+
+      total.size += block.size;
+      total.committed += committed;
+
+      if (!total.summary.empty()) {
+        total.summary += ", ";
+      }
+
+      total.summary +=
+          fmt::format("{} {:.1f} MiB", block.name, toMiB(block.size));
+
+      if (block.lazy) {
+        total.summary +=
+            fmt::format(" (lazy, {:.1f} MiB committed)", toMiB(committed));
+      }
+    }
+
+    return total;
+  }
+
+  void logAttachmentMemory() {
+    AttachmentMemory memory = getAttachmentMemory();
+
+    SPDLOG_INFO(
+        "Attachment memory at {}x{} with {}: {:.1f} MiB, {:.1f} MiB committed "
+        "({})",
+        m_attachmentExtent.width,
+        m_attachmentExtent.height,
+        AntiAliasing::toString(m_antiAliasing),
+        toMiB(memory.size),
+        toMiB(memory.committed),
+        memory.summary
+    );
+  }
+
+  static VkExtent2D getAttachmentExtent(VkExtent2D extent) {
+    auto roundUp = [](uint32_t size) {
+      constexpr uint32_t granularity = Config::ATTACHMENT_SIZE_GRANULARITY;
+      return (size + granularity - 1) / granularity * granularity;
+    };
+
+    return {roundUp(extent.width), roundUp(extent.height)};
+  }
+
+  /**
+   * Switches the pacing between frames. Every per frame resource is sized by
+   * framesInFlight and the swap chain bakes in the image count and present
+   * mode, so all of them are rebuilt once the device is idle.
+   */
+  void applyFramePacing() {
+    vkDeviceWaitIdle(*m_device);
+    m_deletionQueue.flush();
+
+    m_framePacing = std::move(*m_pendingFramePacing);
+    m_pendingFramePacing.reset();
+
+    freeCommandBuffers();
+
+    m_imageAvailableSemaphores.clear();
+    m_renderFinishedSemaphores.clear();
+    m_frameDescriptorAllocators.clear();
+    m_uniformBuffers.clear();
+    m_uniformBuffersMemory.clear();
+
+    createUniformBuffers();
+    createDescriptorAllocators();
+    createCommandBuffers();
+    createSyncObjects();
+
+    m_currentFrame = 0;
+
+    recreateSwapChain();
+  }
+
+  /**
+   * Picks up a tier change requested by the governor or the user
+   */
+  void updateAntiAliasing() {
+    if (m_antiAliasingGovernor) {
+      // Timings of the frame that last used this slot
+      if (auto frameTime = m_gpuProfiler->getLatest("frame")) {
+        if (auto mode = m_antiAliasingGovernor->update(*frameTime)) {
+          m_pendingAntiAliasing = mode;
+        }
+      }
+    }
+
+    if (m_pendingAntiAliasing) {
+      applyAntiAliasing(*m_pendingAntiAliasing);
+      m_pendingAntiAliasing.reset();
+    }
+  }
+
+  /**
+   * Picks the render extent of the frame. Only the viewport changes with the
+   * scale, the attachments are sized for the full swap chain extent.
+   */
+  void updateRenderScale() {
+    if (m_dynamicResolution) {
+      if (auto frameTime = m_gpuProfiler->getLatest("frame")) {
+        m_renderScale = m_dynamicResolution->update(*frameTime);
+      }
+    }
+
+    m_renderExtent =
+        DynamicResolution::scaleExtent(m_swapChainExtent, m_renderScale);
+  }
+
+  /**
+   * Switches the anti-aliasing tier between frames. The whole frame graph is
+   * rebuilt, so all of its attachments are recreated and not only those whose
+   * sample count changed, along with the render passes and framebuffers
+   * referring to them. Pipelines for the new tier come from the pipeline
+   * cache, and everything replaced is retired.
+   */
+  void applyAntiAliasing(AntiAliasingMode mode) {
+    if (mode == m_antiAliasing) {
+      return;
+    }
+
+    logAttachmentMemory();
+
+    m_antiAliasing = mode;
+    m_msaaSamples = AntiAliasing::getSampleCount(mode);
+
+    retire(std::move(m_depthFrameBuffer));
+    retire(std::move(m_swapChainFrameBuffers));
+    retire(std::move(m_postFrameBuffers));
+    m_swapChainFrameBuffers.clear();
+    m_postFrameBuffers.clear();
+
+    retire(std::move(m_frameGraph));
+    createFrameGraph();
+
+    if (!m_dynamicRendering) {
+      retire(std::move(m_renderPass));
+      retire(std::move(m_depthRenderPass));
+      retire(std::move(m_depthLoadRenderPass));
+      retire(std::move(m_postRenderPass));
+      createRenderPass();
+    }
+
     createFrameBuffers();
+    updatePipelineKeys();
+
+    if (m_antiAliasingGovernor) {
+      m_antiAliasingGovernor->reset(mode);
+    }
+
+    SPDLOG_INFO("Anti-aliasing {}", AntiAliasing::toString(mode));
+  }
+
+  void cycleAntiAliasing() {
+    const auto& modes = m_supportedAntiAliasing;
+    auto it = std::find(modes.begin(), modes.end(), m_antiAliasing);
+
+    if (it == modes.end() || ++it == modes.end()) {
+      it = modes.begin();
+    }
+
+    m_pendingAntiAliasing = *it;
   }
 
   static void framebufferResizeCallback(
@@ -1679,13 +3824,36 @@ class Application {
     bool isCameraActive =
         button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS;
 
-    app->m_camera->setActive(isCameraActive);
+    app->m_cameraActive = isCameraActive;
     auto cursorState =
         isCameraActive ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL;
 
     glfwSetInputMode(*app->m_window, GLFW_CURSOR, cursorState);
   }
 
+  static void keyCallback(
+      GLFWwindow* window,
+      int key,
+      [[maybe_unused]] int scancode,
+      int action,
+      [[maybe_unused]] int mods
+  ) {
+    if (action != GLFW_PRESS) {
+      return;
+    }
+
+    auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+    if (key >= GLFW_KEY_F1 && key <= GLFW_KEY_F4) {
+      auto policy = static_cast<FramePacingPolicy>(key - GLFW_KEY_F1);
+      app->m_pendingFramePacing = FramePacing::fromPolicy(policy);
+    } else if (key == GLFW_KEY_F5) {
+      app->cycleAntiAliasing();
+    } else if (key == GLFW_KEY_F12) {
+      app->m_traceRequested = true;
+    }
+  }
+
   void createDescriptorSetLayout() {
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding = 0;
@@ -1693,16 +3861,15 @@ class Application {
     uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-    samplerLayoutBinding.binding = 1;
-    samplerLayoutBinding.descriptorCount = 1;
-    samplerLayoutBinding.descriptorType =
+    VkDescriptorSetLayoutBinding sceneColorLayoutBinding{};
+    sceneColorLayoutBinding.binding = 1;
+    sceneColorLayoutBinding.descriptorCount = 1;
+    sceneColorLayoutBinding.descriptorType =
         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerLayoutBinding.pImmutableSamplers = nullptr;
-    samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    sceneColorLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
     std::array<VkDescriptorSetLayoutBinding, 2> bindings = {
-        uboLayoutBinding, samplerLayoutBinding};
+        uboLayoutBinding, sceneColorLayoutBinding};
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
@@ -1710,23 +3877,25 @@ class Application {
 
     m_descriptorSetLayout =
         std::make_unique<DescriptorSetLayout>(*m_device, layoutInfo);
-  }
 
-  void updateUniformBuffer(uint32_t currentImage) {
-    float aspect =
-        (float)m_swapChainExtent.width / (float)m_swapChainExtent.height;
+    uint32_t textureCapacity = std::min(
+        Config::MAX_BINDLESS_TEXTURES,
+        BindlessTextureTable::getMaxCapacity(m_physicalDevice)
+    );
 
-    float fov = glm::radians(45.0f);
+    m_textureTable =
+        std::make_unique<BindlessTextureTable>(*m_device, textureCapacity);
+  }
 
-    UniformBufferObject ubo{};
-    ubo.model = glm::mat4(1.0f);
-    ubo.view = m_camera->getViewMatrix();
-    ubo.proj = glm::perspective(fov, aspect, 0.1f, 10.0f);
+  void updateUniformBuffer(uint32_t currentImage) {
+    PROFILE_FUNCTION();
 
-    // Prevent image to be rendered upside down
-    ubo.proj[1][1] *= -1;
+    auto ubo = UniformBufferObject::create(
+        m_cameraState.getViewMatrix(), m_swapChainExtent
+    );
 
     memcpy(m_uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+    m_previousViewProjection = ubo.proj * ubo.view * ubo.model;
   }
 
   VkCommandBuffer beginSingleTimeCommands() {
@@ -1756,95 +3925,20 @@ class Application {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_graphicsQueue);
+    m_graphicsTimeline->wait(m_graphicsTimeline->submit(submitInfo));
 
     vkFreeCommandBuffers(*m_device, *m_commandPool, 1, &commandBuffer);
   }
 
-  void transitionImageLayout(
-      VkImage image,
-      VkFormat format,
-      VkImageLayout oldLayout,
-      VkImageLayout newLayout,
-      uint32_t mipLevels
-  ) {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = mipLevels;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED &&
-        newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-      barrier.srcAccessMask = 0;
-      barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-      sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-      destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-      sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-      destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    } else {
-      ABORT("Unsupported layout transition");
-    }
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        sourceStage,
-        destinationStage,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
-        1,
-        &barrier
-    );
-
-    endSingleTimeCommands(commandBuffer);
-  }
-
-  VkSampleCountFlagBits getMaxUsableSampleCount() {
-    static constexpr std::array samples{
-        VK_SAMPLE_COUNT_64_BIT,
-        VK_SAMPLE_COUNT_32_BIT,
-        VK_SAMPLE_COUNT_16_BIT,
-        VK_SAMPLE_COUNT_8_BIT,
-        VK_SAMPLE_COUNT_4_BIT,
-        VK_SAMPLE_COUNT_2_BIT,
-        VK_SAMPLE_COUNT_1_BIT,
-    };
-
+  /**
+   * Sample counts usable for both the color and the depth attachment
+   */
+  VkSampleCountFlags getUsableSampleCounts() {
     VkPhysicalDeviceProperties physicalDeviceProperties;
     vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
 
-    VkSampleCountFlags counts =
-        physicalDeviceProperties.limits.framebufferColorSampleCounts &
-        physicalDeviceProperties.limits.framebufferDepthSampleCounts;
-
-    for (const auto& sample : samples) {
-      if (counts & sample) {
-        return sample;
-      }
-    }
-
-    return VK_SAMPLE_COUNT_1_BIT;
+    return physicalDeviceProperties.limits.framebufferColorSampleCounts &
+           physicalDeviceProperties.limits.framebufferDepthSampleCounts;
   }
 };
 
@@ -0,0 +1,142 @@
+#include "AntiAliasing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace engine {
+namespace {
+constexpr std::array<std::pair<std::string_view, AntiAliasingMode>, 5>
+    MODE_NAMES = {{
+        {"off", AntiAliasingMode::Off},
+        {"fxaa", AntiAliasingMode::Fxaa},
+        {"msaa2", AntiAliasingMode::Msaa2},
+        {"msaa4", AntiAliasingMode::Msaa4},
+        {"msaa8", AntiAliasingMode::Msaa8},
+    }};
+
+/**
+ * Frames averaged for every decision
+ */
+constexpr std::size_t DECISION_WINDOW = 60;
+
+/**
+ * Above target * DOWNGRADE_THRESHOLD the tier goes down, below
+ * target * UPGRADE_THRESHOLD it goes up
+ */
+constexpr double DOWNGRADE_THRESHOLD = 1.05;
+constexpr double UPGRADE_THRESHOLD = 0.7;
+
+constexpr uint32_t INITIAL_UPGRADE_BACKOFF = 300;
+constexpr uint32_t MAX_UPGRADE_BACKOFF = 300 * 16;
+}  // namespace
+
+VkSampleCountFlagBits AntiAliasing::getSampleCount(AntiAliasingMode mode) {
+  switch (mode) {
+    case AntiAliasingMode::Msaa2:
+      return VK_SAMPLE_COUNT_2_BIT;
+    case AntiAliasingMode::Msaa4:
+      return VK_SAMPLE_COUNT_4_BIT;
+    case AntiAliasingMode::Msaa8:
+      return VK_SAMPLE_COUNT_8_BIT;
+    default:
+      return VK_SAMPLE_COUNT_1_BIT;
+  }
+}
+
+bool AntiAliasing::isPostProcess(AntiAliasingMode mode) {
+  return mode == AntiAliasingMode::Fxaa;
+}
+
+std::vector<AntiAliasingMode> AntiAliasing::getSupportedModes(
+    VkSampleCountFlags sampleCounts
+) {
+  std::vector<AntiAliasingMode> modes;
+
+  for (const auto& [name, mode] : MODE_NAMES) {
+    if (sampleCounts & getSampleCount(mode)) {
+      modes.push_back(mode);
+    }
+  }
+
+  return modes;
+}
+
+std::optional<AntiAliasingMode> AntiAliasing::parse(std::string_view name) {
+  for (const auto& [modeName, mode] : MODE_NAMES) {
+    if (modeName == name) {
+      return mode;
+    }
+  }
+
+  return std::nullopt;
+}
+
+const char* AntiAliasing::toString(AntiAliasingMode mode) {
+  for (const auto& [modeName, candidate] : MODE_NAMES) {
+    if (candidate == mode) {
+      return modeName.data();
+    }
+  }
+
+  return "unknown";
+}
+
+AntiAliasingGovernor::AntiAliasingGovernor(
+    std::vector<AntiAliasingMode> modes,
+    AntiAliasingMode initialMode,
+    double targetFrameTime
+)
+    : m_modes(std::move(modes)),
+      m_targetFrameTime(targetFrameTime),
+      m_frameTimes(DECISION_WINDOW),
+      m_upgradeBackoff(INITIAL_UPGRADE_BACKOFF) {
+  reset(initialMode);
+}
+
+std::optional<AntiAliasingMode> AntiAliasingGovernor::update(
+    double frameTime
+) {
+  m_frameTimes.add(frameTime);
+
+  if (m_upgradeBlockedFrames > 0) {
+    --m_upgradeBlockedFrames;
+  }
+
+  if (m_frameTimes.count() < DECISION_WINDOW) {
+    return std::nullopt;
+  }
+
+  double average = m_frameTimes.average();
+
+  if (average > m_targetFrameTime * DOWNGRADE_THRESHOLD && m_current > 0) {
+    // The last upgrade did not fit, wait longer before trying again
+    if (m_upgraded) {
+      m_upgradeBackoff = std::min(2 * m_upgradeBackoff, MAX_UPGRADE_BACKOFF);
+    }
+
+    m_upgraded = false;
+    m_upgradeBlockedFrames = m_upgradeBackoff;
+    return step(m_current - 1);
+  }
+
+  if (average < m_targetFrameTime * UPGRADE_THRESHOLD &&
+      m_current + 1 < m_modes.size() && m_upgradeBlockedFrames == 0) {
+    m_upgraded = true;
+    return step(m_current + 1);
+  }
+
+  return std::nullopt;
+}
+
+void AntiAliasingGovernor::reset(AntiAliasingMode mode) {
+  auto it = std::find(m_modes.begin(), m_modes.end(), mode);
+  m_current = it != m_modes.end() ? it - m_modes.begin() : 0;
+  m_frameTimes = RollingStatistics(DECISION_WINDOW);
+}
+
+std::optional<AntiAliasingMode> AntiAliasingGovernor::step(std::size_t index) {
+  reset(m_modes[index]);
+  return m_modes[index];
+}
+}  // namespace engine
@@ -0,0 +1,93 @@
+#ifndef ANTI_ALIASING_HPP
+#define ANTI_ALIASING_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "Statistics.hpp"
+
+namespace engine {
+
+/**
+ * Anti-aliasing tiers, from cheapest to most expensive. MSAA shades once per
+ * pixel and only multiplies coverage and depth samples, FXAA is a single
+ * post-process pass over the resolved image.
+ */
+enum class AntiAliasingMode {
+  Off,
+  Fxaa,
+  Msaa2,
+  Msaa4,
+  Msaa8,
+};
+
+struct AntiAliasing {
+  static VkSampleCountFlagBits getSampleCount(AntiAliasingMode mode);
+
+  /**
+   * Whether the mode needs the scene in a sampled image for a post pass
+   */
+  static bool isPostProcess(AntiAliasingMode mode);
+
+  /**
+   * Modes whose sample count is in sampleCounts, cheapest first
+   */
+  static std::vector<AntiAliasingMode> getSupportedModes(
+      VkSampleCountFlags sampleCounts
+  );
+
+  static std::optional<AntiAliasingMode> parse(std::string_view name);
+
+  static const char* toString(AntiAliasingMode mode);
+};
+
+/**
+ * Steps the anti-aliasing tier down when GPU frame times exceed a target and
+ * back up when there is enough headroom. Every change is followed by a full
+ * window of fresh samples before the next decision. After stepping down, the
+ * next step up is held off, for twice as long whenever an earlier step up had
+ * to be taken back, so the tier does not oscillate between two neighbours.
+ */
+class AntiAliasingGovernor {
+ public:
+  /**
+   * @param modes tiers to choose from, cheapest first
+   * @param targetFrameTime in milliseconds
+   */
+  AntiAliasingGovernor(
+      std::vector<AntiAliasingMode> modes,
+      AntiAliasingMode initialMode,
+      double targetFrameTime
+  );
+
+  /**
+   * Feeds the GPU time of one frame in milliseconds
+   * @return the mode to switch to, if the tier should change
+   */
+  std::optional<AntiAliasingMode> update(double frameTime);
+
+  /**
+   * Follows a mode chosen elsewhere, e.g. by the user
+   */
+  void reset(AntiAliasingMode mode);
+
+ private:
+  std::vector<AntiAliasingMode> m_modes;
+  std::size_t m_current = 0;
+  double m_targetFrameTime;
+  RollingStatistics m_frameTimes;
+  uint32_t m_upgradeBackoff;
+  uint32_t m_upgradeBlockedFrames = 0;
+  bool m_upgraded = false;
+
+  std::optional<AntiAliasingMode> step(std::size_t index);
+};
+
+}  // namespace engine
+
+#endif  // ANTI_ALIASING_HPP
@@ -0,0 +1,136 @@
+#include "Benchmark.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "Json.hpp"
+
+namespace engine {
+namespace {
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+CameraPath createCameraPath(const BenchmarkSettings& settings) {
+  if (!settings.cameraPath.empty()) {
+    return CameraPath::load(settings.cameraPath);
+  }
+
+  // One revolution over the measured frames, the warmup overlaps its start
+  float period = std::max(settings.measuredFrames, 1u) * settings.timestep;
+  return CameraPath::orbit(glm::vec3(0.0f), 3.0f, 1.0f, period);
+}
+
+void writeStatistics(
+    std::ostream& out, const char* name, const RollingStatistics& statistics
+) {
+  out << ",\n  ";
+  writeJsonString(out, name);
+  out << ": {\"samples\": " << statistics.count()
+      << ", \"mean\": " << statistics.average()
+      << ", \"p50\": " << statistics.percentile(50.0)
+      << ", \"p95\": " << statistics.percentile(95.0)
+      << ", \"p99\": " << statistics.percentile(99.0)
+      << ", \"max\": " << statistics.max() << "}";
+}
+
+void logStatistics(const char* name, const RollingStatistics& statistics) {
+  SPDLOG_INFO(
+      "{}: mean {:.3f}ms, p50 {:.3f}ms, p95 {:.3f}ms, p99 {:.3f}ms, "
+      "max {:.3f}ms",
+      name,
+      statistics.average(),
+      statistics.percentile(50.0),
+      statistics.percentile(95.0),
+      statistics.percentile(99.0),
+      statistics.max()
+  );
+}
+}  // namespace
+
+Benchmark::Benchmark(BenchmarkSettings settings)
+    : m_settings(std::move(settings)),
+      m_cameraPath(createCameraPath(m_settings)),
+      m_cpuFrameTime(m_settings.measuredFrames),
+      m_presentInterval(m_settings.measuredFrames) {}
+
+bool Benchmark::beginFrame(uint64_t frame) {
+  bool measurementStarts = !m_measuring && frame >= m_settings.warmupFrames;
+
+  if (measurementStarts) {
+    SPDLOG_INFO(
+        "Benchmark warmup of {} frames done, measuring {} frames",
+        m_settings.warmupFrames,
+        m_settings.measuredFrames
+    );
+
+    m_measuring = true;
+    m_lastPresent.reset();
+  }
+
+  m_frameStart = Clock::now();
+
+  return measurementStarts;
+}
+
+void Benchmark::endFrame() {
+  if (m_measuring) {
+    m_cpuFrameTime.add(Milliseconds(Clock::now() - m_frameStart).count());
+  }
+}
+
+void Benchmark::recordPresent() {
+  auto now = Clock::now();
+
+  if (m_measuring && m_lastPresent) {
+    m_presentInterval.add(Milliseconds(now - *m_lastPresent).count());
+  }
+
+  m_lastPresent = now;
+}
+
+void Benchmark::writeReport(
+    const RollingStatistics* gpuFrameTime,
+    const std::vector<std::pair<std::string, std::string>>& properties
+) const {
+  logStatistics("CPU frame time", m_cpuFrameTime);
+  logStatistics("Present interval", m_presentInterval);
+
+  if (gpuFrameTime) {
+    logStatistics("GPU frame time", *gpuFrameTime);
+  }
+
+  std::ofstream out(m_settings.outputPath);
+
+  if (!out.is_open()) {
+    SPDLOG_ERROR(
+        "Failed to write benchmark report {}", m_settings.outputPath.string()
+    );
+    return;
+  }
+
+  out << std::fixed << std::setprecision(4);
+  out << "{\n  \"warmupFrames\": " << m_settings.warmupFrames
+      << ",\n  \"measuredFrames\": " << m_settings.measuredFrames
+      << ",\n  \"timestep\": " << m_settings.timestep;
+
+  for (const auto& [key, value] : properties) {
+    out << ",\n  ";
+    writeJsonString(out, key);
+    out << ": ";
+    writeJsonString(out, value);
+  }
+
+  writeStatistics(out, "cpuFrameTimeMs", m_cpuFrameTime);
+  writeStatistics(out, "presentIntervalMs", m_presentInterval);
+
+  if (gpuFrameTime) {
+    writeStatistics(out, "gpuFrameTimeMs", *gpuFrameTime);
+  }
+
+  out << "\n}\n";
+
+  SPDLOG_INFO("Wrote benchmark report to {}", m_settings.outputPath.string());
+}
+}  // namespace engine
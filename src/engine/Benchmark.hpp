@@ -0,0 +1,91 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CameraPath.hpp"
+#include "Statistics.hpp"
+
+namespace engine {
+
+struct BenchmarkSettings {
+  uint32_t warmupFrames = 100;
+
+  uint32_t measuredFrames = 1000;
+
+  /**
+   * Simulated seconds per frame, independent of the wall clock
+   */
+  float timestep = 1.0f / 60.0f;
+
+  std::filesystem::path outputPath = "benchmark.json";
+
+  /**
+   * Keyframe file for CameraPath::load, an orbit around the model if empty
+   */
+  std::filesystem::path cameraPath;
+};
+
+/**
+ * Runs a fixed number of warmup and measured frames along a camera path with
+ * a fixed timestep, so runs on different commits render the same frames, and
+ * writes frame time statistics of the measured frames as JSON.
+ */
+class Benchmark {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit Benchmark(BenchmarkSettings settings);
+
+  [[nodiscard]] const BenchmarkSettings& getSettings() const {
+    return m_settings;
+  }
+
+  [[nodiscard]] uint64_t getTotalFrames() const {
+    return uint64_t{m_settings.warmupFrames} + m_settings.measuredFrames;
+  }
+
+  [[nodiscard]] const CameraPath& getCameraPath() const { return m_cameraPath; }
+
+  [[nodiscard]] bool isMeasuring() const { return m_measuring; }
+
+  /**
+   * @return true for the first measured frame, the caller should settle any
+   * outstanding GPU work from the warmup before rendering it
+   */
+  bool beginFrame(uint64_t frame);
+
+  void endFrame();
+
+  /**
+   * Called whenever a frame is handed to the presentation engine, or to the
+   * queue when running headless
+   */
+  void recordPresent();
+
+  /**
+   * @param properties written to the report as strings, to identify the run
+   */
+  void writeReport(
+      const RollingStatistics* gpuFrameTime,
+      const std::vector<std::pair<std::string, std::string>>& properties
+  ) const;
+
+ private:
+  BenchmarkSettings m_settings;
+  CameraPath m_cameraPath;
+  bool m_measuring = false;
+  Clock::time_point m_frameStart;
+  std::optional<Clock::time_point> m_lastPresent;
+  RollingStatistics m_cpuFrameTime;
+  RollingStatistics m_presentInterval;
+};
+
+}  // namespace engine
+
+#endif  // BENCHMARK_HPP
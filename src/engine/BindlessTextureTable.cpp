@@ -0,0 +1,112 @@
+#include "BindlessTextureTable.hpp"
+
+#include <algorithm>
+
+namespace engine {
+BindlessTextureTable::BindlessTextureTable(VkDevice device, uint32_t capacity)
+    : m_device(device),
+      m_capacity(capacity) {
+  VkDescriptorSetLayoutBinding binding{};
+  binding.binding = 0;
+  binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  binding.descriptorCount = m_capacity;
+  binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorBindingFlags bindingFlags =
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+      VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+  bindingFlagsInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+  bindingFlagsInfo.bindingCount = 1;
+  bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.pNext = &bindingFlagsInfo;
+  layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+  layoutInfo.bindingCount = 1;
+  layoutInfo.pBindings = &binding;
+
+  m_layout = std::make_unique<DescriptorSetLayout>(m_device, layoutInfo);
+
+  VkDescriptorPoolSize poolSize{};
+  poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  poolSize.descriptorCount = m_capacity;
+
+  VkDescriptorPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 1;
+  poolInfo.pPoolSizes = &poolSize;
+
+  m_pool = std::make_unique<DescriptorPool>(m_device, poolInfo);
+
+  VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+  variableCountInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+  variableCountInfo.descriptorSetCount = 1;
+  variableCountInfo.pDescriptorCounts = &m_capacity;
+
+  VkDescriptorSetLayout layout = *m_layout;
+
+  VkDescriptorSetAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.pNext = &variableCountInfo;
+  allocInfo.descriptorPool = *m_pool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &layout;
+
+  ABORT_ON_FAIL(
+      vkAllocateDescriptorSets(m_device, &allocInfo, &m_set),
+      "Failed to allocate bindless texture table"
+  );
+
+  SPDLOG_DEBUG("Created bindless texture table for {} textures", m_capacity);
+}
+
+uint32_t BindlessTextureTable::add(VkImageView imageView, VkSampler sampler) {
+  if (m_count == m_capacity) {
+    ABORT("Bindless texture table is full ({} textures)", m_capacity);
+  }
+
+  VkDescriptorImageInfo imageInfo{};
+  imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  imageInfo.imageView = imageView;
+  imageInfo.sampler = sampler;
+
+  // Array slots are written one at a time, which a template with its fixed
+  // dstArrayElement cannot express
+  VkWriteDescriptorSet descriptorWrite{};
+  descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrite.dstSet = m_set;
+  descriptorWrite.dstBinding = 0;
+  descriptorWrite.dstArrayElement = m_count;
+  descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  descriptorWrite.descriptorCount = 1;
+  descriptorWrite.pImageInfo = &imageInfo;
+
+  vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
+
+  return m_count++;
+}
+
+uint32_t BindlessTextureTable::getMaxCapacity(VkPhysicalDevice physicalDevice) {
+  VkPhysicalDeviceVulkan12Properties properties12{};
+  properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+  VkPhysicalDeviceProperties2 properties{};
+  properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties.pNext = &properties12;
+
+  vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+  return std::min(
+      properties12.maxPerStageDescriptorUpdateAfterBindSamplers,
+      properties12.maxPerStageDescriptorUpdateAfterBindSampledImages
+  );
+}
+}  // namespace engine
@@ -0,0 +1,45 @@
+#ifndef BINDLESS_TEXTURE_TABLE_HPP
+#define BINDLESS_TEXTURE_TABLE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * One descriptor set holding every texture in a single partially bound,
+ * update-after-bind array. It is bound once per command buffer and shaders
+ * pick their texture by index, usually passed in a push constant.
+ */
+class BindlessTextureTable {
+ public:
+  BindlessTextureTable(VkDevice device, uint32_t capacity);
+
+  /**
+   * @return the index the shader uses to sample the texture
+   */
+  uint32_t add(VkImageView imageView, VkSampler sampler);
+
+  [[nodiscard]] const DescriptorSetLayout& getLayout() const {
+    return *m_layout;
+  }
+
+  [[nodiscard]] VkDescriptorSet getSet() const { return m_set; }
+
+  static uint32_t getMaxCapacity(VkPhysicalDevice physicalDevice);
+
+ private:
+  VkDevice m_device;
+  uint32_t m_capacity;
+  uint32_t m_count = 0;
+  std::unique_ptr<DescriptorSetLayout> m_layout;
+  std::unique_ptr<DescriptorPool> m_pool;
+  VkDescriptorSet m_set = VK_NULL_HANDLE;
+};
+
+}  // namespace engine
+
+#endif  // BINDLESS_TEXTURE_TABLE_HPP
@@ -1,16 +1,54 @@
 #include "Camera.hpp"
 
 namespace engine {
+namespace {
+glm::vec3 getFront(float yaw, float pitch) {
+  constexpr auto rad = glm::radians<double>;
+
+  glm::vec3 front;
+  front.x = static_cast<float>(cos(rad(yaw)) * cos(rad(pitch)));
+  front.y = static_cast<float>(sin(rad(pitch)));
+  front.z = static_cast<float>(sin(rad(yaw)) * cos(rad(pitch)));
+  return glm::normalize(front);
+}
+}  // namespace
+
+glm::mat4 CameraState::getViewMatrix() const {
+  return glm::lookAt(position, position + front, up);
+}
+
+CameraState CameraState::interpolate(
+    const CameraState &a, const CameraState &b, float t
+) {
+  CameraState state;
+  state.position = glm::mix(a.position, b.position, t);
+  state.up = glm::normalize(glm::mix(a.up, b.up, t));
+
+  // Opposite directions only happen across a lookAt jump, snap instead
+  glm::vec3 front = glm::mix(a.front, b.front, t);
+  state.front = glm::length(front) > 1e-4f ? glm::normalize(front) : b.front;
+
+  return state;
+}
+
 Camera::Camera(GLFWwindow *window) : window(window) {
-  int windowWidth, windowHeight;
-  glfwGetWindowSize(window, &windowWidth, &windowHeight);
+  int windowWidth = 0, windowHeight = 0;
+
+  // Headless runs have no window and never activate the camera
+  if (window) {
+    glfwGetWindowSize(window, &windowWidth, &windowHeight);
+  }
 
   lastX = static_cast<float>(windowWidth) / 2.0f;
   lastY = static_cast<float>(windowHeight) / 2.0f;
 }
 
 glm::mat4 Camera::getViewMatrix() const {
-  return glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+  return getState().getViewMatrix();
+}
+
+CameraState Camera::getState() const {
+  return {cameraPos, cameraFront, cameraUp};
 }
 
 void Camera::update(float deltaTime) {
@@ -18,8 +56,7 @@ void Camera::update(float deltaTime) {
     return;
   }
 
-  move(deltaTime);
-  updateVectors(deltaTime);
+  apply(readInput(), deltaTime);
 }
 
 void Camera::setActive(bool active) {
@@ -30,41 +67,55 @@ void Camera::setActive(bool active) {
   }
 }
 
-void Camera::move(float deltaTime) {
-  float speedMultiplier = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) ? 3.0 : 1.0f;
+void Camera::lookAt(const glm::vec3 &position, const glm::vec3 &target) {
+  cameraPos = position;
+  cameraFront = glm::normalize(target - position);
 
-  const float cameraSpeed = speed * deltaTime * speedMultiplier;
-
-  if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
-    cameraPos -= cameraSpeed * cameraUp;
+  // Keep the angles in sync, so mouse look continues from the new direction
+  pitch = glm::degrees(std::asin(cameraFront.y));
+  yaw = glm::degrees(std::atan2(cameraFront.z, cameraFront.x));
+}
 
-  if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
-    cameraPos += cameraSpeed * cameraUp;
+CameraInput Camera::readInput() const {
+  auto axis = [this](int positiveKey, int negativeKey) {
+    return static_cast<float>(glfwGetKey(window, positiveKey) == GLFW_PRESS) -
+           static_cast<float>(glfwGetKey(window, negativeKey) == GLFW_PRESS);
+  };
 
-  if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-    cameraPos += cameraSpeed * cameraFront;
+  CameraInput input;
+  input.movement = {
+      axis(GLFW_KEY_D, GLFW_KEY_A),
+      axis(GLFW_KEY_E, GLFW_KEY_Q),
+      axis(GLFW_KEY_W, GLFW_KEY_S)};
+  input.fast = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
 
-  if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-    cameraPos -= cameraSpeed * cameraFront;
+  double x, y;
+  glfwGetCursorPos(window, &x, &y);
+  input.cursor = {static_cast<float>(x), static_cast<float>(y)};
 
-  if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-    cameraPos -=
-        glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+  return input;
+}
 
-  if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-    cameraPos +=
-        glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+void Camera::apply(const CameraInput &input, float deltaTime) {
+  move(input, deltaTime);
+  updateVectors(input, deltaTime);
 }
 
-void Camera::updateVectors(float deltaTime) {
-  float mouseX, mouseY;
+void Camera::move(const CameraInput &input, float deltaTime) {
+  float speedMultiplier = input.fast ? 3.0 : 1.0f;
 
-  {
-    double x, y;
-    glfwGetCursorPos(window, &x, &y);
-    mouseX = static_cast<float>(x);
-    mouseY = static_cast<float>(y);
-  }
+  const float cameraSpeed = speed * deltaTime * speedMultiplier;
+
+  glm::vec3 right = glm::normalize(glm::cross(cameraFront, cameraUp));
+
+  cameraPos += cameraSpeed * (input.movement.x * right +
+                              input.movement.y * cameraUp +
+                              input.movement.z * cameraFront);
+}
+
+void Camera::updateVectors(const CameraInput &input, float deltaTime) {
+  float mouseX = input.cursor.x;
+  float mouseY = input.cursor.y;
 
   if (firstMouse) {
     lastX = mouseX;
@@ -83,12 +134,22 @@ void Camera::updateVectors(float deltaTime) {
   yaw += xOffset;
   pitch = std::clamp(pitch + yOffset, -89.0f, 89.0f);
 
-  constexpr auto rad = glm::radians<double>;
+  cameraFront = getFront(yaw, pitch);
+}
 
-  glm::vec3 front;
-  front.x = static_cast<float>(cos(rad(yaw)) * cos(rad(pitch)));
-  front.y = static_cast<float>(sin(rad(pitch)));
-  front.z = static_cast<float>(sin(rad(yaw)) * cos(rad(pitch)));
-  cameraFront = glm::normalize(front);
+CameraState Camera::turn(
+    const CameraState &state, glm::vec2 offset, float deltaTime
+) const {
+  float stateYaw = glm::degrees(std::atan2(state.front.z, state.front.x));
+  float statePitch = glm::degrees(std::asin(state.front.y));
+
+  stateYaw += offset.x * sensitivity * deltaTime;
+  statePitch = std::clamp(
+      statePitch - offset.y * sensitivity * deltaTime, -89.0f, 89.0f
+  );
+
+  CameraState turned = state;
+  turned.front = getFront(stateYaw, statePitch);
+  return turned;
 }
 }  // namespace engine
@@ -9,16 +9,76 @@
 
 namespace engine {
 
+/**
+ * Keyboard and mouse state driving the camera for one update
+ */
+struct CameraInput {
+  /**
+   * Requested movement along the camera's right, up and front axes, each
+   * component in the range [-1, 1]
+   */
+  glm::vec3 movement = glm::vec3(0.0f);
+  bool fast = false;
+  glm::vec2 cursor = glm::vec2(0.0f);
+};
+
+/**
+ * Position and orientation of the camera at one point in time
+ */
+struct CameraState {
+  glm::vec3 position = glm::vec3(0.0f);
+  glm::vec3 front = glm::vec3(0.0f, 0.0f, -1.0f);
+  glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+
+  [[nodiscard]] glm::mat4 getViewMatrix() const;
+
+  /**
+   * Blends from a at t = 0 to b at t = 1
+   */
+  static CameraState interpolate(
+      const CameraState& a, const CameraState& b, float t
+  );
+};
+
 class Camera {
  public:
   explicit Camera(GLFWwindow* window);
 
   [[nodiscard]] glm::mat4 getViewMatrix() const;
 
+  [[nodiscard]] CameraState getState() const;
+
+  /**
+   * Reads the input from the window and applies it, if the camera is active
+   */
   void update(float deltaTime);
 
+  /**
+   * Only reads the window, so it may run while another thread applies input
+   */
+  [[nodiscard]] CameraInput readInput() const;
+
+  /**
+   * Moves and turns the camera, only touches the camera itself
+   */
+  void apply(const CameraInput& input, float deltaTime);
+
+  /**
+   * state turned the way apply() turns the camera when the cursor moves by
+   * offset. Only reads settings, so it may run while another thread applies
+   * input.
+   */
+  [[nodiscard]] CameraState turn(
+      const CameraState& state, glm::vec2 offset, float deltaTime
+  ) const;
+
   void setActive(bool active);
 
+  /**
+   * Places the camera at position, facing target
+   */
+  void lookAt(const glm::vec3& position, const glm::vec3& target);
+
  private:
   GLFWwindow* window;
   glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 3.0f);
@@ -33,9 +93,9 @@ class Camera {
   float speed = 1.0f;
   bool m_active = false;
 
-  void move(float deltaTime);
+  void move(const CameraInput& input, float deltaTime);
 
-  void updateVectors(float deltaTime);
+  void updateVectors(const CameraInput& input, float deltaTime);
 };
 
 }  // namespace engine
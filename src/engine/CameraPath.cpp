@@ -0,0 +1,174 @@
+#include "CameraPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <glm/gtc/constants.hpp>
+#include <sstream>
+#include <string>
+
+#include "Abort.hpp"
+
+namespace engine {
+namespace {
+glm::vec3 catmullRom(
+    const glm::vec3& p0,
+    const glm::vec3& p1,
+    const glm::vec3& p2,
+    const glm::vec3& p3,
+    float t
+) {
+  float t2 = t * t;
+  float t3 = t2 * t;
+
+  return 0.5f * ((2.0f * p1) + (-p0 + p2) * t +
+                 (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                 (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+}
+}  // namespace
+
+CameraPath::CameraPath(std::vector<Keyframe> keyframes, bool looped)
+    : m_keyframes(std::move(keyframes)),
+      m_looped(looped) {
+  if (m_keyframes.empty()) {
+    ABORT("A camera path needs at least one keyframe");
+  }
+
+  std::stable_sort(
+      m_keyframes.begin(),
+      m_keyframes.end(),
+      [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; }
+  );
+
+  m_duration = m_keyframes.back().time;
+
+  if (m_looped && m_keyframes.size() > 1) {
+    m_duration += m_keyframes[1].time - m_keyframes[0].time;
+  }
+}
+
+CameraPath CameraPath::load(const std::filesystem::path& path) {
+  std::ifstream file(path);
+
+  if (!file.is_open()) {
+    ABORT("Failed to open camera path {}", path.string());
+  }
+
+  std::vector<Keyframe> keyframes;
+  std::string line;
+  int lineNumber = 0;
+
+  while (std::getline(file, line)) {
+    lineNumber++;
+
+    auto first = line.find_first_not_of(" \t\r");
+
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+
+    std::istringstream stream(line);
+    Keyframe keyframe{};
+
+    stream >> keyframe.time >> keyframe.position.x >> keyframe.position.y >>
+        keyframe.position.z >> keyframe.target.x >> keyframe.target.y >>
+        keyframe.target.z;
+
+    if (stream.fail()) {
+      ABORT("Invalid keyframe at {}:{}", path.string(), lineNumber);
+    }
+
+    keyframes.push_back(keyframe);
+  }
+
+  return {std::move(keyframes), false};
+}
+
+CameraPath CameraPath::orbit(
+    const glm::vec3& center, float radius, float height, float period
+) {
+  constexpr int KEYFRAME_COUNT = 16;
+
+  std::vector<Keyframe> keyframes;
+  keyframes.reserve(KEYFRAME_COUNT);
+
+  for (int i = 0; i < KEYFRAME_COUNT; ++i) {
+    float fraction = static_cast<float>(i) / KEYFRAME_COUNT;
+    float angle = fraction * glm::two_pi<float>();
+
+    Keyframe keyframe{};
+    keyframe.time = fraction * period;
+    keyframe.position = center + glm::vec3(
+                                     radius * std::sin(angle),
+                                     height,
+                                     radius * std::cos(angle)
+                                 );
+    keyframe.target = center;
+
+    keyframes.push_back(keyframe);
+  }
+
+  return {std::move(keyframes), true};
+}
+
+CameraPath::Keyframe CameraPath::sample(float time) const {
+  auto count = static_cast<int>(m_keyframes.size());
+
+  if (count == 1) {
+    return m_keyframes.front();
+  }
+
+  if (m_looped) {
+    time = std::fmod(time, m_duration);
+    time = time < 0.0f ? time + m_duration : time;
+  } else {
+    time = std::clamp(time, m_keyframes.front().time, m_duration);
+  }
+
+  // Looped paths have one extra segment from the last keyframe back to the
+  // first one
+  int segmentCount = m_looped ? count : count - 1;
+  int segment = 0;
+
+  while (segment < segmentCount - 1 && getKeyframeTime(segment + 1) <= time) {
+    segment++;
+  }
+
+  float start = getKeyframeTime(segment);
+  float end = getKeyframeTime(segment + 1);
+  float t = end > start ? (time - start) / (end - start) : 0.0f;
+
+  const Keyframe& k0 = getKeyframe(segment - 1);
+  const Keyframe& k1 = getKeyframe(segment);
+  const Keyframe& k2 = getKeyframe(segment + 1);
+  const Keyframe& k3 = getKeyframe(segment + 2);
+
+  Keyframe result{};
+  result.time = time;
+  result.position =
+      catmullRom(k0.position, k1.position, k2.position, k3.position, t);
+  result.target = catmullRom(k0.target, k1.target, k2.target, k3.target, t);
+
+  return result;
+}
+
+const CameraPath::Keyframe& CameraPath::getKeyframe(int index) const {
+  auto count = static_cast<int>(m_keyframes.size());
+
+  if (m_looped) {
+    return m_keyframes[((index % count) + count) % count];
+  }
+
+  return m_keyframes[std::clamp(index, 0, count - 1)];
+}
+
+float CameraPath::getKeyframeTime(int index) const {
+  auto count = static_cast<int>(m_keyframes.size());
+
+  if (m_looped && index == count) {
+    return m_duration;
+  }
+
+  return getKeyframe(index).time;
+}
+}  // namespace engine
@@ -0,0 +1,58 @@
+#ifndef CAMERA_PATH_HPP
+#define CAMERA_PATH_HPP
+
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Camera motion as a Catmull-Rom spline through timed keyframes, used to
+ * drive the camera without user input.
+ */
+class CameraPath {
+ public:
+  struct Keyframe {
+    float time;
+    glm::vec3 position;
+    glm::vec3 target;
+  };
+
+  /**
+   * @param looped wrap around after the last keyframe, which then blends back
+   * into the first one over the same interval as the first segment
+   */
+  CameraPath(std::vector<Keyframe> keyframes, bool looped);
+
+  /**
+   * Reads one keyframe per line as "time px py pz tx ty tz". Empty lines and
+   * lines starting with # are skipped.
+   */
+  static CameraPath load(const std::filesystem::path& path);
+
+  /**
+   * Circles around center at the given radius and height, one revolution per
+   * period seconds
+   */
+  static CameraPath orbit(
+      const glm::vec3& center, float radius, float height, float period
+  );
+
+  [[nodiscard]] Keyframe sample(float time) const;
+
+  [[nodiscard]] float getDuration() const { return m_duration; }
+
+ private:
+  std::vector<Keyframe> m_keyframes;
+  bool m_looped;
+  float m_duration;
+
+  [[nodiscard]] const Keyframe& getKeyframe(int index) const;
+
+  [[nodiscard]] float getKeyframeTime(int index) const;
+};
+
+}  // namespace engine
+
+#endif  // CAMERA_PATH_HPP
@@ -3,8 +3,10 @@
 namespace engine {
 #ifdef NDEBUG
 const bool Config::IS_VALIDATION_LAYERS_ENABLED = false;
+const bool Config::IS_SHADER_HOT_RELOAD_ENABLED = false;
 #else
 const bool Config::IS_VALIDATION_LAYERS_ENABLED = true;
+const bool Config::IS_SHADER_HOT_RELOAD_ENABLED = true;
 #endif
 
 }  // namespace engine
@@ -29,6 +29,8 @@
 
 namespace engine {
 struct Config {
+  static constexpr uint32_t VULKAN_API_VERSION = VK_API_VERSION_1_2;
+
   static constexpr std::size_t WINDOW_WIDTH = 800;
 
   static constexpr std::size_t WINDOW_HEIGHT = 600;
@@ -50,7 +52,64 @@ struct Config {
 
   static const bool IS_VALIDATION_LAYERS_ENABLED;
 
-  static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+  static const bool IS_SHADER_HOT_RELOAD_ENABLED;
+
+  /**
+   * Upper bound for FramePacing::framesInFlight
+   */
+  static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+  static constexpr std::size_t PIPELINE_PERMUTATION_WARNING_THRESHOLD = 32;
+
+  static constexpr bool IS_PIPELINE_LIBRARY_ENABLED = true;
+
+  /**
+   * Render through VK_KHR_dynamic_rendering instead of a render pass, where
+   * the device supports it
+   */
+  static constexpr bool IS_DYNAMIC_RENDERING_ENABLED = true;
+
+  /**
+   * Record render graph barriers through VK_KHR_synchronization2 instead of
+   * vkCmdPipelineBarrier, where the device supports it
+   */
+  static constexpr bool IS_SYNCHRONIZATION2_ENABLED = true;
+
+  static constexpr uint32_t MAX_BINDLESS_TEXTURES = 1024;
+
+  /**
+   * Color and depth attachments are allocated in multiples of this size, so
+   * resizing within one multiple reuses them
+   */
+  static constexpr uint32_t ATTACHMENT_SIZE_GRANULARITY = 256;
+
+  /**
+   * Fixed steps per second of the simulation thread
+   */
+  static constexpr uint32_t SIMULATION_TICK_RATE = 120;
+
+  /**
+   * Smallest fraction of the output resolution dynamic resolution renders at
+   */
+  static constexpr float MIN_RENDER_SCALE = 0.5f;
+
+  /**
+   * Consecutive triangles occlusion culling tests and draws as one unit
+   */
+  static constexpr uint32_t OCCLUSION_CHUNK_TRIANGLES = 64;
+
+  /**
+   * Size of the depth buffer CPU occlusion culling rasterizes into, whatever
+   * the size of the window
+   */
+  static constexpr uint32_t SOFTWARE_OCCLUSION_WIDTH = 320;
+  static constexpr uint32_t SOFTWARE_OCCLUSION_HEIGHT = 192;
+
+  /**
+   * Most threads CPU occlusion culling rasterizes with, the frame's own
+   * thread included
+   */
+  static constexpr uint32_t SOFTWARE_OCCLUSION_THREADS = 4;
 };
 }  // namespace engine
 
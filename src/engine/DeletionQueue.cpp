@@ -0,0 +1,29 @@
+#include "DeletionQueue.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace engine {
+DeletionQueue::~DeletionQueue() {
+  if (!m_entries.empty()) {
+    SPDLOG_WARN(
+        "Deletion queue destroyed with {} pending entries", m_entries.size()
+    );
+  }
+}
+
+void DeletionQueue::collect(const TimelineValues& completedValues) {
+  while (!m_entries.empty()) {
+    const TimelineValues& values = m_entries.front().values;
+
+    for (size_t queue = 0; queue < values.size(); ++queue) {
+      if (values[queue] > completedValues[queue]) {
+        return;
+      }
+    }
+
+    m_entries.pop_front();
+  }
+}
+
+void DeletionQueue::flush() { m_entries.clear(); }
+}  // namespace engine
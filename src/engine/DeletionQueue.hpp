@@ -0,0 +1,84 @@
+#ifndef DELETION_QUEUE_HPP
+#define DELETION_QUEUE_HPP
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+
+namespace engine {
+
+/**
+ * Defers destroying GPU objects until the submissions that may still use them
+ * have finished, so they can be replaced at runtime without idling the device.
+ * Submissions are identified by the TimelineSemaphore values of the queues
+ * they were made on.
+ *
+ * Any movable owner of Vulkan handles can be pushed: a wrapper, a unique_ptr
+ * or a vector of them. Resources are destroyed in the order they were pushed,
+ * so push users before the resources they use.
+ */
+class DeletionQueue {
+ public:
+  DeletionQueue() = default;
+
+  ~DeletionQueue();
+
+  DeletionQueue(const DeletionQueue&) = delete;
+  DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+  /**
+   * A value per timeline, the graphics queue's first and then the compute
+   * queue's, 0 for a queue that does not exist
+   */
+  using TimelineValues = std::array<uint64_t, 2>;
+
+  /**
+   * @param values timeline values of the last submissions that may use the
+   * resource. None may be smaller than in earlier calls.
+   */
+  template <typename T>
+  void push(const TimelineValues& values, T resource) {
+    m_entries.push_back(
+        {values, std::make_unique<Holder<T>>(std::move(resource))}
+    );
+  }
+
+  /**
+   * Destroys the resources of every entry whose submissions have finished on
+   * every queue
+   * @param completedValues timeline values of the last finished submissions
+   */
+  void collect(const TimelineValues& completedValues);
+
+  /**
+   * Destroys everything. The device must be idle.
+   */
+  void flush();
+
+  [[nodiscard]] std::size_t size() const { return m_entries.size(); }
+
+ private:
+  struct Resource {
+    virtual ~Resource() = default;
+  };
+
+  template <typename T>
+  struct Holder : Resource {
+    explicit Holder(T resource) : resource(std::move(resource)) {}
+
+    T resource;
+  };
+
+  struct Entry {
+    TimelineValues values;
+    std::unique_ptr<Resource> resource;
+  };
+
+  std::deque<Entry> m_entries;
+};
+
+}  // namespace engine
+
+#endif  // DELETION_QUEUE_HPP
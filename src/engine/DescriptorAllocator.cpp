@@ -0,0 +1,93 @@
+#include "DescriptorAllocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace engine {
+DescriptorAllocator::DescriptorAllocator(
+    VkDevice device,
+    std::vector<PoolSizeRatio> ratios,
+    uint32_t initialSetsPerPool
+)
+    : m_device(device),
+      m_ratios(std::move(ratios)),
+      m_setsPerPool(initialSetsPerPool) {
+  m_readyPools.emplace_back(createPool());
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+  VkDescriptorSetAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &layout;
+
+  VkDescriptorSet set = VK_NULL_HANDLE;
+
+  if (m_readyPools.empty()) {
+    m_readyPools.emplace_back(createPool());
+  }
+
+  allocInfo.descriptorPool = *m_readyPools.back();
+  VkResult result = vkAllocateDescriptorSets(m_device, &allocInfo, &set);
+
+  if (result == VK_ERROR_OUT_OF_POOL_MEMORY ||
+      result == VK_ERROR_FRAGMENTED_POOL) {
+    m_fullPools.emplace_back(std::move(m_readyPools.back()));
+    m_readyPools.pop_back();
+
+    if (m_readyPools.empty()) {
+      m_readyPools.emplace_back(createPool());
+    }
+
+    allocInfo.descriptorPool = *m_readyPools.back();
+    result = vkAllocateDescriptorSets(m_device, &allocInfo, &set);
+  }
+
+  ABORT_ON_FAIL(result, "Failed to allocate descriptor set");
+
+  return set;
+}
+
+void DescriptorAllocator::reset() {
+  for (auto& pool : m_readyPools) {
+    vkResetDescriptorPool(m_device, *pool, 0);
+  }
+
+  for (auto& pool : m_fullPools) {
+    vkResetDescriptorPool(m_device, *pool, 0);
+    m_readyPools.emplace_back(std::move(pool));
+  }
+
+  m_fullPools.clear();
+}
+
+std::unique_ptr<DescriptorPool> DescriptorAllocator::createPool() {
+  std::vector<VkDescriptorPoolSize> poolSizes;
+  poolSizes.reserve(m_ratios.size());
+
+  for (const auto& ratio : m_ratios) {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = ratio.type;
+    poolSize.descriptorCount = std::max(
+        1u, static_cast<uint32_t>(std::ceil(ratio.ratio * m_setsPerPool))
+    );
+    poolSizes.emplace_back(poolSize);
+  }
+
+  VkDescriptorPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  poolInfo.pPoolSizes = poolSizes.data();
+  poolInfo.maxSets = m_setsPerPool;
+
+  SPDLOG_DEBUG("Growing descriptor allocator by {} sets", m_setsPerPool);
+
+  // Every new pool is larger than the previous one, so a workload that keeps
+  // overflowing settles on a few big pools instead of many small ones
+  m_setsPerPool =
+      std::min(m_setsPerPool + m_setsPerPool / 2, MAX_SETS_PER_POOL);
+
+  return std::make_unique<DescriptorPool>(m_device, poolInfo);
+}
+}  // namespace engine
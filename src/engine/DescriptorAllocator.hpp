@@ -0,0 +1,53 @@
+#ifndef DESCRIPTOR_ALLOCATOR_HPP
+#define DESCRIPTOR_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <vector>
+
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * Allocates descriptor sets from a chain of pools that grows on demand, so
+ * nobody has to size a pool for the exact number of sets up front. reset()
+ * recycles every pool at once, which makes one allocator per frame in flight
+ * a cheap home for transient sets.
+ */
+class DescriptorAllocator {
+ public:
+  /**
+   * Number of descriptors of a type reserved per set in every pool
+   */
+  struct PoolSizeRatio {
+    VkDescriptorType type;
+    float ratio;
+  };
+
+  DescriptorAllocator(
+      VkDevice device,
+      std::vector<PoolSizeRatio> ratios,
+      uint32_t initialSetsPerPool = 16
+  );
+
+  VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+  void reset();
+
+ private:
+  static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+  VkDevice m_device;
+  std::vector<PoolSizeRatio> m_ratios;
+  uint32_t m_setsPerPool;
+  std::vector<std::unique_ptr<DescriptorPool>> m_readyPools;
+  std::vector<std::unique_ptr<DescriptorPool>> m_fullPools;
+
+  std::unique_ptr<DescriptorPool> createPool();
+};
+
+}  // namespace engine
+
+#endif  // DESCRIPTOR_ALLOCATOR_HPP
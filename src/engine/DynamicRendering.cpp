@@ -0,0 +1,48 @@
+#include "DynamicRendering.hpp"
+
+#include "Abort.hpp"
+#include "PhysicalDevice.hpp"
+
+namespace engine {
+DynamicRendering::DynamicRendering(VkDevice device)
+    : m_cmdBeginRendering(reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+          vkGetDeviceProcAddr(device, "vkCmdBeginRenderingKHR")
+      )),
+      m_cmdEndRendering(reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+          vkGetDeviceProcAddr(device, "vkCmdEndRenderingKHR")
+      )) {
+  if (!m_cmdBeginRendering || !m_cmdEndRendering) {
+    ABORT("Failed to load the dynamic rendering entry points");
+  }
+}
+
+void DynamicRendering::begin(
+    VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo
+) const {
+  m_cmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void DynamicRendering::end(VkCommandBuffer commandBuffer) const {
+  m_cmdEndRendering(commandBuffer);
+}
+
+bool DynamicRendering::isSupported(VkPhysicalDevice physicalDevice) {
+  if (!PhysicalDevice::isExtensionSupported(
+          physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME
+      )) {
+    return false;
+  }
+
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+  dynamicRenderingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &dynamicRenderingFeatures;
+
+  vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+  return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+}
+}  // namespace engine
@@ -0,0 +1,39 @@
+#ifndef DYNAMIC_RENDERING_HPP
+#define DYNAMIC_RENDERING_HPP
+
+#include <vulkan/vulkan.h>
+
+namespace engine {
+
+/**
+ * Entry points of VK_KHR_dynamic_rendering, core in Vulkan 1.3. Rendering
+ * begins directly on image views, so neither render pass nor framebuffer
+ * objects have to exist, and pipelines are created against attachment
+ * formats through VkPipelineRenderingCreateInfoKHR.
+ *
+ * Layout transitions are not part of dynamic rendering, the caller records
+ * them around begin() and end().
+ */
+class DynamicRendering {
+ public:
+  /**
+   * @param device created with the extension and its feature enabled
+   */
+  explicit DynamicRendering(VkDevice device);
+
+  void begin(
+      VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo
+  ) const;
+
+  void end(VkCommandBuffer commandBuffer) const;
+
+  static bool isSupported(VkPhysicalDevice physicalDevice);
+
+ private:
+  PFN_vkCmdBeginRenderingKHR m_cmdBeginRendering;
+  PFN_vkCmdEndRenderingKHR m_cmdEndRendering;
+};
+
+}  // namespace engine
+
+#endif  // DYNAMIC_RENDERING_HPP
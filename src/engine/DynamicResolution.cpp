@@ -0,0 +1,62 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine {
+namespace {
+/**
+ * Weight of the newest frame time in the average
+ */
+constexpr double SMOOTHING = 0.1;
+
+/**
+ * Frame times within this fraction of the target keep the scale
+ */
+constexpr double TOLERANCE = 0.05;
+
+/**
+ * Fraction of the way to the estimated scale taken per frame. Frame times
+ * reflect a new scale only after the frames in flight, so jumping there at
+ * once would overshoot.
+ */
+constexpr double GAIN = 0.2;
+}  // namespace
+
+DynamicResolution::DynamicResolution(
+    double targetFrameTime, float minScale, float maxScale
+)
+    : m_targetFrameTime(targetFrameTime),
+      m_minScale(minScale),
+      m_maxScale(maxScale),
+      m_scale(maxScale) {}
+
+float DynamicResolution::update(double frameTime) {
+  if (m_averageFrameTime == 0.0) {
+    m_averageFrameTime = frameTime;
+  } else {
+    m_averageFrameTime += SMOOTHING * (frameTime - m_averageFrameTime);
+  }
+
+  double ratio = m_targetFrameTime / m_averageFrameTime;
+
+  if (std::abs(1.0 - ratio) <= TOLERANCE) {
+    return m_scale;
+  }
+
+  double estimate = m_scale * std::sqrt(ratio);
+  double scale = m_scale + GAIN * (estimate - m_scale);
+
+  m_scale = std::clamp(static_cast<float>(scale), m_minScale, m_maxScale);
+  return m_scale;
+}
+
+VkExtent2D DynamicResolution::scaleExtent(VkExtent2D extent, float scale) {
+  auto scaleSize = [scale](uint32_t size) {
+    auto scaled = static_cast<uint32_t>(std::lround(size * scale));
+    return std::clamp<uint32_t>(scaled, 1, size);
+  };
+
+  return {scaleSize(extent.width), scaleSize(extent.height)};
+}
+}  // namespace engine
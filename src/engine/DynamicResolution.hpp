@@ -0,0 +1,46 @@
+#ifndef DYNAMIC_RESOLUTION_HPP
+#define DYNAMIC_RESOLUTION_HPP
+
+#include <vulkan/vulkan.h>
+
+namespace engine {
+
+/**
+ * Chooses every frame which fraction of the output resolution the scene is
+ * rendered at, so GPU frame times stay close to a target. The cost of a frame
+ * is assumed to grow with its pixel count, i.e. with the square of the scale.
+ */
+class DynamicResolution {
+ public:
+  /**
+   * @param targetFrameTime in milliseconds
+   */
+  DynamicResolution(double targetFrameTime, float minScale, float maxScale);
+
+  /**
+   * Feeds the GPU time of one frame in milliseconds
+   * @return the scale to render the next frame at
+   */
+  float update(double frameTime);
+
+  [[nodiscard]] float getScale() const { return m_scale; }
+
+  /**
+   * extent scaled by scale, at least one pixel in each direction
+   */
+  static VkExtent2D scaleExtent(VkExtent2D extent, float scale);
+
+ private:
+  double m_targetFrameTime;
+  float m_minScale;
+  float m_maxScale;
+  float m_scale;
+  /**
+   * Exponential moving average of the frame times, 0 before the first one
+   */
+  double m_averageFrameTime = 0.0;
+};
+
+}  // namespace engine
+
+#endif  // DYNAMIC_RESOLUTION_HPP
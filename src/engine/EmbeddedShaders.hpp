@@ -0,0 +1,51 @@
+#ifndef EMBEDDED_SHADERS_HPP
+#define EMBEDDED_SHADERS_HPP
+
+#include <cstdint>
+
+namespace engine {
+/**
+ * SPIR-V generated from res/shaders by the Shaders target at build time. The
+ * words are part of the executable, so shader modules can be created without
+ * touching the file system.
+ */
+struct EmbeddedShaders {
+  static constexpr uint32_t SHADER_VERT[] =
+#include "shader.vert.inc"
+      ;
+
+  static constexpr uint32_t SHADER_FRAG[] =
+#include "shader.frag.inc"
+      ;
+
+  static constexpr uint32_t DEPTH_VERT[] =
+#include "depth.vert.inc"
+      ;
+
+  static constexpr uint32_t FULLSCREEN_VERT[] =
+#include "fullscreen.vert.inc"
+      ;
+
+  static constexpr uint32_t FXAA_FRAG[] =
+#include "fxaa.frag.inc"
+      ;
+
+  static constexpr uint32_t UPSCALE_FRAG[] =
+#include "upscale.frag.inc"
+      ;
+
+  static constexpr uint32_t DEPTH_PYRAMID_COMP[] =
+#include "depth_pyramid.comp.inc"
+      ;
+
+  static constexpr uint32_t DEPTH_PYRAMID_MS_COMP[] =
+#include "depth_pyramid_ms.comp.inc"
+      ;
+
+  static constexpr uint32_t OCCLUSION_CULL_COMP[] =
+#include "occlusion_cull.comp.inc"
+      ;
+};
+}  // namespace engine
+
+#endif  // EMBEDDED_SHADERS_HPP
@@ -0,0 +1,120 @@
+#include "FramePacing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace engine {
+namespace {
+constexpr std::array<std::pair<std::string_view, FramePacingPolicy>, 4>
+    POLICY_NAMES = {{
+        {"balanced", FramePacingPolicy::Balanced},
+        {"low-latency", FramePacingPolicy::LowLatency},
+        {"max-throughput", FramePacingPolicy::MaxThroughput},
+        {"power-saver", FramePacingPolicy::PowerSaver},
+    }};
+
+constexpr std::array<std::pair<std::string_view, VkPresentModeKHR>, 4>
+    PRESENT_MODE_NAMES = {{
+        {"fifo", VK_PRESENT_MODE_FIFO_KHR},
+        {"fifo-relaxed", VK_PRESENT_MODE_FIFO_RELAXED_KHR},
+        {"mailbox", VK_PRESENT_MODE_MAILBOX_KHR},
+        {"immediate", VK_PRESENT_MODE_IMMEDIATE_KHR},
+    }};
+}  // namespace
+
+FramePacing FramePacing::fromPolicy(FramePacingPolicy policy) {
+  FramePacing pacing;
+  pacing.policy = policy;
+
+  switch (policy) {
+    case FramePacingPolicy::Balanced:
+      break;
+    case FramePacingPolicy::LowLatency:
+      // A single frame in flight keeps the CPU from queueing stale input, and
+      // mailbox always presents the newest image without tearing
+      pacing.framesInFlight = 1;
+      pacing.extraSwapchainImages = 1;
+      pacing.presentModes = {
+          VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR};
+      break;
+    case FramePacingPolicy::MaxThroughput:
+      pacing.framesInFlight = 3;
+      pacing.extraSwapchainImages = 2;
+      pacing.presentModes = {
+          VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+      break;
+    case FramePacingPolicy::PowerSaver:
+      // Vsync throttles both the CPU and the GPU to the display rate
+      pacing.framesInFlight = 2;
+      pacing.extraSwapchainImages = 0;
+      pacing.presentModes = {VK_PRESENT_MODE_FIFO_KHR};
+      break;
+  }
+
+  return pacing;
+}
+
+VkPresentModeKHR FramePacing::choosePresentMode(
+    const std::vector<VkPresentModeKHR>& availablePresentModes
+) const {
+  for (auto presentMode : presentModes) {
+    if (std::find(
+            availablePresentModes.begin(),
+            availablePresentModes.end(),
+            presentMode
+        ) != availablePresentModes.end()) {
+      return presentMode;
+    }
+  }
+
+  return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+uint32_t FramePacing::chooseImageCount(
+    const VkSurfaceCapabilitiesKHR& capabilities
+) const {
+  uint32_t imageCount = capabilities.minImageCount + extraSwapchainImages;
+
+  if (capabilities.maxImageCount > 0 &&
+      imageCount > capabilities.maxImageCount) {
+    imageCount = capabilities.maxImageCount;
+  }
+
+  return imageCount;
+}
+
+std::optional<FramePacingPolicy> FramePacing::parsePolicy(
+    std::string_view name
+) {
+  for (const auto& [policyName, policy] : POLICY_NAMES) {
+    if (policyName == name) {
+      return policy;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::optional<VkPresentModeKHR> FramePacing::parsePresentMode(
+    std::string_view name
+) {
+  for (const auto& [modeName, presentMode] : PRESENT_MODE_NAMES) {
+    if (modeName == name) {
+      return presentMode;
+    }
+  }
+
+  return std::nullopt;
+}
+
+const char* FramePacing::toString(FramePacingPolicy policy) {
+  for (const auto& [policyName, candidate] : POLICY_NAMES) {
+    if (candidate == policy) {
+      return policyName.data();
+    }
+  }
+
+  return "unknown";
+}
+}  // namespace engine
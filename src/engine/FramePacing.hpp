@@ -0,0 +1,61 @@
+#ifndef FRAME_PACING_HPP
+#define FRAME_PACING_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace engine {
+
+enum class FramePacingPolicy {
+  Balanced,
+  LowLatency,
+  MaxThroughput,
+  PowerSaver,
+};
+
+/**
+ * Trade-off between input latency, throughput and power draw: how many frames
+ * the CPU may run ahead of the GPU, how deep the swap chain is and how images
+ * are handed to the presentation engine.
+ */
+struct FramePacing {
+  FramePacingPolicy policy = FramePacingPolicy::Balanced;
+
+  uint32_t framesInFlight = 2;
+
+  /**
+   * Images requested on top of the surface's minImageCount
+   */
+  uint32_t extraSwapchainImages = 1;
+
+  /**
+   * Present modes in order of preference. FIFO is always supported and used
+   * when none of them is available.
+   */
+  std::vector<VkPresentModeKHR> presentModes = {VK_PRESENT_MODE_MAILBOX_KHR};
+
+  static FramePacing fromPolicy(FramePacingPolicy policy);
+
+  [[nodiscard]] VkPresentModeKHR choosePresentMode(
+      const std::vector<VkPresentModeKHR>& availablePresentModes
+  ) const;
+
+  [[nodiscard]] uint32_t chooseImageCount(
+      const VkSurfaceCapabilitiesKHR& capabilities
+  ) const;
+
+  static std::optional<FramePacingPolicy> parsePolicy(std::string_view name);
+
+  static std::optional<VkPresentModeKHR> parsePresentMode(
+      std::string_view name
+  );
+
+  static const char* toString(FramePacingPolicy policy);
+};
+
+}  // namespace engine
+
+#endif  // FRAME_PACING_HPP
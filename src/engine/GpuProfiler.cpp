@@ -0,0 +1,205 @@
+#include "GpuProfiler.hpp"
+
+#include <cstring>
+
+#include "VulkanDoubleCallWrapper.hpp"
+
+namespace engine {
+GpuProfiler::GpuProfiler(
+    VkDevice device,
+    VkPhysicalDevice physicalDevice,
+    uint32_t queueFamilyIndex,
+    uint32_t frameCount,
+    uint32_t maxScopesPerFrame,
+    std::size_t statisticsWindow
+)
+    : m_device(device),
+      m_maxScopesPerFrame(maxScopesPerFrame),
+      m_statisticsWindow(statisticsWindow) {
+  auto queueFamilies =
+      vkCall(vkGetPhysicalDeviceQueueFamilyProperties, physicalDevice);
+  uint32_t validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+
+  if (validBits == 0) {
+    SPDLOG_WARN("Queue family {} has no timestamps", queueFamilyIndex);
+    return;
+  }
+
+  if (validBits < 64) {
+    m_timestampMask = (1ull << validBits) - 1;
+  }
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  m_timestampPeriod = properties.limits.timestampPeriod;
+
+  VkQueryPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  poolInfo.queryCount = 2 * m_maxScopesPerFrame;
+
+  m_frames.resize(frameCount);
+
+  for (auto& frame : m_frames) {
+    frame.pool = std::make_unique<QueryPool>(m_device, poolInfo);
+    frame.scopeNames.reserve(m_maxScopesPerFrame);
+    vkResetQueryPool(m_device, *frame.pool, 0, poolInfo.queryCount);
+  }
+
+  m_enabled = true;
+}
+
+GpuProfiler::~GpuProfiler() { logSummary(); }
+
+void GpuProfiler::beginFrame(uint32_t frameIndex) {
+  if (!m_enabled) {
+    return;
+  }
+
+  if (!m_openScopes.empty()) {
+    SPDLOG_WARN("{} GPU profiler scopes left open", m_openScopes.size());
+    m_openScopes.clear();
+  }
+
+  m_currentFrame = &m_frames[frameIndex];
+  m_latest.clear();
+  collect(*m_currentFrame);
+}
+
+void GpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name) {
+  if (!m_enabled || !m_currentFrame) {
+    return;
+  }
+
+  auto index = static_cast<uint32_t>(m_currentFrame->scopeNames.size());
+
+  if (index == m_maxScopesPerFrame) {
+    if (!m_overflowReported) {
+      SPDLOG_WARN(
+          "More than {} GPU profiler scopes in a frame, skipping {}",
+          m_maxScopesPerFrame,
+          name
+      );
+      m_overflowReported = true;
+    }
+
+    m_openScopes.push_back(SKIPPED_SCOPE);
+    return;
+  }
+
+  m_currentFrame->scopeNames.push_back(name);
+  m_openScopes.push_back(index);
+
+  vkCmdWriteTimestamp(
+      commandBuffer,
+      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      *m_currentFrame->pool,
+      2 * index
+  );
+}
+
+void GpuProfiler::endScope(VkCommandBuffer commandBuffer) {
+  if (!m_enabled || m_openScopes.empty()) {
+    return;
+  }
+
+  uint32_t index = m_openScopes.back();
+  m_openScopes.pop_back();
+
+  if (index == SKIPPED_SCOPE) {
+    return;
+  }
+
+  vkCmdWriteTimestamp(
+      commandBuffer,
+      VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+      *m_currentFrame->pool,
+      2 * index + 1
+  );
+}
+
+void GpuProfiler::flush() {
+  for (auto& frame : m_frames) {
+    collect(frame);
+  }
+}
+
+void GpuProfiler::resetStatistics() { m_statistics.clear(); }
+
+std::optional<double> GpuProfiler::getLatest(const char* name) const {
+  for (const auto& [scopeName, milliseconds] : m_latest) {
+    if (std::strcmp(scopeName, name) == 0) {
+      return milliseconds;
+    }
+  }
+
+  return std::nullopt;
+}
+
+void GpuProfiler::logSummary() const {
+  for (const auto& [name, statistics] : m_statistics) {
+    SPDLOG_INFO(
+        "GPU {}: min {:.3f}ms, avg {:.3f}ms, p99 {:.3f}ms ({} samples)",
+        name,
+        statistics.min(),
+        statistics.average(),
+        statistics.percentile(99.0),
+        statistics.count()
+    );
+  }
+}
+
+void GpuProfiler::collect(FrameQueries& frame) {
+  auto queryCount = static_cast<uint32_t>(2 * frame.scopeNames.size());
+
+  if (queryCount == 0) {
+    return;
+  }
+
+  // Each query yields its timestamp followed by an availability word
+  std::vector<uint64_t> results(2 * queryCount);
+
+  VkResult result = vkGetQueryPoolResults(
+      m_device,
+      *frame.pool,
+      0,
+      queryCount,
+      results.size() * sizeof(uint64_t),
+      results.data(),
+      2 * sizeof(uint64_t),
+      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+  );
+
+  if (result != VK_SUCCESS && result != VK_NOT_READY) {
+    ABORT_ON_FAIL(result, "Failed to read GPU timestamps");
+  }
+
+  for (std::size_t i = 0; i < frame.scopeNames.size(); ++i) {
+    const uint64_t* begin = &results[4 * i];
+    const uint64_t* end = &results[4 * i + 2];
+
+    if (begin[1] == 0 || end[1] == 0) {
+      continue;
+    }
+
+    uint64_t ticks = ((end[0] - begin[0]) & m_timestampMask);
+    double milliseconds = static_cast<double>(ticks) * m_timestampPeriod / 1e6;
+
+    auto it = m_statistics.find(frame.scopeNames[i]);
+
+    if (it == m_statistics.end()) {
+      it = m_statistics
+               .emplace(
+                   frame.scopeNames[i], RollingStatistics(m_statisticsWindow)
+               )
+               .first;
+    }
+
+    it->second.add(milliseconds);
+    m_latest.emplace_back(frame.scopeNames[i], milliseconds);
+  }
+
+  vkResetQueryPool(m_device, *frame.pool, 0, queryCount);
+  frame.scopeNames.clear();
+}
+}  // namespace engine
@@ -0,0 +1,103 @@
+#ifndef GPU_PROFILER_HPP
+#define GPU_PROFILER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Statistics.hpp"
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * Measures GPU time of named scopes with timestamp queries. Every frame slot
+ * owns its own query pool, which is read back the next time the slot comes
+ * around. By then its work has been waited for, so reading the results never
+ * stalls, and scopes whose results are not available yet are skipped.
+ *
+ * Queries are reset from the host, so a frame's scopes may be spread over any
+ * number of command buffers submitted between two beginFrame() calls.
+ */
+class GpuProfiler {
+ public:
+  GpuProfiler(
+      VkDevice device,
+      VkPhysicalDevice physicalDevice,
+      uint32_t queueFamilyIndex,
+      uint32_t frameCount,
+      uint32_t maxScopesPerFrame = 32,
+      std::size_t statisticsWindow = 256
+  );
+
+  virtual ~GpuProfiler();
+
+  /**
+   * Collects the results of the previous use of the slot and starts recording
+   * into it. The slot's last submission must have completed.
+   */
+  void beginFrame(uint32_t frameIndex);
+
+  /**
+   * Scopes may nest. The name must outlive the frame, string literals are
+   * expected.
+   */
+  void beginScope(VkCommandBuffer commandBuffer, const char* name);
+
+  void endScope(VkCommandBuffer commandBuffer);
+
+  /**
+   * Collects every slot that still holds results. The device must be idle.
+   */
+  void flush();
+
+  void resetStatistics();
+
+  /**
+   * Rolling GPU time per scope name, in milliseconds
+   */
+  [[nodiscard]] const std::map<std::string, RollingStatistics>& getStatistics(
+  ) const {
+    return m_statistics;
+  }
+
+  /**
+   * GPU time of the scope in the results collected by the last beginFrame(),
+   * in milliseconds. Empty if the scope was not measured there.
+   */
+  [[nodiscard]] std::optional<double> getLatest(const char* name) const;
+
+  void logSummary() const;
+
+ private:
+  struct FrameQueries {
+    std::unique_ptr<QueryPool> pool;
+    std::vector<const char*> scopeNames;
+  };
+
+  static constexpr uint32_t SKIPPED_SCOPE = UINT32_MAX;
+
+  VkDevice m_device;
+  bool m_enabled = false;
+  double m_timestampPeriod = 1.0;
+  uint64_t m_timestampMask = ~0ull;
+  uint32_t m_maxScopesPerFrame;
+  std::size_t m_statisticsWindow;
+  std::vector<FrameQueries> m_frames;
+  FrameQueries* m_currentFrame = nullptr;
+  std::vector<uint32_t> m_openScopes;
+  bool m_overflowReported = false;
+  std::map<std::string, RollingStatistics> m_statistics;
+  std::vector<std::pair<const char*, double>> m_latest;
+
+  void collect(FrameQueries& frame);
+};
+
+}  // namespace engine
+
+#endif  // GPU_PROFILER_HPP
@@ -0,0 +1,46 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace engine {
+
+/**
+ * 64 bit FNV-1a. Feed struct fields one by one rather than whole structs so
+ * padding bytes never end up in the hash.
+ */
+class Fnv1a {
+ public:
+  template <typename T>
+  Fnv1a& add(const T& value) {
+    return addBytes(&value, sizeof(T));
+  }
+
+  Fnv1a& addString(std::string_view text) {
+    return addBytes(text.data(), text.size());
+  }
+
+  Fnv1a& addBytes(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+
+    for (std::size_t i = 0; i < size; ++i) {
+      m_hash = (m_hash ^ bytes[i]) * PRIME;
+    }
+
+    return *this;
+  }
+
+  [[nodiscard]] uint64_t value() const { return m_hash; }
+
+ private:
+  static constexpr uint64_t OFFSET_BASIS = 14695981039346656037ULL;
+  static constexpr uint64_t PRIME = 1099511628211ULL;
+
+  uint64_t m_hash = OFFSET_BASIS;
+};
+
+}  // namespace engine
+
+#endif  // HASH_HPP
@@ -0,0 +1,58 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <cstdio>
+#include <ostream>
+#include <string_view>
+
+namespace engine {
+
+/**
+ * Writes value as a quoted JSON string. Quotes, backslashes and control
+ * characters are escaped, other bytes are written as they are.
+ */
+inline void writeJsonString(std::ostream& out, std::string_view value) {
+  out << '"';
+
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\b':
+        out << "\\b";
+        break;
+      case '\f':
+        out << "\\f";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[7];
+          std::snprintf(
+              escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c)
+          );
+          out << escaped;
+        } else {
+          out << c;
+        }
+    }
+  }
+
+  out << '"';
+}
+
+}  // namespace engine
+
+#endif  // JSON_HPP
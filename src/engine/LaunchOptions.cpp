@@ -0,0 +1,228 @@
+#include "LaunchOptions.hpp"
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+#include "Abort.hpp"
+#include "Config.hpp"
+
+namespace engine {
+namespace {
+template <typename T = uint32_t>
+T parseNumber(std::string_view option, std::string_view value) {
+  T number = 0;
+  auto [end, error] =
+      std::from_chars(value.data(), value.data() + value.size(), number);
+
+  if (error != std::errc() || end != value.data() + value.size()) {
+    ABORT("Invalid value '{}' for {}", value, option);
+  }
+
+  return number;
+}
+}  // namespace
+
+LaunchOptions LaunchOptions::parse(int argc, char** argv) {
+  LaunchOptions options;
+
+  std::optional<uint32_t> framesInFlight;
+  std::optional<uint32_t> swapchainImages;
+  std::optional<VkPresentModeKHR> presentMode;
+  BenchmarkSettings benchmark;
+  bool isBenchmark = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view option = argv[i];
+
+    if (option == "-h" || option == "--help") {
+      options.showHelp = true;
+      continue;
+    }
+
+    if (option == "--headless") {
+      options.headless = true;
+      continue;
+    }
+
+    if (option == "--benchmark") {
+      isBenchmark = true;
+      continue;
+    }
+
+    if (option == "--dynamic-resolution") {
+      options.dynamicResolution = true;
+      continue;
+    }
+
+    if (option == "--depth-prepass") {
+      options.depthPrepass = true;
+      continue;
+    }
+
+    if (option == "--occlusion-culling") {
+      options.occlusionCulling = true;
+      continue;
+    }
+
+    if (option == "--cpu-occlusion") {
+      options.cpuOcclusion = true;
+      continue;
+    }
+
+    if (option == "--async-compute") {
+      options.asyncCompute = true;
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      ABORT("Unknown option or missing value: {}", option);
+    }
+
+    std::string_view value = argv[++i];
+
+    if (option == "--frame-pacing") {
+      auto policy = FramePacing::parsePolicy(value);
+
+      if (!policy) {
+        ABORT("Unknown frame pacing policy '{}'", value);
+      }
+
+      options.framePacing = FramePacing::fromPolicy(*policy);
+    } else if (option == "--frames-in-flight") {
+      framesInFlight = parseNumber(option, value);
+
+      if (*framesInFlight < 1 ||
+          *framesInFlight > Config::MAX_FRAMES_IN_FLIGHT) {
+        ABORT(
+            "--frames-in-flight must be between 1 and {}",
+            Config::MAX_FRAMES_IN_FLIGHT
+        );
+      }
+    } else if (option == "--swapchain-images") {
+      swapchainImages = parseNumber(option, value);
+    } else if (option == "--frames") {
+      options.frameCount = parseNumber<uint64_t>(option, value);
+    } else if (option == "--warmup-frames") {
+      benchmark.warmupFrames = parseNumber(option, value);
+    } else if (option == "--benchmark-frames") {
+      benchmark.measuredFrames = parseNumber(option, value);
+
+      if (benchmark.measuredFrames == 0) {
+        ABORT("--benchmark-frames must be at least 1");
+      }
+    } else if (option == "--timestep") {
+      benchmark.timestep = parseNumber<float>(option, value);
+
+      if (benchmark.timestep <= 0.0f) {
+        ABORT("--timestep must be positive");
+      }
+    } else if (option == "--benchmark-output") {
+      benchmark.outputPath = value;
+    } else if (option == "--camera-path") {
+      benchmark.cameraPath = value;
+    } else if (option == "--present-mode") {
+      presentMode = FramePacing::parsePresentMode(value);
+
+      if (!presentMode) {
+        ABORT("Unknown present mode '{}'", value);
+      }
+    } else if (option == "--anti-aliasing") {
+      auto mode = AntiAliasing::parse(value);
+
+      if (!mode) {
+        ABORT("Unknown anti-aliasing mode '{}'", value);
+      }
+
+      options.antiAliasing = *mode;
+    } else if (option == "--target-frame-time") {
+      options.targetFrameTime = parseNumber<double>(option, value);
+
+      if (options.targetFrameTime <= 0.0) {
+        ABORT("--target-frame-time must be positive");
+      }
+    } else if (option == "--render-scale") {
+      options.renderScale = parseNumber<float>(option, value);
+
+      if (options.renderScale < Config::MIN_RENDER_SCALE ||
+          options.renderScale > 1.0f) {
+        ABORT(
+            "--render-scale must be between {} and 1", Config::MIN_RENDER_SCALE
+        );
+      }
+    } else {
+      ABORT("Unknown option: {}", option);
+    }
+  }
+
+  // Explicit settings override the policy no matter where they appear
+  if (framesInFlight) {
+    options.framePacing.framesInFlight = *framesInFlight;
+  }
+
+  if (swapchainImages) {
+    options.framePacing.extraSwapchainImages = *swapchainImages;
+  }
+
+  if (presentMode) {
+    options.framePacing.presentModes = {*presentMode};
+  }
+
+  if (isBenchmark) {
+    options.benchmark = benchmark;
+  }
+
+  if (options.dynamicResolution && options.targetFrameTime <= 0.0) {
+    ABORT("--dynamic-resolution needs --target-frame-time");
+  }
+
+  // There is no window to close, so nothing else would end the run
+  if (options.headless && options.frameCount == 0 && !isBenchmark) {
+    ABORT("--headless needs --frames or --benchmark");
+  }
+
+  return options;
+}
+
+std::string LaunchOptions::getUsage(const char* programName) {
+  return fmt::format(
+      "Usage: {} [options]\n"
+      "  --frame-pacing <policy>   balanced, low-latency, max-throughput or\n"
+      "                            power-saver (switch live with F1-F4)\n"
+      "  --frames-in-flight <n>    frames recorded ahead of the GPU, 1-{}\n"
+      "  --swapchain-images <n>    images on top of the surface minimum\n"
+      "  --present-mode <mode>     fifo, fifo-relaxed, mailbox or immediate\n"
+      "  --anti-aliasing <mode>    off, fxaa, msaa2, msaa4 or msaa8, default\n"
+      "                            msaa4 (cycle live with F5)\n"
+      "  --target-frame-time <ms>  adapt the anti-aliasing tier to hold this\n"
+      "                            GPU frame time\n"
+      "  --render-scale <scale>    render at a fraction of the resolution,\n"
+      "                            {}-1, and upscale\n"
+      "  --dynamic-resolution      adapt the render scale to the target frame\n"
+      "                            time instead of the anti-aliasing tier\n"
+      "  --depth-prepass           render depth before shading the scene\n"
+      "  --occlusion-culling       skip occluded parts of the scene, implies\n"
+      "                            --depth-prepass\n"
+      "  --cpu-occlusion           skip occluded parts of the scene, tested\n"
+      "                            on the CPU before recording\n"
+      "  --async-compute           cull on a compute queue alongside the\n"
+      "                            graphics queue, with --occlusion-culling\n"
+      "  --headless                render offscreen without a window, needs\n"
+      "                            --frames or --benchmark\n"
+      "  --frames <n>              exit after n frames, 0 runs until the\n"
+      "                            window is closed\n"
+      "  --benchmark               render a fixed camera path and write a\n"
+      "                            frame time report\n"
+      "  --warmup-frames <n>       unmeasured benchmark frames, default 100\n"
+      "  --benchmark-frames <n>    measured benchmark frames, default 1000\n"
+      "  --timestep <seconds>      benchmark time per frame, default 1/60\n"
+      "  --benchmark-output <path> report file, default benchmark.json\n"
+      "  --camera-path <path>      keyframes \"time px py pz tx ty tz\" per\n"
+      "                            line, default an orbit of the model\n"
+      "  -h, --help                show this message\n",
+      programName,
+      Config::MAX_FRAMES_IN_FLIGHT,
+      Config::MIN_RENDER_SCALE
+  );
+}
+}  // namespace engine
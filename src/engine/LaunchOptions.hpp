@@ -0,0 +1,92 @@
+#ifndef LAUNCH_OPTIONS_HPP
+#define LAUNCH_OPTIONS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "AntiAliasing.hpp"
+#include "Benchmark.hpp"
+#include "FramePacing.hpp"
+
+namespace engine {
+
+/**
+ * Settings taken from the command line. Anything not given keeps the default
+ * of the selected frame pacing policy.
+ */
+struct LaunchOptions {
+  FramePacing framePacing;
+
+  /**
+   * Render into offscreen images without a window, surface or swap chain
+   */
+  bool headless = false;
+
+  /**
+   * Number of frames to render before exiting, 0 runs until the window closes
+   */
+  uint64_t frameCount = 0;
+
+  /**
+   * Set when running a benchmark, which also decides the frame count
+   */
+  std::optional<BenchmarkSettings> benchmark;
+
+  /**
+   * Falls back to the most expensive supported mode below it
+   */
+  AntiAliasingMode antiAliasing = AntiAliasingMode::Msaa4;
+
+  /**
+   * GPU frame time in milliseconds the anti-aliasing tier is adapted to, 0
+   * keeps the tier fixed
+   */
+  double targetFrameTime = 0.0;
+
+  /**
+   * Fraction of the window resolution the scene is rendered at before being
+   * upscaled, the upper bound of the scale with dynamicResolution
+   */
+  float renderScale = 1.0f;
+
+  /**
+   * Adapt the render scale to targetFrameTime every frame, instead of the
+   * anti-aliasing tier
+   */
+  bool dynamicResolution = false;
+
+  /**
+   * Lay down depth with a position-only pass first, so the main pass shades
+   * each pixel once
+   */
+  bool depthPrepass = false;
+
+  /**
+   * Cull the scene against a depth pyramid of the depth pre-pass, which this
+   * turns on as well
+   */
+  bool occlusionCulling = false;
+
+  /**
+   * Cull the scene against occluders rasterized on the CPU before recording,
+   * ignored with occlusionCulling
+   */
+  bool cpuOcclusion = false;
+
+  /**
+   * Run the culling passes of occlusionCulling on a compute queue of their
+   * own, falling back to the graphics queue on devices without one
+   */
+  bool asyncCompute = false;
+
+  bool showHelp = false;
+
+  static LaunchOptions parse(int argc, char** argv);
+
+  static std::string getUsage(const char* programName);
+};
+
+}  // namespace engine
+
+#endif  // LAUNCH_OPTIONS_HPP
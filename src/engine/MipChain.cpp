@@ -0,0 +1,146 @@
+#include "MipChain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Profiler.hpp"
+
+namespace engine {
+namespace {
+constexpr std::size_t CHANNELS = 4;
+
+// Resolution of the linear to sRGB table, fine enough that every 8 bit value
+// survives a round trip
+constexpr std::size_t LINEAR_STEPS = 4096;
+
+float srgbToLinear(float value) {
+  return value <= 0.04045f ? value / 12.92f
+                           : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float value) {
+  return value <= 0.0031308f ? value * 12.92f
+                             : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& getSrgbToLinearTable() {
+  static const auto table = [] {
+    std::array<float, 256> values{};
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      values[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+    }
+
+    return values;
+  }();
+
+  return table;
+}
+
+const std::array<uint8_t, LINEAR_STEPS>& getLinearToSrgbTable() {
+  static const auto table = [] {
+    std::array<uint8_t, LINEAR_STEPS> values{};
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      float linear = static_cast<float>(i) / (LINEAR_STEPS - 1);
+      values[i] = static_cast<uint8_t>(
+          std::lround(linearToSrgb(linear) * 255.0f)
+      );
+    }
+
+    return values;
+  }();
+
+  return table;
+}
+
+void downsample(
+    const uint8_t* source,
+    uint32_t sourceWidth,
+    uint32_t sourceHeight,
+    uint8_t* destination,
+    uint32_t width,
+    uint32_t height
+) {
+  const auto& toLinear = getSrgbToLinearTable();
+  const auto& toSrgb = getLinearToSrgbTable();
+
+  for (uint32_t y = 0; y < height; ++y) {
+    // Odd sizes clamp to the last row or column instead of reading past it
+    const uint8_t* rows[2] = {
+        source + std::size_t{2 * y} * sourceWidth * CHANNELS,
+        source + std::size_t{std::min(2 * y + 1, sourceHeight - 1)} *
+                     sourceWidth * CHANNELS};
+
+    for (uint32_t x = 0; x < width; ++x) {
+      std::size_t columns[2] = {
+          std::size_t{2 * x} * CHANNELS,
+          std::size_t{std::min(2 * x + 1, sourceWidth - 1)} * CHANNELS};
+
+      uint8_t* pixel = destination + (std::size_t{y} * width + x) * CHANNELS;
+
+      for (std::size_t c = 0; c < 3; ++c) {
+        float sum = toLinear[rows[0][columns[0] + c]] +
+                    toLinear[rows[0][columns[1] + c]] +
+                    toLinear[rows[1][columns[0] + c]] +
+                    toLinear[rows[1][columns[1] + c]];
+
+        pixel[c] = toSrgb[static_cast<std::size_t>(
+            sum * 0.25f * (LINEAR_STEPS - 1) + 0.5f
+        )];
+      }
+
+      // Alpha is stored linearly
+      uint32_t alpha = rows[0][columns[0] + 3] + rows[0][columns[1] + 3] +
+                       rows[1][columns[0] + 3] + rows[1][columns[1] + 3];
+      pixel[3] = static_cast<uint8_t>((alpha + 2) / 4);
+    }
+  }
+}
+}  // namespace
+
+uint32_t MipChain::getLevelCount(uint32_t width, uint32_t height) {
+  return static_cast<uint32_t>(
+             std::floor(std::log2(std::max({width, height, 1u})))
+         ) +
+         1;
+}
+
+std::vector<MipChain::Level> MipChain::generate(
+    std::vector<uint8_t>& pixels, uint32_t width, uint32_t height
+) {
+  PROFILE_FUNCTION();
+
+  std::vector<Level> levels;
+  levels.reserve(getLevelCount(width, height));
+  levels.push_back({width, height, 0});
+
+  // Each level is at most a quarter of the previous one
+  pixels.reserve(pixels.size() + pixels.size() / 3 + CHANNELS * 32);
+
+  while (width > 1 || height > 1) {
+    Level level{
+        std::max(width / 2, 1u), std::max(height / 2, 1u), pixels.size()};
+
+    pixels.resize(
+        level.offset + std::size_t{level.width} * level.height * CHANNELS
+    );
+
+    downsample(
+        pixels.data() + levels.back().offset,
+        width,
+        height,
+        pixels.data() + level.offset,
+        level.width,
+        level.height
+    );
+
+    width = level.width;
+    height = level.height;
+    levels.push_back(level);
+  }
+
+  return levels;
+}
+}  // namespace engine
@@ -0,0 +1,40 @@
+#ifndef MIP_CHAIN_HPP
+#define MIP_CHAIN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Builds the mip levels of an RGBA8 sRGB image on the CPU, for formats the
+ * device cannot blit with linear filtering. Each level is a 2x2 box filter of
+ * the previous one, averaged in linear space like a linear blit would.
+ */
+class MipChain {
+ public:
+  struct Level {
+    uint32_t width;
+    uint32_t height;
+
+    /**
+     * Byte offset of the level in the pixel buffer
+     */
+    std::size_t offset;
+  };
+
+  static uint32_t getLevelCount(uint32_t width, uint32_t height);
+
+  /**
+   * @param pixels tightly packed level 0, the other levels are appended
+   * @return every level including level 0
+   */
+  static std::vector<Level> generate(
+      std::vector<uint8_t>& pixels, uint32_t width, uint32_t height
+  );
+};
+
+}  // namespace engine
+
+#endif  // MIP_CHAIN_HPP
@@ -3,13 +3,33 @@
 #include <tiny_obj_loader.h>
 
 #include "Abort.hpp"
+#include "Profiler.hpp"
 
 namespace engine {
+VertexDeduplicator::VertexDeduplicator(
+    std::vector<Vertex>& vertices, std::vector<uint32_t>& indices
+)
+    : m_vertices(vertices), m_indices(indices) {}
+
+void VertexDeduplicator::add(const Vertex& vertex) {
+  auto [it, inserted] = m_uniqueVertices.try_emplace(
+      vertex, static_cast<uint32_t>(m_vertices.size())
+  );
+
+  if (inserted) {
+    m_vertices.emplace_back(vertex);
+  }
+
+  m_indices.emplace_back(it->second);
+}
+
 void ModelLoader::loadObj(
     const std::string& modelPath,
     std::vector<Vertex>& vertices,
     std::vector<uint32_t>& indices
 ) {
+  PROFILE_FUNCTION();
+
   tinyobj::attrib_t attrib;
   std::vector<tinyobj::shape_t> shapes;
   std::vector<tinyobj::material_t> materials;
@@ -21,7 +41,7 @@ void ModelLoader::loadObj(
     ABORT(warn + err);
   }
 
-  std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+  VertexDeduplicator deduplicator(vertices, indices);
 
   for (const auto& shape : shapes) {
     for (const auto& index : shape.mesh.indices) {
@@ -38,12 +58,7 @@ void ModelLoader::loadObj(
 
       vertex.color = {1.0f, 1.0f, 1.0f};
 
-      if (uniqueVertices.count(vertex) == 0) {
-        uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-        vertices.emplace_back(vertex);
-      }
-
-      indices.emplace_back(uniqueVertices[vertex]);
+      deduplicator.add(vertex);
     }
   }
 }
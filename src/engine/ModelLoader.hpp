@@ -2,11 +2,34 @@
 #define MODEL_LOADER_HPP
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Vertex.hpp"
 
 namespace engine {
 
+/**
+ * Builds an indexed mesh out of a stream of vertices, storing each distinct
+ * vertex once.
+ */
+class VertexDeduplicator {
+ public:
+  VertexDeduplicator(
+      std::vector<Vertex>& vertices, std::vector<uint32_t>& indices
+  );
+
+  /**
+   * Appends the index of vertex, and the vertex itself if it is new
+   */
+  void add(const Vertex& vertex);
+
+ private:
+  std::vector<Vertex>& m_vertices;
+  std::vector<uint32_t>& m_indices;
+  std::unordered_map<Vertex, uint32_t> m_uniqueVertices;
+};
+
 class ModelLoader {
  public:
   static void loadObj(
@@ -0,0 +1,461 @@
+#include "OcclusionCulling.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "EmbeddedShaders.hpp"
+
+namespace engine {
+namespace {
+constexpr uint32_t PYRAMID_GROUP_SIZE = 8;
+constexpr uint32_t CULL_GROUP_SIZE = 64;
+
+/**
+ * Matches the push constants of depth_pyramid.comp
+ */
+struct PyramidPushConstants {
+  int32_t sourceWidth;
+  int32_t sourceHeight;
+  int32_t width;
+  int32_t height;
+  int32_t sampleCount;
+};
+
+/**
+ * Matches the push constants of occlusion_cull.comp
+ */
+struct CullPushConstants {
+  glm::mat4 pyramidViewProjection;
+  float viewportWidth;
+  float viewportHeight;
+  uint32_t chunkCount;
+  uint32_t levelCount;
+  uint32_t early;
+};
+
+uint32_t divideRoundingUp(uint32_t value, uint32_t divisor) {
+  return (value + divisor - 1) / divisor;
+}
+
+VkExtent2D halve(VkExtent2D extent) {
+  return {
+      std::max(divideRoundingUp(extent.width, 2), 1u),
+      std::max(divideRoundingUp(extent.height, 2), 1u)};
+}
+
+/**
+ * Global memory dependency, between the pyramid levels the render graph
+ * tracks as one image
+ */
+void recordMemoryBarrier(
+    VkCommandBuffer commandBuffer,
+    VkPipelineStageFlags srcStages,
+    VkAccessFlags srcAccess,
+    VkPipelineStageFlags dstStages,
+    VkAccessFlags dstAccess
+) {
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = srcAccess;
+  barrier.dstAccessMask = dstAccess;
+
+  vkCmdPipelineBarrier(
+      commandBuffer,
+      srcStages,
+      dstStages,
+      0,
+      1,
+      &barrier,
+      0,
+      nullptr,
+      0,
+      nullptr
+  );
+}
+}  // namespace
+
+OcclusionCulling::OcclusionCulling(VkDevice device) : m_device(device) {
+  // The shaders only fetch texels, so filtering never matters
+  VkSamplerCreateInfo samplerInfo{};
+  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  samplerInfo.magFilter = VK_FILTER_NEAREST;
+  samplerInfo.minFilter = VK_FILTER_NEAREST;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+  m_sampler = std::make_unique<Sampler>(m_device, samplerInfo);
+
+  // Every level is built from a sampled view of the one below, level 0 from
+  // the depth attachment
+  m_pyramidSetLayout = createSetLayout(
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE}
+  );
+  m_pyramidPipelineLayout = createPipelineLayout(
+      *m_pyramidSetLayout, sizeof(PyramidPushConstants)
+  );
+
+  m_pyramidShader = createShaderModule(
+      EmbeddedShaders::DEPTH_PYRAMID_COMP,
+      sizeof(EmbeddedShaders::DEPTH_PYRAMID_COMP)
+  );
+  m_multisampledPyramidShader = createShaderModule(
+      EmbeddedShaders::DEPTH_PYRAMID_MS_COMP,
+      sizeof(EmbeddedShaders::DEPTH_PYRAMID_MS_COMP)
+  );
+
+  m_pyramidPipeline =
+      createPipeline(*m_pyramidShader, *m_pyramidPipelineLayout);
+  m_multisampledPyramidPipeline =
+      createPipeline(*m_multisampledPyramidShader, *m_pyramidPipelineLayout);
+
+  m_cullSetLayout = createSetLayout(
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}
+  );
+  m_cullPipelineLayout =
+      createPipelineLayout(*m_cullSetLayout, sizeof(CullPushConstants));
+
+  m_cullShader = createShaderModule(
+      EmbeddedShaders::OCCLUSION_CULL_COMP,
+      sizeof(EmbeddedShaders::OCCLUSION_CULL_COMP)
+  );
+  m_cullPipeline = createPipeline(*m_cullShader, *m_cullPipelineLayout);
+
+  SPDLOG_DEBUG("Created occlusion culling pipelines");
+}
+
+OcclusionCulling::Chunks OcclusionCulling::buildChunks(
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& indices,
+    uint32_t trianglesPerChunk
+) {
+  Chunks chunks;
+  uint32_t indexCount = static_cast<uint32_t>(indices.size());
+  uint32_t chunkIndices = trianglesPerChunk * 3;
+
+  for (uint32_t first = 0; first < indexCount; first += chunkIndices) {
+    VkDrawIndexedIndirectCommand draw{};
+    draw.indexCount = std::min(chunkIndices, indexCount - first);
+    draw.instanceCount = 1;
+    draw.firstIndex = first;
+    draw.vertexOffset = 0;
+    draw.firstInstance = 0;
+
+    glm::vec3 lower(std::numeric_limits<float>::max());
+    glm::vec3 upper(std::numeric_limits<float>::lowest());
+
+    for (uint32_t i = first; i < first + draw.indexCount; ++i) {
+      lower = glm::min(lower, vertices[indices[i]].pos);
+      upper = glm::max(upper, vertices[indices[i]].pos);
+    }
+
+    chunks.draws.push_back(draw);
+    chunks.bounds.push_back({glm::vec4(lower, 1.0f), glm::vec4(upper, 1.0f)});
+  }
+
+  SPDLOG_DEBUG(
+      "Split {} triangles into {} chunks for occlusion culling",
+      indexCount / 3,
+      chunks.draws.size()
+  );
+
+  return chunks;
+}
+
+VkExtent2D OcclusionCulling::getPyramidExtent(VkExtent2D depthExtent) {
+  return halve(depthExtent);
+}
+
+uint32_t OcclusionCulling::getPyramidLevelCount(VkExtent2D pyramidExtent) {
+  uint32_t size = std::max(pyramidExtent.width, pyramidExtent.height);
+  uint32_t levels = 1;
+
+  while (size > 1) {
+    size /= 2;
+    ++levels;
+  }
+
+  return levels;
+}
+
+void OcclusionCulling::recordPyramidBuild(
+    VkCommandBuffer commandBuffer,
+    DescriptorAllocator& allocator,
+    VkImageView depth,
+    VkSampleCountFlagBits depthSamples,
+    const std::vector<VkImageView>& levels,
+    VkExtent2D sceneExtent
+) {
+  VkExtent2D sourceExtent = sceneExtent;
+
+  for (size_t level = 0; level < levels.size(); ++level) {
+    bool fromDepth = level == 0;
+
+    VkDescriptorImageInfo source{};
+    source.sampler = *m_sampler;
+    source.imageView = fromDepth ? depth : levels[level - 1];
+    source.imageLayout = fromDepth ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                   : VK_IMAGE_LAYOUT_GENERAL;
+
+    VkDescriptorImageInfo destination{};
+    destination.imageView = levels[level];
+    destination.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    VkDescriptorSet set = allocator.allocate(*m_pyramidSetLayout);
+
+    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[0].dstSet = set;
+    writes[0].dstBinding = 0;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[0].pImageInfo = &source;
+
+    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[1].dstSet = set;
+    writes[1].dstBinding = 1;
+    writes[1].descriptorCount = 1;
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    writes[1].pImageInfo = &destination;
+
+    vkUpdateDescriptorSets(
+        m_device,
+        static_cast<uint32_t>(writes.size()),
+        writes.data(),
+        0,
+        nullptr
+    );
+
+    // Each level waits for the one below it
+    if (!fromDepth) {
+      recordMemoryBarrier(
+          commandBuffer,
+          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VK_ACCESS_SHADER_WRITE_BIT,
+          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VK_ACCESS_SHADER_READ_BIT
+      );
+    }
+
+    bool multisampled = fromDepth && depthSamples != VK_SAMPLE_COUNT_1_BIT;
+
+    vkCmdBindPipeline(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        multisampled ? *m_multisampledPyramidPipeline : *m_pyramidPipeline
+    );
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        *m_pyramidPipelineLayout,
+        0,
+        1,
+        &set,
+        0,
+        nullptr
+    );
+
+    VkExtent2D extent = halve(sourceExtent);
+
+    PyramidPushConstants reduce{};
+    reduce.sourceWidth = static_cast<int32_t>(sourceExtent.width);
+    reduce.sourceHeight = static_cast<int32_t>(sourceExtent.height);
+    reduce.width = static_cast<int32_t>(extent.width);
+    reduce.height = static_cast<int32_t>(extent.height);
+    reduce.sampleCount = static_cast<int32_t>(depthSamples);
+
+    vkCmdPushConstants(
+        commandBuffer,
+        *m_pyramidPipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(reduce),
+        &reduce
+    );
+
+    vkCmdDispatch(
+        commandBuffer,
+        divideRoundingUp(extent.width, PYRAMID_GROUP_SIZE),
+        divideRoundingUp(extent.height, PYRAMID_GROUP_SIZE),
+        1
+    );
+
+    sourceExtent = extent;
+  }
+}
+
+void OcclusionCulling::recordCulling(
+    VkCommandBuffer commandBuffer,
+    DescriptorAllocator& allocator,
+    const VkDescriptorBufferInfo& uniformBuffer,
+    VkImageView pyramid,
+    uint32_t pyramidLevels,
+    VkExtent2D sceneExtent,
+    const DrawLists& drawLists,
+    const std::optional<glm::mat4>& pyramidViewProjection
+) {
+  VkDescriptorImageInfo pyramidInfo{};
+  pyramidInfo.sampler = *m_sampler;
+  pyramidInfo.imageView = pyramid;
+  pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  std::array<VkDescriptorBufferInfo, 3> buffers{};
+  buffers[0].buffer = drawLists.bounds;
+  buffers[1].buffer = drawLists.visible;
+  buffers[2].buffer = drawLists.disoccluded;
+
+  for (auto& buffer : buffers) {
+    buffer.offset = 0;
+    buffer.range = VK_WHOLE_SIZE;
+  }
+
+  VkDescriptorSet set = allocator.allocate(*m_cullSetLayout);
+  std::array<VkWriteDescriptorSet, 3> writes{};
+
+  writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[0].dstSet = set;
+  writes[0].dstBinding = 0;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  writes[0].pBufferInfo = &uniformBuffer;
+
+  writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[1].dstSet = set;
+  writes[1].dstBinding = 1;
+  writes[1].descriptorCount = 1;
+  writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  writes[1].pImageInfo = &pyramidInfo;
+
+  // Consecutive bindings of one type are written as one array
+  writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[2].dstSet = set;
+  writes[2].dstBinding = 2;
+  writes[2].descriptorCount = static_cast<uint32_t>(buffers.size());
+  writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  writes[2].pBufferInfo = buffers.data();
+
+  vkUpdateDescriptorSets(
+      m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr
+  );
+
+  vkCmdBindPipeline(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, *m_cullPipeline
+  );
+
+  vkCmdBindDescriptorSets(
+      commandBuffer,
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      *m_cullPipelineLayout,
+      0,
+      1,
+      &set,
+      0,
+      nullptr
+  );
+
+  CullPushConstants cull{};
+  cull.pyramidViewProjection = pyramidViewProjection.value_or(glm::mat4(1.0f));
+  cull.early = pyramidViewProjection ? 1 : 0;
+  cull.viewportWidth = static_cast<float>(sceneExtent.width);
+  cull.viewportHeight = static_cast<float>(sceneExtent.height);
+  cull.chunkCount = drawLists.chunkCount;
+  cull.levelCount = pyramidLevels;
+
+  vkCmdPushConstants(
+      commandBuffer,
+      *m_cullPipelineLayout,
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      0,
+      sizeof(cull),
+      &cull
+  );
+
+  vkCmdDispatch(
+      commandBuffer,
+      divideRoundingUp(drawLists.chunkCount, CULL_GROUP_SIZE),
+      1,
+      1
+  );
+}
+
+bool OcclusionCulling::isSupported(VkPhysicalDevice physicalDevice) {
+  VkPhysicalDeviceFeatures features;
+  vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+
+  return features.multiDrawIndirect == VK_TRUE;
+}
+
+std::unique_ptr<ShaderModule> OcclusionCulling::createShaderModule(
+    const uint32_t* code, size_t size
+) const {
+  VkShaderModuleCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  createInfo.codeSize = size;
+  createInfo.pCode = code;
+
+  return std::make_unique<ShaderModule>(m_device, createInfo);
+}
+
+std::unique_ptr<ComputePipeline> OcclusionCulling::createPipeline(
+    VkShaderModule shader, VkPipelineLayout layout
+) const {
+  VkComputePipelineCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  createInfo.stage.module = shader;
+  createInfo.stage.pName = "main";
+  createInfo.layout = layout;
+
+  return std::make_unique<ComputePipeline>(m_device, createInfo);
+}
+
+std::unique_ptr<DescriptorSetLayout> OcclusionCulling::createSetLayout(
+    const std::vector<VkDescriptorType>& types
+) const {
+  std::vector<VkDescriptorSetLayoutBinding> bindings(types.size());
+
+  for (uint32_t i = 0; i < bindings.size(); ++i) {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = types[i];
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  }
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+
+  return std::make_unique<DescriptorSetLayout>(m_device, layoutInfo);
+}
+
+std::unique_ptr<PipelineLayout> OcclusionCulling::createPipelineLayout(
+    VkDescriptorSetLayout setLayout, uint32_t pushConstantSize
+) const {
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = pushConstantSize;
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &setLayout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+  return std::make_unique<PipelineLayout>(m_device, pipelineLayoutInfo);
+}
+}  // namespace engine
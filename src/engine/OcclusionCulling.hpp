@@ -0,0 +1,178 @@
+#ifndef OCCLUSION_CULLING_HPP
+#define OCCLUSION_CULLING_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "DescriptorAllocator.hpp"
+#include "Vertex.hpp"
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * Two-phase hierarchical-Z occlusion culling on the GPU.
+ *
+ * The mesh is cut into chunks of consecutive triangles, each with its own
+ * bounds and its own command in an indirect draw. A frame then goes:
+ *
+ * 1. the chunks visible in the last frame are drawn into depth
+ * 2. recordPyramidBuild() reduces that depth into a pyramid where every texel
+ *    holds the farthest depth below it
+ * 3. recordCulling() tests every chunk against the frustum and the pyramid
+ *    and rewrites the visible list, and the disoccluded list of the chunks
+ *    visible now that were not drawn in step 1
+ * 4. the disoccluded chunks are drawn into depth as well
+ * 5. the visible list is shaded
+ *
+ * Chunks coming into view are drawn in the same frame instead of a frame
+ * late, and nothing is read back to the CPU.
+ *
+ * Step 1 can also draw the chunks an early culling found visible, against the
+ * pyramid of the previous frame seen from that frame's camera, instead of the
+ * chunks of the last frame. The early culling does not depend on the depth of
+ * its own frame, so it can run while the previous frame is still shaded.
+ */
+class OcclusionCulling {
+ public:
+  /**
+   * Model space box of a chunk, laid out like the shader's std430 struct
+   */
+  struct ChunkBounds {
+    glm::vec4 min;
+    glm::vec4 max;
+  };
+
+  struct Chunks {
+    /**
+     * One command per chunk, every instance count 1
+     */
+    std::vector<VkDrawIndexedIndirectCommand> draws;
+    std::vector<ChunkBounds> bounds;
+  };
+
+  /**
+   * Buffers of the chunks, created by the user from buildChunks(). The draw
+   * lists need VK_BUFFER_USAGE_STORAGE_BUFFER_BIT and
+   * VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, the bounds the former.
+   */
+  struct DrawLists {
+    VkBuffer bounds = VK_NULL_HANDLE;
+    VkBuffer visible = VK_NULL_HANDLE;
+    VkBuffer disoccluded = VK_NULL_HANDLE;
+    uint32_t chunkCount = 0;
+  };
+
+  explicit OcclusionCulling(VkDevice device);
+
+  /**
+   * @param indices triangle list, chunks take consecutive triangles of it
+   */
+  static Chunks buildChunks(
+      const std::vector<Vertex>& vertices,
+      const std::vector<uint32_t>& indices,
+      uint32_t trianglesPerChunk
+  );
+
+  /**
+   * Level 0 of the pyramid is half the size of the depth attachment
+   */
+  static VkExtent2D getPyramidExtent(VkExtent2D depthExtent);
+
+  static uint32_t getPyramidLevelCount(VkExtent2D pyramidExtent);
+
+  /**
+   * Reduces depth into every level of the pyramid. Depth has to be readable
+   * by compute shaders and the pyramid in VK_IMAGE_LAYOUT_GENERAL.
+   *
+   * @param depth sampled view of the depth attachment
+   * @param levels view of every pyramid level
+   * @param sceneExtent part of the depth attachment the scene covers
+   */
+  void recordPyramidBuild(
+      VkCommandBuffer commandBuffer,
+      DescriptorAllocator& allocator,
+      VkImageView depth,
+      VkSampleCountFlagBits depthSamples,
+      const std::vector<VkImageView>& levels,
+      VkExtent2D sceneExtent
+  );
+
+  /**
+   * Rewrites both draw lists. The visible list is read first, so the caller
+   * synchronizes both lists as written by compute shaders, and their indirect
+   * draws with the writes.
+   *
+   * @param uniformBuffer UniformBufferObject the frame is drawn with
+   * @param pyramid view of every level, readable by compute shaders
+   * @param pyramidLevels 0 to only cull against the frustum, while the
+   * pyramid holds nothing yet
+   * @param sceneExtent part of the depth attachment the scene covered when
+   * the pyramid was built
+   * @param pyramidViewProjection camera of the previous frame the pyramid was
+   * built in, for the early culling. Only the visible list is rewritten then,
+   * for the pre-pass.
+   */
+  void recordCulling(
+      VkCommandBuffer commandBuffer,
+      DescriptorAllocator& allocator,
+      const VkDescriptorBufferInfo& uniformBuffer,
+      VkImageView pyramid,
+      uint32_t pyramidLevels,
+      VkExtent2D sceneExtent,
+      const DrawLists& drawLists,
+      const std::optional<glm::mat4>& pyramidViewProjection = std::nullopt
+  );
+
+  /**
+   * Whether the device can draw a list of chunks with one indirect call
+   */
+  static bool isSupported(VkPhysicalDevice physicalDevice);
+
+ private:
+  VkDevice m_device;
+
+  std::unique_ptr<Sampler> m_sampler;
+
+  std::unique_ptr<DescriptorSetLayout> m_pyramidSetLayout;
+  std::unique_ptr<PipelineLayout> m_pyramidPipelineLayout;
+  std::unique_ptr<ShaderModule> m_pyramidShader;
+  std::unique_ptr<ShaderModule> m_multisampledPyramidShader;
+  std::unique_ptr<ComputePipeline> m_pyramidPipeline;
+  /**
+   * Reads every sample of a multisampled depth attachment into level 0
+   */
+  std::unique_ptr<ComputePipeline> m_multisampledPyramidPipeline;
+
+  std::unique_ptr<DescriptorSetLayout> m_cullSetLayout;
+  std::unique_ptr<PipelineLayout> m_cullPipelineLayout;
+  std::unique_ptr<ShaderModule> m_cullShader;
+  std::unique_ptr<ComputePipeline> m_cullPipeline;
+
+  std::unique_ptr<ShaderModule> createShaderModule(
+      const uint32_t* code, size_t size
+  ) const;
+
+  std::unique_ptr<ComputePipeline> createPipeline(
+      VkShaderModule shader, VkPipelineLayout layout
+  ) const;
+
+  /**
+   * Set layout of compute shaders reading the given descriptors in order
+   */
+  std::unique_ptr<DescriptorSetLayout> createSetLayout(
+      const std::vector<VkDescriptorType>& types
+  ) const;
+
+  std::unique_ptr<PipelineLayout> createPipelineLayout(
+      VkDescriptorSetLayout setLayout, uint32_t pushConstantSize
+  ) const;
+};
+
+}  // namespace engine
+
+#endif  // OCCLUSION_CULLING_HPP
@@ -1,6 +1,9 @@
 #include "PhysicalDevice.hpp"
 
+#include <cstring>
+
 #include "Abort.hpp"
+#include "VulkanDoubleCallWrapper.hpp"
 
 namespace engine {
 
@@ -32,4 +35,42 @@ std::vector<VkQueueFamilyProperties> PhysicalDevice::enumerateQueueFamilies(
   return queueFamilies;
 }
 
+bool PhysicalDevice::isExtensionSupported(
+    VkPhysicalDevice device, const char* extensionName
+) {
+  std::vector availableExtensions =
+      vkCall(vkEnumerateDeviceExtensionProperties, device, nullptr);
+
+  for (const auto& extension : availableExtensions) {
+    if (std::strcmp(extension.extensionName, extensionName) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+uint32_t PhysicalDevice::findMemoryType(
+    VkPhysicalDevice device,
+    uint32_t typeFilter,
+    VkMemoryPropertyFlags properties,
+    VkMemoryPropertyFlags preferredProperties
+) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(device, &memProperties);
+
+  for (VkMemoryPropertyFlags required :
+       {properties | preferredProperties, properties}) {
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+      if ((typeFilter & (1 << i)) &&
+          (memProperties.memoryTypes[i].propertyFlags & required) ==
+              required) {
+        return i;
+      }
+    }
+  }
+
+  ABORT("Failed to find suitable memory type");
+}
+
 }  // namespace engine
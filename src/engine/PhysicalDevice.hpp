@@ -16,6 +16,21 @@ class PhysicalDevice {
   static std::vector<VkQueueFamilyProperties> enumerateQueueFamilies(
       VkPhysicalDevice device
   );
+
+  static bool isExtensionSupported(
+      VkPhysicalDevice device, const char* extensionName
+  );
+
+  /**
+   * Picks a memory type allowed by typeFilter with properties, preferring one
+   * that also has preferredProperties
+   */
+  static uint32_t findMemoryType(
+      VkPhysicalDevice device,
+      uint32_t typeFilter,
+      VkMemoryPropertyFlags properties,
+      VkMemoryPropertyFlags preferredProperties = 0
+  );
 };
 
 }  // namespace engine
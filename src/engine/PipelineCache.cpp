@@ -0,0 +1,178 @@
+#include "PipelineCache.hpp"
+
+#include <utility>
+
+#include "Config.hpp"
+#include "PipelineState.hpp"
+
+namespace engine {
+using Clock = std::chrono::steady_clock;
+
+PipelineCache::PipelineCache(VkDevice device, bool usePipelineLibrary)
+    : m_device(device) {
+  if (usePipelineLibrary) {
+    m_library = std::make_unique<PipelineLibrary>(device);
+  }
+}
+
+PipelineCache::~PipelineCache() {
+  SPDLOG_INFO(
+      "Pipeline cache: {} pipelines, {} hits, {} misses",
+      m_pipelines.size(),
+      m_stats.hits,
+      m_stats.misses
+  );
+
+  SPDLOG_INFO(
+      "Pipeline cache: {} full compiles ({:.2f}ms), {} fast links ({:.2f}ms), "
+      "{} optimized links ({:.2f}ms)",
+      m_stats.fullCompiles,
+      m_stats.fullCompileTime.count(),
+      m_stats.fastLinks,
+      m_stats.fastLinkTime.count(),
+      m_stats.optimizedLinks,
+      m_stats.optimizedLinkTime.count()
+  );
+}
+
+const GraphicsPipeline& PipelineCache::get(const PipelineKey& key) {
+  auto it = m_pipelines.find(key);
+
+  if (it != m_pipelines.end()) {
+    m_stats.hits++;
+    return *it->second;
+  }
+
+  m_stats.misses++;
+
+  auto pipeline = m_library ? fastLink(key) : compile(key);
+
+  SPDLOG_DEBUG(
+      "Pipeline cache miss {:#018x} ({} pipelines)",
+      key.hash(),
+      m_pipelines.size() + 1
+  );
+
+  if (m_pipelines.size() + 1 > Config::PIPELINE_PERMUTATION_WARNING_THRESHOLD) {
+    SPDLOG_WARN(
+        "{} pipeline permutations created at runtime, expected at most {}",
+        m_pipelines.size() + 1,
+        Config::PIPELINE_PERMUTATION_WARNING_THRESHOLD
+    );
+  }
+
+  return *m_pipelines.emplace(key, std::move(pipeline)).first->second;
+}
+
+void PipelineCache::update() {
+  for (auto it = m_pending.begin(); it != m_pending.end();) {
+    if (it->result.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      ++it;
+      continue;
+    }
+
+    OptimizedPipeline optimized = it->result.get();
+    m_stats.optimizedLinks++;
+    m_stats.optimizedLinkTime += optimized.buildTime;
+
+    auto current = m_pipelines.find(it->key);
+
+    if (current == m_pipelines.end()) {
+      // The key was evicted by replaceShader while this one was building
+      m_retired.emplace_back(std::move(optimized.pipeline));
+    } else {
+      m_retired.emplace_back(std::move(current->second));
+      current->second = std::move(optimized.pipeline);
+
+      SPDLOG_DEBUG(
+          "Swapped in optimized pipeline {:#018x} ({:.2f}ms)",
+          it->key.hash(),
+          optimized.buildTime.count()
+      );
+    }
+
+    it = m_pending.erase(it);
+  }
+}
+
+std::vector<std::unique_ptr<GraphicsPipeline>> PipelineCache::takeRetired() {
+  return std::exchange(m_retired, {});
+}
+
+std::size_t PipelineCache::replaceShader(
+    VkShaderModule oldModule, VkShaderModule newModule
+) {
+  std::vector<PipelineKey> affected;
+
+  for (const auto& [key, pipeline] : m_pipelines) {
+    if (key.vertexShader == oldModule || key.fragmentShader == oldModule) {
+      affected.push_back(key);
+    }
+  }
+
+  if (m_library) {
+    m_library->evictShader(oldModule, m_retired);
+  }
+
+  for (const auto& key : affected) {
+    auto node = m_pipelines.extract(key);
+    m_retired.emplace_back(std::move(node.mapped()));
+
+    PipelineKey newKey = key;
+
+    if (newKey.vertexShader == oldModule) {
+      newKey.vertexShader = newModule;
+    }
+
+    if (newKey.fragmentShader == oldModule) {
+      newKey.fragmentShader = newModule;
+    }
+
+    get(newKey);
+  }
+
+  return affected.size();
+}
+
+std::unique_ptr<GraphicsPipeline> PipelineCache::compile(
+    const PipelineKey& key
+) {
+  auto start = Clock::now();
+
+  PipelineState state(key);
+  auto pipeline =
+      std::make_unique<GraphicsPipeline>(m_device, state.getCreateInfo());
+
+  m_stats.fullCompiles++;
+  m_stats.fullCompileTime += Clock::now() - start;
+
+  return pipeline;
+}
+
+std::unique_ptr<GraphicsPipeline> PipelineCache::fastLink(
+    const PipelineKey& key
+) {
+  auto start = Clock::now();
+
+  PipelineLibrary::Parts parts = m_library->getParts(key);
+  auto pipeline = m_library->link(parts, key.layout, false);
+
+  m_stats.fastLinks++;
+  m_stats.fastLinkTime += Clock::now() - start;
+
+  const PipelineLibrary* library = m_library.get();
+  VkPipelineLayout layout = key.layout;
+
+  m_pending.push_back(
+      {key, std::async(std::launch::async, [library, parts, layout] {
+         auto begin = Clock::now();
+         auto optimized = library->link(parts, layout, true);
+         return OptimizedPipeline{
+             std::move(optimized), Milliseconds(Clock::now() - begin)};
+       })}
+  );
+
+  return pipeline;
+}
+}  // namespace engine
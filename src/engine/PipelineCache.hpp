@@ -0,0 +1,97 @@
+#ifndef PIPELINE_CACHE_HPP
+#define PIPELINE_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "PipelineKey.hpp"
+#include "PipelineLibrary.hpp"
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * In-memory graphics pipeline cache. Pipelines are created lazily the first
+ * time their key is requested and reused afterwards.
+ *
+ * When a PipelineLibrary is available, missing pipelines are fast-linked from
+ * precompiled parts and a link time optimized replacement is built on a
+ * background thread. Call update() once per frame to swap finished
+ * replacements in.
+ */
+class PipelineCache {
+ public:
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t fullCompiles = 0;
+    Milliseconds fullCompileTime{};
+    uint64_t fastLinks = 0;
+    Milliseconds fastLinkTime{};
+    uint64_t optimizedLinks = 0;
+    Milliseconds optimizedLinkTime{};
+  };
+
+  PipelineCache(VkDevice device, bool usePipelineLibrary);
+
+  ~PipelineCache();
+
+  const GraphicsPipeline& get(const PipelineKey& key);
+
+  void update();
+
+  /**
+   * Rebuilds every cached pipeline that uses oldModule with newModule in its
+   * place.
+   * @return the number of rebuilt pipelines
+   */
+  std::size_t replaceShader(VkShaderModule oldModule, VkShaderModule newModule);
+
+  /**
+   * Hands over the pipelines replaced since the last call. Command buffers in
+   * flight may still use them, so the caller defers their destruction.
+   */
+  [[nodiscard]] std::vector<std::unique_ptr<GraphicsPipeline>> takeRetired();
+
+  [[nodiscard]] const Stats& getStats() const { return m_stats; }
+
+  [[nodiscard]] std::size_t size() const { return m_pipelines.size(); }
+
+ private:
+  struct OptimizedPipeline {
+    std::unique_ptr<GraphicsPipeline> pipeline;
+    Milliseconds buildTime;
+  };
+
+  struct PendingPipeline {
+    PipelineKey key;
+    std::future<OptimizedPipeline> result;
+  };
+
+  VkDevice m_device;
+  std::unique_ptr<PipelineLibrary> m_library;
+  std::unordered_map<PipelineKey, std::unique_ptr<GraphicsPipeline>>
+      m_pipelines;
+  // Pipelines replaced by an optimized or rebuilt version, until takeRetired
+  std::vector<std::unique_ptr<GraphicsPipeline>> m_retired;
+  // Declared after m_library so pending background builds finish before the
+  // library parts they link are destroyed
+  std::vector<PendingPipeline> m_pending;
+  Stats m_stats;
+
+  std::unique_ptr<GraphicsPipeline> compile(const PipelineKey& key);
+
+  std::unique_ptr<GraphicsPipeline> fastLink(const PipelineKey& key);
+};
+
+}  // namespace engine
+
+#endif  // PIPELINE_CACHE_HPP
@@ -0,0 +1,74 @@
+#include "PipelineKey.hpp"
+
+#include "Hash.hpp"
+
+namespace engine {
+namespace {
+bool operator==(
+    const VkVertexInputAttributeDescription& a,
+    const VkVertexInputAttributeDescription& b
+) {
+  return a.location == b.location && a.binding == b.binding &&
+         a.format == b.format && a.offset == b.offset;
+}
+}  // namespace
+
+std::size_t PipelineKey::hash() const {
+  Fnv1a hasher;
+
+  hasher.add(vertexShader).add(fragmentShader);
+
+  hasher.add(vertexBinding.binding)
+      .add(vertexBinding.stride)
+      .add(vertexBinding.inputRate);
+
+  for (uint32_t i = 0; i < vertexAttributeCount; ++i) {
+    const auto& attribute = vertexAttributes[i];
+    hasher.add(attribute.location)
+        .add(attribute.binding)
+        .add(attribute.format)
+        .add(attribute.offset);
+  }
+
+  hasher.add(vertexAttributeCount).add(topology);
+  hasher.add(polygonMode).add(cullMode).add(frontFace);
+  hasher.add(depthTestEnable).add(depthWriteEnable).add(depthCompareOp);
+  hasher.add(colorAttachmentCount).add(blendEnable).add(colorWriteMask);
+  hasher.add(sampleCount).add(sampleShadingEnable).add(minSampleShading);
+  hasher.add(layout).add(renderPass).add(subpass);
+  hasher.add(colorFormat).add(depthFormat);
+
+  return static_cast<std::size_t>(hasher.value());
+}
+
+bool PipelineKey::operator==(const PipelineKey& other) const {
+  if (vertexAttributeCount != other.vertexAttributeCount) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < vertexAttributeCount; ++i) {
+    if (!(vertexAttributes[i] == other.vertexAttributes[i])) {
+      return false;
+    }
+  }
+
+  return vertexShader == other.vertexShader &&
+         fragmentShader == other.fragmentShader &&
+         vertexBinding.binding == other.vertexBinding.binding &&
+         vertexBinding.stride == other.vertexBinding.stride &&
+         vertexBinding.inputRate == other.vertexBinding.inputRate &&
+         topology == other.topology && polygonMode == other.polygonMode &&
+         cullMode == other.cullMode && frontFace == other.frontFace &&
+         depthTestEnable == other.depthTestEnable &&
+         depthWriteEnable == other.depthWriteEnable &&
+         depthCompareOp == other.depthCompareOp &&
+         colorAttachmentCount == other.colorAttachmentCount &&
+         blendEnable == other.blendEnable &&
+         colorWriteMask == other.colorWriteMask &&
+         sampleCount == other.sampleCount &&
+         sampleShadingEnable == other.sampleShadingEnable &&
+         minSampleShading == other.minSampleShading && layout == other.layout &&
+         renderPass == other.renderPass && subpass == other.subpass &&
+         colorFormat == other.colorFormat && depthFormat == other.depthFormat;
+}
+}  // namespace engine
@@ -0,0 +1,94 @@
+#ifndef PIPELINE_KEY_HPP
+#define PIPELINE_KEY_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace engine {
+
+/**
+ * Describes every piece of state that makes two graphics pipelines different.
+ * Two equal keys always produce interchangeable pipelines, so a key can be
+ * used to look up an already compiled pipeline instead of building a new one.
+ */
+struct PipelineKey {
+  static constexpr std::size_t MAX_VERTEX_ATTRIBUTES = 8;
+
+  VkShaderModule vertexShader = VK_NULL_HANDLE;
+  VkShaderModule fragmentShader = VK_NULL_HANDLE;
+
+  VkVertexInputBindingDescription vertexBinding{};
+  std::array<VkVertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES>
+      vertexAttributes{};
+  uint32_t vertexAttributeCount = 0;
+  VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+  VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+  VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+  VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+  VkBool32 depthTestEnable = VK_TRUE;
+  VkBool32 depthWriteEnable = VK_TRUE;
+  VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+
+  /**
+   * 0 for depth-only passes
+   */
+  uint32_t colorAttachmentCount = 1;
+  VkBool32 blendEnable = VK_FALSE;
+  VkColorComponentFlags colorWriteMask =
+      VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+      VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+  VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+  VkBool32 sampleShadingEnable = VK_FALSE;
+  float minSampleShading = 0.0f;
+
+  VkPipelineLayout layout = VK_NULL_HANDLE;
+  VkRenderPass renderPass = VK_NULL_HANDLE;
+  uint32_t subpass = 0;
+
+  /**
+   * Attachment formats of dynamic rendering, which pipelines without a
+   * renderPass are created for
+   */
+  VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+  VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+  template <std::size_t N>
+  void setVertexLayout(
+      const VkVertexInputBindingDescription& binding,
+      const std::array<VkVertexInputAttributeDescription, N>& attributes
+  ) {
+    static_assert(N <= MAX_VERTEX_ATTRIBUTES, "Too many vertex attributes");
+
+    vertexBinding = binding;
+    vertexAttributes = {};
+    vertexAttributeCount = static_cast<uint32_t>(N);
+
+    for (std::size_t i = 0; i < N; ++i) {
+      vertexAttributes[i] = attributes[i];
+    }
+  }
+
+  [[nodiscard]] std::size_t hash() const;
+
+  bool operator==(const PipelineKey& other) const;
+
+  bool operator!=(const PipelineKey& other) const { return !(*this == other); }
+};
+
+}  // namespace engine
+
+namespace std {
+template <>
+struct hash<engine::PipelineKey> {
+  size_t operator()(engine::PipelineKey const& key) const { return key.hash(); }
+};
+}  // namespace std
+
+#endif  // PIPELINE_KEY_HPP
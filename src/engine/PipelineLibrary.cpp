@@ -0,0 +1,217 @@
+#include "PipelineLibrary.hpp"
+
+#include "PhysicalDevice.hpp"
+#include "PipelineState.hpp"
+
+namespace engine {
+namespace {
+PipelineKey vertexInputKey(const PipelineKey& key) {
+  PipelineKey part;
+  part.vertexBinding = key.vertexBinding;
+  part.vertexAttributes = key.vertexAttributes;
+  part.vertexAttributeCount = key.vertexAttributeCount;
+  part.topology = key.topology;
+  return part;
+}
+
+PipelineKey preRasterizationKey(const PipelineKey& key) {
+  PipelineKey part;
+  part.vertexShader = key.vertexShader;
+  part.polygonMode = key.polygonMode;
+  part.cullMode = key.cullMode;
+  part.frontFace = key.frontFace;
+  part.layout = key.layout;
+  part.renderPass = key.renderPass;
+  part.subpass = key.subpass;
+  return part;
+}
+
+PipelineKey fragmentShaderKey(const PipelineKey& key) {
+  PipelineKey part;
+  part.fragmentShader = key.fragmentShader;
+  part.depthTestEnable = key.depthTestEnable;
+  part.depthWriteEnable = key.depthWriteEnable;
+  part.depthCompareOp = key.depthCompareOp;
+  part.sampleCount = key.sampleCount;
+  part.sampleShadingEnable = key.sampleShadingEnable;
+  part.minSampleShading = key.minSampleShading;
+  part.layout = key.layout;
+  part.renderPass = key.renderPass;
+  part.subpass = key.subpass;
+  part.depthFormat = key.depthFormat;
+  return part;
+}
+
+PipelineKey fragmentOutputKey(const PipelineKey& key) {
+  PipelineKey part;
+  part.colorAttachmentCount = key.colorAttachmentCount;
+  part.blendEnable = key.blendEnable;
+  part.colorWriteMask = key.colorWriteMask;
+  part.sampleCount = key.sampleCount;
+  part.sampleShadingEnable = key.sampleShadingEnable;
+  part.minSampleShading = key.minSampleShading;
+  part.renderPass = key.renderPass;
+  part.subpass = key.subpass;
+  part.colorFormat = key.colorFormat;
+  part.depthFormat = key.depthFormat;
+  return part;
+}
+}  // namespace
+
+PipelineLibrary::PipelineLibrary(VkDevice device) : m_device(device) {}
+
+PipelineLibrary::Parts PipelineLibrary::getParts(const PipelineKey& key) {
+  return {
+      getPart(
+          m_vertexInputParts,
+          vertexInputKey(key),
+          VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT
+      ),
+      getPart(
+          m_preRasterizationParts,
+          preRasterizationKey(key),
+          VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT
+      ),
+      getPart(
+          m_fragmentShaderParts,
+          fragmentShaderKey(key),
+          VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+      ),
+      getPart(
+          m_fragmentOutputParts,
+          fragmentOutputKey(key),
+          VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+      ),
+  };
+}
+
+std::unique_ptr<GraphicsPipeline> PipelineLibrary::link(
+    const Parts& parts, VkPipelineLayout layout, bool optimize
+) const {
+  VkPipelineLibraryCreateInfoKHR libraryInfo{};
+  libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+  libraryInfo.libraryCount = static_cast<uint32_t>(parts.size());
+  libraryInfo.pLibraries = parts.data();
+
+  VkGraphicsPipelineCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  createInfo.pNext = &libraryInfo;
+  createInfo.flags =
+      optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+  createInfo.layout = layout;
+
+  return std::make_unique<GraphicsPipeline>(m_device, createInfo);
+}
+
+void PipelineLibrary::evictShader(
+    VkShaderModule module,
+    std::vector<std::unique_ptr<GraphicsPipeline>>& retired
+) {
+  for (PartCache* cache : {&m_preRasterizationParts, &m_fragmentShaderParts}) {
+    for (auto it = cache->begin(); it != cache->end();) {
+      if (it->first.vertexShader == module ||
+          it->first.fragmentShader == module) {
+        retired.emplace_back(std::move(it->second));
+        it = cache->erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+bool PipelineLibrary::isSupported(VkPhysicalDevice physicalDevice) {
+  if (!PhysicalDevice::isExtensionSupported(
+          physicalDevice, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME
+      ) ||
+      !PhysicalDevice::isExtensionSupported(
+          physicalDevice, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME
+      )) {
+    return false;
+  }
+
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT libraryFeatures{};
+  libraryFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &libraryFeatures;
+
+  vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+  return libraryFeatures.graphicsPipelineLibrary == VK_TRUE;
+}
+
+VkPipeline PipelineLibrary::getPart(
+    PartCache& cache,
+    const PipelineKey& partKey,
+    VkGraphicsPipelineLibraryFlagsEXT flags
+) {
+  auto it = cache.find(partKey);
+
+  if (it != cache.end()) {
+    return *it->second;
+  }
+
+  PipelineState state(partKey);
+
+  VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{};
+  libraryInfo.sType =
+      VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+  libraryInfo.flags = flags;
+
+  // Start from the monolithic create info and strip everything that does not
+  // belong to this part. Shader stages of other parts are not allowed at all.
+  VkGraphicsPipelineCreateInfo createInfo = state.getCreateInfo();
+  libraryInfo.pNext = createInfo.pNext;
+  createInfo.pNext = &libraryInfo;
+  createInfo.flags =
+      VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+      VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+  const VkPipelineShaderStageCreateInfo* stages = createInfo.pStages;
+  uint32_t stageCount = createInfo.stageCount;
+
+  createInfo.stageCount = 0;
+  createInfo.pStages = nullptr;
+
+  if (flags & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) {
+    createInfo.stageCount = 1;
+    createInfo.pStages = stages;
+  } else {
+    createInfo.pViewportState = nullptr;
+    createInfo.pRasterizationState = nullptr;
+    createInfo.pDynamicState = nullptr;
+  }
+
+  if (flags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) {
+    createInfo.stageCount = stageCount - 1;
+    createInfo.pStages = stageCount > 1 ? stages + 1 : nullptr;
+  } else {
+    createInfo.pDepthStencilState = nullptr;
+  }
+
+  if (!(flags & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT)) {
+    createInfo.pVertexInputState = nullptr;
+    createInfo.pInputAssemblyState = nullptr;
+  }
+
+  if (!(flags &
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT)) {
+    createInfo.pColorBlendState = nullptr;
+  }
+
+  if (!(flags & (VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT |
+                 VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+               ))) {
+    createInfo.pMultisampleState = nullptr;
+  }
+
+  auto part = std::make_unique<GraphicsPipeline>(m_device, createInfo);
+  VkPipeline handle = *part;
+  cache.emplace(partKey, std::move(part));
+
+  return handle;
+}
+}  // namespace engine
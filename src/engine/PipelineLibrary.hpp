@@ -0,0 +1,77 @@
+#ifndef PIPELINE_LIBRARY_HPP
+#define PIPELINE_LIBRARY_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "PipelineKey.hpp"
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * Builds graphics pipelines out of VK_EXT_graphics_pipeline_library parts.
+ * The vertex input, pre-rasterization, fragment shader and fragment output
+ * parts of a PipelineKey are compiled once and shared by every key using the
+ * same part, so a new permutation usually only costs a cheap link.
+ */
+class PipelineLibrary {
+ public:
+  /**
+   * Handles of the four parts making up one pipeline, in the order: vertex
+   * input, pre-rasterization, fragment shader, fragment output.
+   */
+  using Parts = std::array<VkPipeline, 4>;
+
+  explicit PipelineLibrary(VkDevice device);
+
+  /**
+   * Returns the parts of a key, compiling the ones that are not cached yet.
+   */
+  Parts getParts(const PipelineKey& key);
+
+  /**
+   * Links the parts into a complete pipeline. Only touches the device, so it
+   * may be called from any thread as long as the parts stay alive.
+   * @param optimize request link time optimization, which is about as
+   * expensive as a monolithic compile
+   */
+  [[nodiscard]] std::unique_ptr<GraphicsPipeline> link(
+      const Parts& parts, VkPipelineLayout layout, bool optimize
+  ) const;
+
+  /**
+   * Moves every part compiled from the module into retired, so it is never
+   * linked again.
+   */
+  void evictShader(
+      VkShaderModule module,
+      std::vector<std::unique_ptr<GraphicsPipeline>>& retired
+  );
+
+  static bool isSupported(VkPhysicalDevice physicalDevice);
+
+ private:
+  using PartCache =
+      std::unordered_map<PipelineKey, std::unique_ptr<GraphicsPipeline>>;
+
+  VkDevice m_device;
+  PartCache m_vertexInputParts;
+  PartCache m_preRasterizationParts;
+  PartCache m_fragmentShaderParts;
+  PartCache m_fragmentOutputParts;
+
+  VkPipeline getPart(
+      PartCache& cache,
+      const PipelineKey& partKey,
+      VkGraphicsPipelineLibraryFlagsEXT flags
+  );
+};
+
+}  // namespace engine
+
+#endif  // PIPELINE_LIBRARY_HPP
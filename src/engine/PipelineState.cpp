@@ -0,0 +1,112 @@
+#include "PipelineState.hpp"
+
+namespace engine {
+PipelineState::PipelineState(const PipelineKey& key) : m_key(key) {
+  uint32_t stageCount = 0;
+
+  auto& vertShaderStageInfo = m_stages[stageCount++];
+  vertShaderStageInfo.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+  vertShaderStageInfo.module = m_key.vertexShader;
+  vertShaderStageInfo.pName = "main";
+
+  if (m_key.fragmentShader != VK_NULL_HANDLE) {
+    auto& fragShaderStageInfo = m_stages[stageCount++];
+    fragShaderStageInfo.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragShaderStageInfo.module = m_key.fragmentShader;
+    fragShaderStageInfo.pName = "main";
+  }
+
+  m_vertexInput.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  // Fullscreen passes generate their vertices and bind no vertex buffer
+  m_vertexInput.vertexBindingDescriptionCount =
+      m_key.vertexAttributeCount > 0 ? 1 : 0;
+  m_vertexInput.pVertexBindingDescriptions = &m_key.vertexBinding;
+  m_vertexInput.vertexAttributeDescriptionCount = m_key.vertexAttributeCount;
+  m_vertexInput.pVertexAttributeDescriptions = m_key.vertexAttributes.data();
+
+  m_inputAssembly.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  m_inputAssembly.topology = m_key.topology;
+  m_inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+  m_viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  m_viewport.viewportCount = 1;
+  m_viewport.scissorCount = 1;
+
+  m_rasterizer.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  m_rasterizer.depthClampEnable = VK_FALSE;
+  m_rasterizer.rasterizerDiscardEnable = VK_FALSE;
+  m_rasterizer.polygonMode = m_key.polygonMode;
+  m_rasterizer.lineWidth = 1.0f;
+  m_rasterizer.cullMode = m_key.cullMode;
+  m_rasterizer.frontFace = m_key.frontFace;
+  m_rasterizer.depthBiasEnable = VK_FALSE;
+
+  m_multisampling.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  m_multisampling.rasterizationSamples = m_key.sampleCount;
+  m_multisampling.sampleShadingEnable = m_key.sampleShadingEnable;
+  m_multisampling.minSampleShading = m_key.minSampleShading;
+
+  m_depthStencil.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+  m_depthStencil.depthTestEnable = m_key.depthTestEnable;
+  m_depthStencil.depthWriteEnable = m_key.depthWriteEnable;
+  m_depthStencil.depthCompareOp = m_key.depthCompareOp;
+  m_depthStencil.depthBoundsTestEnable = VK_FALSE;
+  m_depthStencil.stencilTestEnable = VK_FALSE;
+
+  m_colorBlendAttachment.colorWriteMask = m_key.colorWriteMask;
+  m_colorBlendAttachment.blendEnable = m_key.blendEnable;
+  m_colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+  m_colorBlendAttachment.dstColorBlendFactor =
+      VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  m_colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+  m_colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  m_colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+  m_colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+  m_colorBlending.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  m_colorBlending.logicOpEnable = VK_FALSE;
+  m_colorBlending.logicOp = VK_LOGIC_OP_COPY;
+  m_colorBlending.attachmentCount = m_key.colorAttachmentCount;
+  m_colorBlending.pAttachments = &m_colorBlendAttachment;
+
+  m_dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  m_dynamicState.dynamicStateCount =
+      static_cast<uint32_t>(m_dynamicStates.size());
+  m_dynamicState.pDynamicStates = m_dynamicStates.data();
+
+  m_createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  m_createInfo.stageCount = stageCount;
+  m_createInfo.pStages = m_stages.data();
+  m_createInfo.pVertexInputState = &m_vertexInput;
+  m_createInfo.pInputAssemblyState = &m_inputAssembly;
+  m_createInfo.pViewportState = &m_viewport;
+  m_createInfo.pRasterizationState = &m_rasterizer;
+  m_createInfo.pMultisampleState = &m_multisampling;
+  m_createInfo.pDepthStencilState = &m_depthStencil;
+  m_createInfo.pColorBlendState = &m_colorBlending;
+  m_createInfo.pDynamicState = &m_dynamicState;
+  m_createInfo.layout = m_key.layout;
+  m_createInfo.renderPass = m_key.renderPass;
+  m_createInfo.subpass = m_key.subpass;
+  m_createInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+  if (m_key.renderPass == VK_NULL_HANDLE) {
+    m_rendering.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    m_rendering.colorAttachmentCount = m_key.colorAttachmentCount;
+    m_rendering.pColorAttachmentFormats = &m_key.colorFormat;
+    m_rendering.depthAttachmentFormat = m_key.depthFormat;
+
+    m_createInfo.pNext = &m_rendering;
+  }
+}
+}  // namespace engine
@@ -0,0 +1,49 @@
+#ifndef PIPELINE_STATE_HPP
+#define PIPELINE_STATE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+
+#include "PipelineKey.hpp"
+
+namespace engine {
+
+/**
+ * Expands a PipelineKey into the fixed function structs referenced by a
+ * VkGraphicsPipelineCreateInfo. The create info points into this object, so
+ * it can be neither copied nor moved.
+ */
+class PipelineState {
+ public:
+  explicit PipelineState(const PipelineKey& key);
+
+  PipelineState(const PipelineState&) = delete;
+  PipelineState& operator=(const PipelineState&) = delete;
+
+  [[nodiscard]] const VkGraphicsPipelineCreateInfo& getCreateInfo() const {
+    return m_createInfo;
+  }
+
+ private:
+  PipelineKey m_key;
+
+  std::array<VkPipelineShaderStageCreateInfo, 2> m_stages{};
+  VkPipelineVertexInputStateCreateInfo m_vertexInput{};
+  VkPipelineInputAssemblyStateCreateInfo m_inputAssembly{};
+  VkPipelineViewportStateCreateInfo m_viewport{};
+  VkPipelineRasterizationStateCreateInfo m_rasterizer{};
+  VkPipelineMultisampleStateCreateInfo m_multisampling{};
+  VkPipelineDepthStencilStateCreateInfo m_depthStencil{};
+  VkPipelineColorBlendAttachmentState m_colorBlendAttachment{};
+  VkPipelineColorBlendStateCreateInfo m_colorBlending{};
+  std::array<VkDynamicState, 2> m_dynamicStates{
+      VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo m_dynamicState{};
+  VkPipelineRenderingCreateInfoKHR m_rendering{};
+  VkGraphicsPipelineCreateInfo m_createInfo{};
+};
+
+}  // namespace engine
+
+#endif  // PIPELINE_STATE_HPP
@@ -0,0 +1,159 @@
+#include "Profiler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+#include <iomanip>
+#include <utility>
+
+#include "Json.hpp"
+
+namespace engine {
+namespace {
+int64_t toNanoseconds(Profiler::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+      .count();
+}
+}  // namespace
+
+std::mutex Profiler::s_mutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::s_buffers;
+const Profiler::Clock::time_point Profiler::s_epoch = Profiler::Clock::now();
+
+void Profiler::record(const char* name, Clock::time_point start) {
+  auto end = Clock::now();
+  ThreadBuffer& buffer = getThreadBuffer();
+
+  uint64_t index = buffer.written.load(std::memory_order_relaxed);
+  Slot& slot = buffer.slots[index % ZONES_PER_THREAD];
+
+  // The fence keeps the field stores from moving before the odd sequence
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.startNanoseconds.store(
+      toNanoseconds(start - s_epoch), std::memory_order_relaxed
+  );
+  slot.endNanoseconds.store(
+      toNanoseconds(end - s_epoch), std::memory_order_relaxed
+  );
+
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(std::string name) {
+  ThreadBuffer& buffer = getThreadBuffer();
+
+  std::lock_guard lock(s_mutex);
+  buffer.threadName = std::move(name);
+}
+
+bool Profiler::writeChromeTrace(const std::filesystem::path& path) {
+  if (!isEnabled()) {
+    SPDLOG_WARN("CPU profiling is disabled, configure with -DPROFILING=ON");
+    return false;
+  }
+
+  std::ofstream out(path);
+
+  if (!out.is_open()) {
+    SPDLOG_ERROR("Failed to open {}", path.string());
+    return false;
+  }
+
+  std::lock_guard lock(s_mutex);
+  std::size_t zoneCount = 0;
+  bool isFirstEvent = true;
+
+  auto separator = [&out, &isFirstEvent]() -> std::ostream& {
+    out << (isFirstEvent ? "\n" : ",\n");
+    isFirstEvent = false;
+    return out;
+  };
+
+  // Chrome expects microseconds, keep nanosecond resolution
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  for (const auto& buffer : s_buffers) {
+    separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+                << buffer->threadIndex << ",\"args\":{\"name\":";
+    writeJsonString(out, buffer->threadName);
+    out << "}}";
+
+    // The owning thread keeps recording while the buffer is copied. Zones
+    // whose slot changed during their copy are dropped, and so are the ones
+    // the thread may have reached since.
+    uint64_t written = buffer->written.load(std::memory_order_acquire);
+    uint64_t oldest =
+        written > ZONES_PER_THREAD ? written - ZONES_PER_THREAD : 0;
+
+    std::vector<std::pair<uint64_t, Zone>> zones;
+    zones.reserve(written - oldest);
+
+    for (uint64_t i = oldest; i < written; ++i) {
+      const Slot& slot = buffer->slots[i % ZONES_PER_THREAD];
+      uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+      Zone zone{
+          slot.name.load(std::memory_order_relaxed),
+          slot.startNanoseconds.load(std::memory_order_relaxed),
+          slot.endNanoseconds.load(std::memory_order_relaxed)};
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (sequence == 2 * i + 2 &&
+          slot.sequence.load(std::memory_order_relaxed) == sequence) {
+        zones.emplace_back(i, zone);
+      }
+    }
+
+    // The zone of index after is being written into the slot that held
+    // after - ZONES_PER_THREAD, so that one is gone as well
+    uint64_t after = buffer->written.load(std::memory_order_acquire);
+    uint64_t overwritten =
+        after >= ZONES_PER_THREAD ? after - ZONES_PER_THREAD + 1 : 0;
+
+    for (const auto& [index, zone] : zones) {
+      if (index < overwritten) {
+        continue;
+      }
+
+      separator() << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+                  << ",\"ts\":" << zone.startNanoseconds / 1000.0
+                  << ",\"dur\":"
+                  << (zone.endNanoseconds - zone.startNanoseconds) / 1000.0
+                  << ",\"name\":";
+      writeJsonString(out, zone.name);
+      out << "}";
+
+      zoneCount++;
+    }
+  }
+
+  out << "\n]}\n";
+
+  SPDLOG_INFO("Wrote {} CPU zones to {}", zoneCount, path.string());
+
+  return out.good();
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer() {
+  thread_local ThreadBuffer* buffer = nullptr;
+
+  if (!buffer) {
+    std::lock_guard lock(s_mutex);
+
+    auto index = static_cast<uint32_t>(s_buffers.size());
+    auto& created = s_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+    created->threadIndex = index;
+    created->threadName = fmt::format("thread {}", index);
+
+    buffer = created.get();
+  }
+
+  return *buffer;
+}
+}  // namespace engine
@@ -0,0 +1,123 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * PROFILE_SCOPE("name") records a CPU zone from the macro to the end of the
+ * enclosing scope. Zones are only recorded in builds configured with
+ * -DPROFILING=ON, otherwise the macros expand to nothing.
+ */
+#ifdef ENABLE_PROFILING
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) \
+  ::engine::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_THREAD_NAME(name) ::engine::Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD_NAME(name)
+#endif
+
+namespace engine {
+
+/**
+ * Collects CPU zones into one lock-free ring buffer per thread. Only the
+ * owning thread writes to a buffer, so recording a zone is two clock reads
+ * and a few relaxed stores. Once a buffer is full the oldest zones are
+ * overwritten.
+ */
+class Profiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::size_t ZONES_PER_THREAD = 1 << 16;
+
+  struct Zone {
+    const char* name;
+    int64_t startNanoseconds;
+    int64_t endNanoseconds;
+  };
+
+  /**
+   * @param name must outlive the profiler, string literals are expected
+   */
+  static void record(const char* name, Clock::time_point start);
+
+  static void setThreadName(std::string name);
+
+  /**
+   * Writes every recorded zone as a Chrome trace, which can be opened in
+   * chrome://tracing or ui.perfetto.dev
+   * @return false if the file could not be written
+   */
+  static bool writeChromeTrace(const std::filesystem::path& path);
+
+  static constexpr bool isEnabled() {
+#ifdef ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+  }
+
+ private:
+  /**
+   * Zone in a ring buffer, which the owning thread may overwrite while
+   * writeChromeTrace() copies it. The sequence is odd while the zone of index
+   * sequence / 2 is being written and 2 * (index + 1) once it is complete, so
+   * a copy is only kept if the sequence is the expected one before and after.
+   */
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> startNanoseconds{0};
+    std::atomic<int64_t> endNanoseconds{0};
+  };
+
+  struct ThreadBuffer {
+    uint32_t threadIndex;
+    std::string threadName;
+    std::atomic<uint64_t> written{0};
+    std::array<Slot, ZONES_PER_THREAD> slots;
+  };
+
+  static std::mutex s_mutex;
+  static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+  static const Clock::time_point s_epoch;
+
+  static ThreadBuffer& getThreadBuffer();
+};
+
+/**
+ * Records the zone it lives in, use through PROFILE_SCOPE
+ */
+class ProfileZone {
+ public:
+  explicit ProfileZone(const char* name)
+      : m_name(name),
+        m_start(Profiler::Clock::now()) {}
+
+  ~ProfileZone() { Profiler::record(m_name, m_start); }
+
+  ProfileZone(const ProfileZone&) = delete;
+  ProfileZone& operator=(const ProfileZone&) = delete;
+
+ private:
+  const char* m_name;
+  Profiler::Clock::time_point m_start;
+};
+
+}  // namespace engine
+
+#endif  // PROFILER_HPP
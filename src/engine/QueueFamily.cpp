@@ -10,18 +10,36 @@ engine::QueueFamilyIndices engine::QueueFamily::findSuitableQueueFamilies(
   int i = 0;
   for (const auto& queueFamily :
        PhysicalDevice::enumerateQueueFamilies(device)) {
-    if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-      indices.graphicsFamily = i;
+    if (!indices.isComplete()) {
+      if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        indices.graphicsFamily = i;
+      }
+
+      // Without a surface nothing is presented, the graphics family stands
+      // in for the present family
+      VkBool32 presentSupport = false;
+
+      if (surface != VK_NULL_HANDLE) {
+        vkGetPhysicalDeviceSurfaceSupportKHR(
+            device, i, surface, &presentSupport
+        );
+      } else {
+        presentSupport = indices.graphicsFamily.has_value();
+      }
+
+      if (presentSupport) {
+        indices.presentFamily = i;
+      }
     }
 
-    VkBool32 presentSupport = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
-
-    if (presentSupport) {
-      indices.presentFamily = i;
+    if (!indices.computeFamily &&
+        (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+        !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+        queueFamily.timestampValidBits > 0) {
+      indices.computeFamily = i;
     }
 
-    if (indices.isComplete()) {
+    if (indices.isComplete() && indices.computeFamily) {
       break;
     }
 
@@ -10,6 +10,12 @@ namespace engine {
 struct QueueFamilyIndices {
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  /**
+   * Family with compute but no graphics, whose queues run alongside the
+   * graphics queue. Only families with timestamps are taken, so the GPU
+   * profiler can measure the passes there.
+   */
+  std::optional<uint32_t> computeFamily;
 
   [[nodiscard]] bool isComplete() const {
     return graphicsFamily.has_value() && presentFamily.has_value();
@@ -0,0 +1,1095 @@
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+
+#include "Abort.hpp"
+#include "PhysicalDevice.hpp"
+
+namespace engine {
+namespace {
+uint32_t getUsageBit(ImageUsage usage) {
+  return 1u << static_cast<uint32_t>(usage);
+}
+
+uint32_t getUsageBit(BufferUsage usage) {
+  return 1u << static_cast<uint32_t>(usage);
+}
+
+bool overlaps(
+    uint32_t firstA, uint32_t lastA, uint32_t firstB, uint32_t lastB
+) {
+  return firstA <= lastB && firstB <= lastA;
+}
+}  // namespace
+
+ImageState ImageState::of(ImageUsage usage) {
+  switch (usage) {
+    case ImageUsage::ColorAttachment:
+      return {
+          VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+          VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR |
+              VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    case ImageUsage::DepthAttachment:
+      return {
+          VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR |
+              VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+          VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR |
+              VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+    case ImageUsage::FragmentShaderRead:
+      return {
+          VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+          VK_ACCESS_2_SHADER_READ_BIT_KHR,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    case ImageUsage::ComputeShaderRead:
+      return {
+          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+          VK_ACCESS_2_SHADER_READ_BIT_KHR,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    case ImageUsage::ComputeShaderWrite:
+      return {
+          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+          VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+          VK_IMAGE_LAYOUT_GENERAL};
+    case ImageUsage::TransferSrc:
+      return {
+          VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+          VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+    case ImageUsage::TransferDst:
+      return {
+          VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+          VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+  }
+
+  ABORT("Unknown image usage");
+}
+
+BufferState BufferState::of(BufferUsage usage) {
+  switch (usage) {
+    case BufferUsage::GraphicsUniformRead:
+      return {
+          VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR |
+              VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+          VK_ACCESS_2_UNIFORM_READ_BIT_KHR};
+    case BufferUsage::ComputeUniformRead:
+      return {
+          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+          VK_ACCESS_2_UNIFORM_READ_BIT_KHR};
+    case BufferUsage::IndirectRead:
+      return {
+          VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR,
+          VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR};
+    case BufferUsage::ComputeShaderRead:
+      return {
+          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+          VK_ACCESS_2_SHADER_READ_BIT_KHR};
+    case BufferUsage::ComputeShaderWrite:
+      return {
+          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+          VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR};
+  }
+
+  ABORT("Unknown buffer usage");
+}
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t pass)
+    : m_graph(graph),
+      m_pass(pass) {}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(
+    ImageHandle image, ImageUsage usage
+) {
+  m_graph.addAccess(
+      m_pass, image, false, getUsageBit(usage), ImageState::of(usage), false
+  );
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(
+    ImageHandle image, ImageUsage usage
+) {
+  m_graph.addAccess(
+      m_pass, image, false, getUsageBit(usage), ImageState::of(usage), true
+  );
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(
+    BufferHandle buffer, BufferUsage usage
+) {
+  BufferState state = BufferState::of(usage);
+  m_graph.addAccess(
+      m_pass,
+      buffer,
+      true,
+      getUsageBit(usage),
+      {state.stages, state.access},
+      false
+  );
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(
+    BufferHandle buffer, BufferUsage usage
+) {
+  BufferState state = BufferState::of(usage);
+  m_graph.addAccess(
+      m_pass,
+      buffer,
+      true,
+      getUsageBit(usage),
+      {state.stages, state.access},
+      true
+  );
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::keep() {
+  m_graph.m_passes[m_pass].keep = true;
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::asyncCompute() {
+  m_graph.m_passes[m_pass].asyncCompute = true;
+  return *this;
+}
+
+RenderGraph::RenderGraph(
+    VkDevice device, VkPhysicalDevice physicalDevice, bool synchronization2
+)
+    : m_device(device),
+      m_physicalDevice(physicalDevice) {
+  if (!synchronization2) {
+    return;
+  }
+
+  m_cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+      vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2KHR")
+  );
+
+  if (!m_cmdPipelineBarrier2) {
+    ABORT("Failed to load the synchronization2 entry points");
+  }
+}
+
+RenderGraph::~RenderGraph() {
+  // Images go before the memory they are bound to
+  m_resources.clear();
+}
+
+RenderGraph::ImageHandle RenderGraph::importImage(
+    std::string name,
+    const VkImageSubresourceRange& range,
+    const ImageState& initial,
+    std::optional<ImageState> finalState
+) {
+  Resource resource;
+  resource.name = std::move(name);
+  resource.range = range;
+  resource.initial = initial;
+  resource.finalState = finalState;
+
+  return addResource(std::move(resource));
+}
+
+RenderGraph::ImageHandle RenderGraph::createImage(
+    std::string name, const TransientImageInfo& info
+) {
+  Resource resource;
+  resource.name = std::move(name);
+  resource.range.aspectMask = info.aspect;
+  resource.range.baseMipLevel = 0;
+  resource.range.levelCount = info.mipLevels;
+  resource.range.baseArrayLayer = 0;
+  resource.range.layerCount = 1;
+  resource.transient = info;
+
+  return addResource(std::move(resource));
+}
+
+RenderGraph::ImageHandle RenderGraph::createPersistentImage(
+    std::string name, const TransientImageInfo& info
+) {
+  ImageHandle image = createImage(std::move(name), info);
+  m_resources[image].persistent = true;
+  return image;
+}
+
+RenderGraph::BufferHandle RenderGraph::importBuffer(
+    std::string name, bool perFrame
+) {
+  Resource resource;
+  resource.name = std::move(name);
+  resource.buffer = true;
+  resource.perFrame = perFrame;
+
+  return addResource(std::move(resource));
+}
+
+void RenderGraph::setQueueFamilies(
+    uint32_t graphicsFamily, uint32_t computeFamily
+) {
+  if (m_compiled) {
+    ABORT("Render graph queue families set after compile()");
+  }
+
+  if (graphicsFamily == computeFamily) {
+    ABORT("Render graph compute queue is of the graphics family");
+  }
+
+  m_queueFamilies = {graphicsFamily, computeFamily};
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(
+    std::string name, RecordFunction record
+) {
+  if (m_compiled) {
+    ABORT("Render graph pass {} added after compile()", name);
+  }
+
+  Pass pass;
+  pass.name = std::move(name);
+  pass.record = std::move(record);
+
+  m_passes.push_back(std::move(pass));
+  return {*this, static_cast<uint32_t>(m_passes.size() - 1)};
+}
+
+uint32_t RenderGraph::addResource(Resource resource) {
+  if (m_compiled) {
+    ABORT("Render graph resource {} added after compile()", resource.name);
+  }
+
+  m_resources.push_back(std::move(resource));
+  return static_cast<uint32_t>(m_resources.size() - 1);
+}
+
+void RenderGraph::addAccess(
+    uint32_t pass,
+    uint32_t resource,
+    bool buffer,
+    uint32_t usageBit,
+    const ImageState& state,
+    bool write
+) {
+  if (resource >= m_resources.size() ||
+      m_resources[resource].buffer != buffer) {
+    ABORT(
+        "Render graph pass {} uses an unknown {}",
+        m_passes[pass].name,
+        buffer ? "buffer" : "image"
+    );
+  }
+
+  std::vector<Access>& accesses = m_passes[pass].accesses;
+
+  auto it = std::find_if(
+      accesses.begin(),
+      accesses.end(),
+      [resource](const Access& access) { return access.resource == resource; }
+  );
+
+  if (it == accesses.end()) {
+    accesses.push_back({resource, usageBit, state, !write, write});
+    return;
+  }
+
+  // One pass sees an image in a single layout, so its accesses are
+  // synchronized together
+  if (it->state.layout != state.layout) {
+    ABORT(
+        "Render graph pass {} uses {} in two layouts",
+        m_passes[pass].name,
+        m_resources[resource].name
+    );
+  }
+
+  it->usages |= usageBit;
+  it->state.stages |= state.stages;
+  it->state.access |= state.access;
+  it->read |= !write;
+  it->write |= write;
+}
+
+void RenderGraph::compile() {
+  if (m_compiled) {
+    ABORT("Render graph compiled twice");
+  }
+
+  cull();
+  planBatches();
+  allocate();
+  planBarriers();
+  m_compiled = true;
+
+  auto livePasses = std::count_if(
+      m_passes.begin(),
+      m_passes.end(),
+      [](const Pass& pass) { return pass.live; }
+  );
+
+  SPDLOG_DEBUG(
+      "Compiled render graph: {} of {} passes, {} memory blocks, {} batches",
+      livePasses,
+      m_passes.size(),
+      m_memoryBlocks.size(),
+      m_batches.size()
+  );
+}
+
+void RenderGraph::setImage(ImageHandle image, VkImage handle) {
+  if (m_resources[image].transient || m_resources[image].buffer) {
+    ABORT("Render graph image {} is not imported", m_resources[image].name);
+  }
+
+  m_resources[image].handle = handle;
+}
+
+void RenderGraph::setBuffer(BufferHandle buffer, VkBuffer handle) {
+  if (!m_resources[buffer].buffer) {
+    ABORT("Render graph resource {} is no buffer", m_resources[buffer].name);
+  }
+
+  m_resources[buffer].bufferHandle = handle;
+}
+
+void RenderGraph::execute(VkCommandBuffer commandBuffer) {
+  if (m_batches.size() > 1) {
+    ABORT(
+        "Render graph of {} batches executed in one command buffer",
+        m_batches.size()
+    );
+  }
+
+  execute(commandBuffer, 0);
+}
+
+void RenderGraph::execute(VkCommandBuffer commandBuffer, size_t batch) {
+  if (!m_compiled) {
+    ABORT("Render graph executed before compile()");
+  }
+
+  const Batch& passes = m_batches[batch];
+
+  for (uint32_t i = passes.firstPass; i < passes.endPass; ++i) {
+    const Pass& pass = m_passes[i];
+
+    if (!pass.live) {
+      continue;
+    }
+
+    if (isFirstExecution()) {
+      recordBarriers(commandBuffer, pass.initialBarriers);
+    }
+
+    recordBarriers(commandBuffer, pass.barriers);
+    pass.record(commandBuffer);
+  }
+
+  if (batch + 1 == m_batches.size()) {
+    recordBarriers(commandBuffer, m_finalBarriers);
+    ++m_executions;
+  }
+}
+
+size_t RenderGraph::getFirstBatch(ImageHandle image) const {
+  uint32_t firstPass = m_resources[image].firstPass;
+
+  auto it = std::find_if(
+      m_batches.begin(),
+      m_batches.end(),
+      [firstPass](const Batch& batch) { return firstPass < batch.endPass; }
+  );
+
+  return it == m_batches.end() ? m_batches.size() - 1
+                               : static_cast<size_t>(it - m_batches.begin());
+}
+
+VkImage RenderGraph::getImage(ImageHandle image) const {
+  return m_resources[image].handle;
+}
+
+VkImageView RenderGraph::getImageView(ImageHandle image) const {
+  const Resource& resource = m_resources[image];
+  return resource.view ? resource.view->getHandle() : VK_NULL_HANDLE;
+}
+
+VkImageView RenderGraph::getImageView(ImageHandle image, uint32_t mipLevel)
+    const {
+  const Resource& resource = m_resources[image];
+
+  if (resource.levelViews.empty()) {
+    return mipLevel == 0 ? getImageView(image) : VK_NULL_HANDLE;
+  }
+
+  return resource.levelViews[mipLevel]->getHandle();
+}
+
+VkImageView RenderGraph::getSampledImageView(ImageHandle image) const {
+  const Resource& resource = m_resources[image];
+  return resource.depthView ? resource.depthView->getHandle()
+                            : getImageView(image);
+}
+
+bool RenderGraph::isSynchronization2Supported(VkPhysicalDevice physicalDevice) {
+  if (!PhysicalDevice::isExtensionSupported(
+          physicalDevice, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME
+      )) {
+    return false;
+  }
+
+  VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+  synchronization2Features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &synchronization2Features;
+
+  vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+  return synchronization2Features.synchronization2 == VK_TRUE;
+}
+
+void RenderGraph::cull() {
+  // Imported images and buffers are visible outside the graph, and
+  // persistent images to the next execution, so their writers always run.
+  // Walking backwards, a pass is needed when it writes an image a needed
+  // pass reads.
+  std::vector<bool> needed(m_resources.size());
+
+  for (size_t i = 0; i < m_resources.size(); ++i) {
+    needed[i] = !m_resources[i].transient || m_resources[i].persistent;
+  }
+
+  for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass) {
+    pass->live = pass->keep;
+
+    for (const auto& access : pass->accesses) {
+      pass->live |= access.write && needed[access.resource];
+    }
+
+    if (!pass->live) {
+      SPDLOG_DEBUG("Culled render graph pass {}", pass->name);
+      continue;
+    }
+
+    for (const auto& access : pass->accesses) {
+      if (access.read) {
+        needed[access.resource] = true;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < m_passes.size(); ++i) {
+    if (!m_passes[i].live) {
+      continue;
+    }
+
+    for (const auto& access : m_passes[i].accesses) {
+      Resource& resource = m_resources[access.resource];
+      resource.firstPass = std::min(resource.firstPass, i);
+      resource.lastPass = std::max(resource.lastPass, i);
+    }
+  }
+}
+
+void RenderGraph::planBatches() {
+  for (uint32_t i = 0; i < m_passes.size(); ++i) {
+    Pass& pass = m_passes[i];
+    // Without a compute queue the pass runs in order on the graphics queue
+    pass.asyncCompute = pass.asyncCompute && !m_queueFamilies.empty();
+
+    if (!pass.live) {
+      continue;
+    }
+
+    if (m_batches.empty() ||
+        m_batches.back().asyncCompute != pass.asyncCompute) {
+      m_batches.push_back({pass.asyncCompute, i, i + 1, std::nullopt});
+    }
+
+    m_batches.back().endPass = i + 1;
+    pass.batch = static_cast<uint32_t>(m_batches.size() - 1);
+
+    for (const auto& access : pass.accesses) {
+      Resource& resource = m_resources[access.resource];
+
+      // Imported images belong to the graphics family, moving them would
+      // need ownership transfers
+      if (pass.asyncCompute && !resource.transient && !resource.buffer) {
+        ABORT(
+            "Render graph pass {} uses imported image {} on the compute queue",
+            pass.name,
+            resource.name
+        );
+      }
+
+      if (pass.asyncCompute) {
+        resource.computeQueue = true;
+      } else {
+        resource.graphicsQueue = true;
+      }
+    }
+  }
+
+  // The final transitions are recorded on the graphics queue
+  if (m_batches.empty() || m_batches.back().asyncCompute) {
+    auto passCount = static_cast<uint32_t>(m_passes.size());
+    m_batches.push_back({false, passCount, passCount, std::nullopt});
+  }
+}
+
+void RenderGraph::allocate() {
+  std::vector<ImageHandle> images;
+  std::vector<VkMemoryRequirements> requirements(m_resources.size());
+
+  for (ImageHandle i = 0; i < m_resources.size(); ++i) {
+    Resource& resource = m_resources[i];
+
+    if (!resource.transient || resource.firstPass == UINT32_MAX) {
+      continue;
+    }
+
+    const TransientImageInfo& info = *resource.transient;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {info.extent.width, info.extent.height, 1};
+    imageInfo.mipLevels = info.mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = info.format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = info.usage;
+    imageInfo.samples = info.samples;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // Shared by both queues instead of transferred between them
+    if (resource.graphicsQueue && resource.computeQueue) {
+      imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+      imageInfo.queueFamilyIndexCount =
+          static_cast<uint32_t>(m_queueFamilies.size());
+      imageInfo.pQueueFamilyIndices = m_queueFamilies.data();
+    }
+
+    resource.image = std::make_unique<Image>(m_device, imageInfo);
+    resource.handle = *resource.image;
+    vkGetImageMemoryRequirements(m_device, resource.handle, &requirements[i]);
+
+    images.push_back(i);
+  }
+
+  // Largest first, so the smaller images fill in the blocks of larger ones.
+  // Every image starts at offset 0 of its block, which satisfies any
+  // alignment.
+  std::stable_sort(
+      images.begin(),
+      images.end(),
+      [&requirements](ImageHandle a, ImageHandle b) {
+        return requirements[a].size > requirements[b].size;
+      }
+  );
+
+  // Lazily allocated memory only backs transient attachments, so those never
+  // share a block with other images
+  std::vector<bool> transientAttachments;
+
+  for (ImageHandle image : images) {
+    const Resource& resource = m_resources[image];
+    bool transientAttachment = resource.transient->usage &
+                               VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+    auto fits = [&](size_t block) {
+      if (resource.persistent ||
+          transientAttachments[block] != transientAttachment ||
+          !(m_memoryBlocks[block].typeBits &
+            requirements[image].memoryTypeBits)) {
+        return false;
+      }
+
+      // Persistent images are in use across executions
+      return std::none_of(
+          m_memoryBlocks[block].images.begin(),
+          m_memoryBlocks[block].images.end(),
+          [&](ImageHandle other) {
+            return m_resources[other].persistent ||
+                   overlaps(
+                       resource.firstPass,
+                       resource.lastPass,
+                       m_resources[other].firstPass,
+                       m_resources[other].lastPass
+                   );
+          }
+      );
+    };
+
+    size_t block = 0;
+
+    while (block < m_memoryBlocks.size() && !fits(block)) {
+      ++block;
+    }
+
+    if (block == m_memoryBlocks.size()) {
+      m_memoryBlocks.emplace_back();
+      transientAttachments.push_back(transientAttachment);
+    }
+
+    MemoryBlock& memoryBlock = m_memoryBlocks[block];
+    memoryBlock.size = std::max(memoryBlock.size, requirements[image].size);
+    memoryBlock.typeBits &= requirements[image].memoryTypeBits;
+    memoryBlock.images.push_back(image);
+  }
+
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
+
+  for (size_t block = 0; block < m_memoryBlocks.size(); ++block) {
+    MemoryBlock& memoryBlock = m_memoryBlocks[block];
+
+    uint32_t typeIndex = PhysicalDevice::findMemoryType(
+        m_physicalDevice,
+        memoryBlock.typeBits,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        transientAttachments[block] ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+                                    : 0
+    );
+
+    memoryBlock.lazy = memProperties.memoryTypes[typeIndex].propertyFlags &
+                       VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memoryBlock.size;
+    allocInfo.memoryTypeIndex = typeIndex;
+
+    memoryBlock.memory = std::make_unique<DeviceMemory>(m_device, allocInfo);
+
+    // Ordered by lifetime, which is how the images take over the memory
+    std::sort(
+        memoryBlock.images.begin(),
+        memoryBlock.images.end(),
+        [this](ImageHandle a, ImageHandle b) {
+          return m_resources[a].firstPass < m_resources[b].firstPass;
+        }
+    );
+
+    for (ImageHandle image : memoryBlock.images) {
+      Resource& resource = m_resources[image];
+      vkBindImageMemory(m_device, resource.handle, *memoryBlock.memory, 0);
+
+      VkImageViewCreateInfo viewInfo{};
+      viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+      viewInfo.image = resource.handle;
+      viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+      viewInfo.format = resource.transient->format;
+      viewInfo.subresourceRange = resource.range;
+
+      resource.view = std::make_unique<ImageView>(m_device, viewInfo);
+
+      uint32_t levels = resource.range.levelCount;
+
+      for (uint32_t level = 0; levels > 1 && level < levels; ++level) {
+        VkImageViewCreateInfo levelViewInfo = viewInfo;
+        levelViewInfo.subresourceRange.baseMipLevel = level;
+        levelViewInfo.subresourceRange.levelCount = 1;
+
+        resource.levelViews.push_back(
+            std::make_unique<ImageView>(m_device, levelViewInfo)
+        );
+      }
+
+      constexpr VkImageAspectFlags depthStencil =
+          VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+      if ((resource.range.aspectMask & depthStencil) == depthStencil &&
+          (resource.transient->usage & VK_IMAGE_USAGE_SAMPLED_BIT)) {
+        VkImageViewCreateInfo depthViewInfo = viewInfo;
+        depthViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+        resource.depthView =
+            std::make_unique<ImageView>(m_device, depthViewInfo);
+      }
+
+      if (!memoryBlock.name.empty()) {
+        memoryBlock.name += " + ";
+      }
+
+      memoryBlock.name += resource.name;
+    }
+  }
+}
+
+void RenderGraph::planBarriers() {
+  std::vector<Tracking> initial(m_resources.size());
+
+  for (size_t i = 0; i < m_resources.size(); ++i) {
+    const Resource& resource = m_resources[i];
+
+    // Imported images are handed over on the graphics queue
+    if (!resource.transient && !resource.buffer) {
+      QueueTracking& graphics = initial[i].queues[0];
+      initial[i].layout = resource.initial.layout;
+      graphics.writeStages = resource.initial.stages;
+      graphics.writeAccess = resource.initial.access & WRITE_ACCESS;
+    }
+  }
+
+  // Tracking after the previous execution, with its batches renumbered
+  std::vector<Tracking> lastTracking = simulate(initial, false);
+  auto batchCount = static_cast<int32_t>(m_batches.size());
+
+  for (auto& tracking : lastTracking) {
+    if (tracking.writeBatch != NO_BATCH) {
+      tracking.writeBatch -= batchCount;
+    }
+
+    for (auto& queue : tracking.queues) {
+      if (queue.batch != NO_BATCH) {
+        queue.batch -= batchCount;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < m_resources.size(); ++i) {
+    const Resource& resource = m_resources[i];
+
+    if ((resource.buffer && !resource.perFrame) || resource.persistent) {
+      initial[i] = lastTracking[i];
+    }
+  }
+
+  // Transient contents are discarded, but the memory is not free until the
+  // image that used it before is done: the previous image in the block, or
+  // for the first one, the last image of the previous execution
+  for (const auto& block : m_memoryBlocks) {
+    size_t count = block.images.size();
+
+    for (size_t i = 0; i < count && !m_resources[block.images[i]].persistent;
+         ++i) {
+      Tracking& tracking = initial[block.images[i]];
+      tracking = lastTracking[block.images[(i + count - 1) % count]];
+      tracking.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+  }
+
+  simulate(initial, true);
+
+  // The first execution finds persistent images in no layout at all
+  for (ImageHandle i = 0; i < m_resources.size(); ++i) {
+    const Resource& resource = m_resources[i];
+
+    if (!resource.persistent || resource.firstPass == UINT32_MAX ||
+        initial[i].layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+      continue;
+    }
+
+    VkImageMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+    barrier.dstAccessMask =
+        VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = initial[i].layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange = resource.range;
+
+    m_passes[resource.firstPass].initialBarriers.push_back({i, barrier});
+  }
+}
+
+std::vector<RenderGraph::Tracking> RenderGraph::simulate(
+    std::vector<Tracking> tracking, bool record
+) {
+  if (record) {
+    for (auto& batch : m_batches) {
+      batch.wait.reset();
+    }
+  }
+
+  for (auto& pass : m_passes) {
+    pass.barriers.clear();
+
+    if (!pass.live) {
+      continue;
+    }
+
+    for (const auto& access : pass.accesses) {
+      RenderGraph::access(
+          tracking[access.resource],
+          access.state,
+          access.write,
+          access.usages,
+          access.resource,
+          pass.batch,
+          record ? &pass.barriers : nullptr
+      );
+    }
+  }
+
+  m_finalBarriers.clear();
+  auto lastBatch = static_cast<uint32_t>(m_batches.size() - 1);
+
+  for (ImageHandle i = 0; i < m_resources.size(); ++i) {
+    const Resource& resource = m_resources[i];
+
+    if (resource.finalState) {
+      access(
+          tracking[i],
+          *resource.finalState,
+          false,
+          0,
+          i,
+          lastBatch,
+          record ? &m_finalBarriers : nullptr
+      );
+    }
+  }
+
+  return tracking;
+}
+
+void RenderGraph::access(
+    Tracking& tracking,
+    const ImageState& state,
+    bool write,
+    uint32_t usages,
+    uint32_t resource,
+    uint32_t batch,
+    std::vector<Barrier>* barriers
+) {
+  bool asyncCompute = m_batches[batch].asyncCompute;
+  QueueTracking& own = tracking.queues[asyncCompute ? 1 : 0];
+  QueueTracking& other = tracking.queues[asyncCompute ? 0 : 1];
+  bool transition = state.layout != tracking.layout;
+  bool overwrite = write || transition;
+
+  // Waiting for a batch of the other queue orders the access after it and
+  // makes what it wrote visible. That leaves the layout transition, whose
+  // barrier chains onto the wait by starting at the stages waited at, so the
+  // other queue's stages need not exist here.
+  bool waited = false;
+
+  if (!own.synchronized) {
+    if (barriers) {
+      addWait(batch, tracking.writeBatch, state.stages);
+    }
+
+    // Later reads on this queue with other stages chain onto the wait
+    own = QueueTracking{};
+    own.writeStages = overwrite ? VK_PIPELINE_STAGE_2_NONE_KHR : state.stages;
+    own.visibleUsages = usages;
+    waited = true;
+  }
+
+  if (overwrite && other.batch != NO_BATCH) {
+    // And for the other queue's accesses since the last write
+    if (barriers) {
+      addWait(batch, other.batch, state.stages);
+    }
+
+    waited = true;
+  }
+
+  VkPipelineStageFlags2KHR srcStages = own.writeStages;
+
+  if (overwrite) {
+    // Overwriting has to wait for the reads since the last write as well
+    srcStages |= own.readStages;
+
+    if (waited && transition) {
+      srcStages |= state.stages;
+    }
+  } else if (usages && (own.visibleUsages & usages) == usages) {
+    // Read after read, or the write is already visible to this usage
+    own.readStages |= state.stages;
+    own.batch = static_cast<int32_t>(batch);
+    return;
+  }
+
+  if (barriers && (transition || srcStages != VK_PIPELINE_STAGE_2_NONE_KHR)) {
+    VkImageMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStages;
+    barrier.srcAccessMask = own.writeAccess;
+    barrier.dstStageMask = state.stages;
+    barrier.dstAccessMask = state.access;
+    barrier.oldLayout = tracking.layout;
+    barrier.newLayout = state.layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange = m_resources[resource].range;
+
+    barriers->push_back({resource, barrier});
+  }
+
+  if (overwrite) {
+    // A layout transition is a write too, later accesses chain onto the
+    // barrier's second scope
+    tracking.layout = state.layout;
+    tracking.writeBatch = static_cast<int32_t>(batch);
+    own.synchronized = true;
+    own.writeStages = state.stages;
+    own.writeAccess = write ? state.access & WRITE_ACCESS : 0;
+    own.readStages = write ? 0 : state.stages;
+    own.visibleUsages = usages;
+    own.batch = static_cast<int32_t>(batch);
+    other = QueueTracking{};
+    other.synchronized = false;
+  } else {
+    own.readStages |= state.stages;
+    own.visibleUsages |= usages;
+    own.batch = static_cast<int32_t>(batch);
+  }
+}
+
+void RenderGraph::addWait(
+    uint32_t batch, int32_t waitedBatch, VkPipelineStageFlags2KHR stages
+) {
+  if (waitedBatch == NO_BATCH) {
+    return;
+  }
+
+  auto batchCount = static_cast<int32_t>(m_batches.size());
+  auto waitStages = static_cast<VkPipelineStageFlags>(stages);
+  std::optional<Wait>& wait = m_batches[batch].wait;
+
+  // Waiting for the later of two batches of a queue covers both
+  if (wait) {
+    auto current = static_cast<int32_t>(wait->batch);
+
+    if (wait->previousExecution) {
+      current -= batchCount;
+    }
+
+    waitedBatch = std::max(waitedBatch, current);
+    waitStages |= wait->stages;
+  }
+
+  bool previousExecution = waitedBatch < 0;
+
+  if (previousExecution) {
+    waitedBatch += batchCount;
+  }
+
+  wait = Wait{
+      static_cast<uint32_t>(waitedBatch), previousExecution, waitStages};
+}
+
+void RenderGraph::recordBarriers(
+    VkCommandBuffer commandBuffer, const std::vector<Barrier>& barriers
+) {
+  if (barriers.empty()) {
+    return;
+  }
+
+  if (m_cmdPipelineBarrier2) {
+    m_imageBarriers.clear();
+    m_bufferBarriers.clear();
+
+    for (const auto& [resource, barrier] : barriers) {
+      if (!m_resources[resource].buffer) {
+        m_imageBarriers.push_back(barrier);
+        m_imageBarriers.back().image = m_resources[resource].handle;
+        continue;
+      }
+
+      VkBufferMemoryBarrier2KHR bufferBarrier{};
+      bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+      bufferBarrier.srcStageMask = barrier.srcStageMask;
+      bufferBarrier.srcAccessMask = barrier.srcAccessMask;
+      bufferBarrier.dstStageMask = barrier.dstStageMask;
+      bufferBarrier.dstAccessMask = barrier.dstAccessMask;
+      bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      bufferBarrier.buffer = m_resources[resource].bufferHandle;
+      bufferBarrier.size = VK_WHOLE_SIZE;
+
+      m_bufferBarriers.push_back(bufferBarrier);
+    }
+
+    VkDependencyInfoKHR dependencyInfo{};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependencyInfo.bufferMemoryBarrierCount =
+        static_cast<uint32_t>(m_bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = m_bufferBarriers.data();
+    dependencyInfo.imageMemoryBarrierCount =
+        static_cast<uint32_t>(m_imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = m_imageBarriers.data();
+
+    m_cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    return;
+  }
+
+  // Vulkan 1.0 barriers share their stage masks, so the batch waits on the
+  // union of its stages
+  VkPipelineStageFlags srcStages = 0;
+  VkPipelineStageFlags dstStages = 0;
+  m_legacyBarriers.clear();
+  m_legacyBufferBarriers.clear();
+
+  for (const auto& [resource, barrier] : barriers) {
+    srcStages |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+    dstStages |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+
+    if (m_resources[resource].buffer) {
+      VkBufferMemoryBarrier bufferBarrier{};
+      bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+      bufferBarrier.srcAccessMask =
+          static_cast<VkAccessFlags>(barrier.srcAccessMask);
+      bufferBarrier.dstAccessMask =
+          static_cast<VkAccessFlags>(barrier.dstAccessMask);
+      bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      bufferBarrier.buffer = m_resources[resource].bufferHandle;
+      bufferBarrier.size = VK_WHOLE_SIZE;
+
+      m_legacyBufferBarriers.push_back(bufferBarrier);
+      continue;
+    }
+
+    VkImageMemoryBarrier legacyBarrier{};
+    legacyBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    legacyBarrier.srcAccessMask =
+        static_cast<VkAccessFlags>(barrier.srcAccessMask);
+    legacyBarrier.dstAccessMask =
+        static_cast<VkAccessFlags>(barrier.dstAccessMask);
+    legacyBarrier.oldLayout = barrier.oldLayout;
+    legacyBarrier.newLayout = barrier.newLayout;
+    legacyBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    legacyBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    legacyBarrier.image = m_resources[resource].handle;
+    legacyBarrier.subresourceRange = barrier.subresourceRange;
+
+    m_legacyBarriers.push_back(legacyBarrier);
+  }
+
+  // Vulkan 1.0 has no empty stage mask
+  if (!srcStages) {
+    srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+  }
+
+  if (!dstStages) {
+    dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+  }
+
+  vkCmdPipelineBarrier(
+      commandBuffer,
+      srcStages,
+      dstStages,
+      0,
+      0,
+      nullptr,
+      static_cast<uint32_t>(m_legacyBufferBarriers.size()),
+      m_legacyBufferBarriers.data(),
+      static_cast<uint32_t>(m_legacyBarriers.size()),
+      m_legacyBarriers.data()
+  );
+}
+}  // namespace engine
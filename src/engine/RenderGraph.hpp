@@ -0,0 +1,548 @@
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * How a pass accesses an image
+ */
+enum class ImageUsage {
+  ColorAttachment,
+  DepthAttachment,
+  FragmentShaderRead,
+  ComputeShaderRead,
+  ComputeShaderWrite,
+  TransferSrc,
+  TransferDst,
+};
+
+/**
+ * Stages, accesses and layout of an image access in Synchronization2 terms.
+ * Only stages and accesses with a Vulkan 1.0 equivalent are used, so the same
+ * state also translates to vkCmdPipelineBarrier.
+ */
+struct ImageState {
+  VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+  VkAccessFlags2KHR access = VK_ACCESS_2_NONE_KHR;
+  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  static ImageState of(ImageUsage usage);
+};
+
+/**
+ * How a pass accesses a buffer
+ */
+enum class BufferUsage {
+  GraphicsUniformRead,
+  ComputeUniformRead,
+  IndirectRead,
+  ComputeShaderRead,
+  ComputeShaderWrite,
+};
+
+/**
+ * Stages and accesses of a buffer access, like ImageState without a layout
+ */
+struct BufferState {
+  VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+  VkAccessFlags2KHR access = VK_ACCESS_2_NONE_KHR;
+
+  static BufferState of(BufferUsage usage);
+};
+
+/**
+ * Records passes that declare which images and buffers they read and write,
+ * and derives the synchronization between them instead of every pass
+ * hand-writing its barriers.
+ *
+ * Images are either imported, when they are owned elsewhere like the swap
+ * chain images, transient or persistent. Transient images are created by the
+ * graph and only live within one execution, so ones whose lifetimes do not
+ * overlap share memory. Persistent images keep their contents for the next
+ * execution. Buffers are always imported.
+ *
+ * compile() does the analysis once: passes whose results nothing reads are
+ * culled, transient images are placed, and the barriers in front of every
+ * pass are computed and batched into one call per pass. execute() then only
+ * replays them, so the graph is built whenever its passes or images change,
+ * not every frame.
+ *
+ * Every execution assumes the previous one may still be running, so the
+ * first access of a transient image waits for its last access in the
+ * previous execution, and so do accesses of persistent images and of buffers
+ * not imported per frame.
+ *
+ * Passes marked asyncCompute run on a compute queue when the graph is given
+ * one. The live passes are then split into batches, runs of consecutive
+ * passes on one queue, each submitted on its own. A batch only waits for the
+ * other queue where one of its passes depends on a pass there: for the batch
+ * of the last write it reads, or of the last accesses it overwrites, which
+ * may be one of the previous execution. Without a compute queue there is a
+ * single batch on the graphics queue, ordered by barriers alone.
+ */
+class RenderGraph {
+ public:
+  using ImageHandle = uint32_t;
+  /**
+   * Numbered along with the images
+   */
+  using BufferHandle = uint32_t;
+  using RecordFunction = std::function<void(VkCommandBuffer)>;
+
+  struct TransientImageInfo {
+    VkFormat format;
+    VkExtent2D extent;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkImageUsageFlags usage;
+    VkImageAspectFlags aspect;
+    /**
+     * Passes access every level at once, getImageView(image, level) views a
+     * single one
+     */
+    uint32_t mipLevels = 1;
+  };
+
+  /**
+   * Memory shared by transient images with disjoint lifetimes
+   */
+  struct MemoryBlock {
+    std::string name;
+    VkDeviceSize size = 0;
+    uint32_t typeBits = ~0u;
+    /**
+     * Whether the memory type is lazily allocated, only when every image in
+     * the block is a transient attachment
+     */
+    bool lazy = false;
+    std::unique_ptr<DeviceMemory> memory;
+    std::vector<ImageHandle> images;
+  };
+
+  /**
+   * Batch of the other queue that a batch waits for
+   */
+  struct Wait {
+    uint32_t batch;
+    /**
+     * Whether the batch is one of the previous execution
+     */
+    bool previousExecution;
+    /**
+     * Stages of the waiting passes that depend on it
+     */
+    VkPipelineStageFlags stages;
+  };
+
+  /**
+   * Consecutive live passes on one queue, recorded and submitted together
+   */
+  struct Batch {
+    bool asyncCompute = false;
+    uint32_t firstPass = 0;
+    /**
+     * One past the last pass, culled passes in between are skipped
+     */
+    uint32_t endPass = 0;
+    /**
+     * At most one, waiting for a batch also waits for the batches submitted
+     * to its queue before it
+     */
+    std::optional<Wait> wait;
+  };
+
+  class PassBuilder {
+   public:
+    PassBuilder& read(ImageHandle image, ImageUsage usage);
+
+    PassBuilder& write(ImageHandle image, ImageUsage usage);
+
+    PassBuilder& read(BufferHandle buffer, BufferUsage usage);
+
+    PassBuilder& write(BufferHandle buffer, BufferUsage usage);
+
+    /**
+     * Keeps the pass even if nothing reads what it writes, for passes with
+     * effects the graph does not see
+     */
+    PassBuilder& keep();
+
+    /**
+     * Runs the pass on the compute queue if the graph has one, otherwise in
+     * order with the rest on the graphics queue
+     */
+    PassBuilder& asyncCompute();
+
+   private:
+    friend class RenderGraph;
+
+    PassBuilder(RenderGraph& graph, uint32_t pass);
+
+    RenderGraph& m_graph;
+    uint32_t m_pass;
+  };
+
+  /**
+   * @param synchronization2 whether the device was created with
+   * VK_KHR_synchronization2, otherwise barriers go through
+   * vkCmdPipelineBarrier
+   */
+  RenderGraph(
+      VkDevice device, VkPhysicalDevice physicalDevice, bool synchronization2
+  );
+
+  ~RenderGraph();
+
+  RenderGraph(const RenderGraph&) = delete;
+  RenderGraph& operator=(const RenderGraph&) = delete;
+
+  /**
+   * @param initial state the image is in when an execution starts
+   * @param finalState state it is transitioned to after the last pass, if any
+   */
+  ImageHandle importImage(
+      std::string name,
+      const VkImageSubresourceRange& range,
+      const ImageState& initial,
+      std::optional<ImageState> finalState = std::nullopt
+  );
+
+  /**
+   * The image is created by compile(), and not at all when the passes using
+   * it are culled. Its contents do not survive between executions.
+   */
+  ImageHandle createImage(std::string name, const TransientImageInfo& info);
+
+  /**
+   * Like createImage(), but the image keeps its contents between executions
+   * and never shares memory, for passes reading what the previous execution
+   * wrote. It holds nothing before the first execution, see
+   * isFirstExecution().
+   */
+  ImageHandle createPersistentImage(
+      std::string name, const TransientImageInfo& info
+  );
+
+  /**
+   * Buffers used on both queues have to be shared by both families. Host
+   * writes need no synchronization, they are visible once submitted.
+   *
+   * @param perFrame whether the buffer is one of a set that the executions
+   * take turns with, like the uniform buffers of the frames in flight. Those
+   * are not synchronized with the previous execution, the caller waits for
+   * the one that last used the buffer.
+   */
+  BufferHandle importBuffer(std::string name, bool perFrame);
+
+  /**
+   * Gives async compute passes a queue of their own, of a family other than
+   * the graphics one. Transient and persistent images used on both queues
+   * are shared by the families, imported images may only be used on the
+   * graphics queue.
+   */
+  void setQueueFamilies(uint32_t graphicsFamily, uint32_t computeFamily);
+
+  /**
+   * Passes are recorded in the order they were added
+   */
+  PassBuilder addPass(std::string name, RecordFunction record);
+
+  void compile();
+
+  /**
+   * Sets the handle of an imported image, which may change between
+   * executions like the acquired swap chain image
+   */
+  void setImage(ImageHandle image, VkImage handle);
+
+  /**
+   * Sets the handle of a buffer, which may change between executions
+   */
+  void setBuffer(BufferHandle buffer, VkBuffer handle);
+
+  /**
+   * Records the whole graph, only for graphs without a compute queue
+   */
+  void execute(VkCommandBuffer commandBuffer);
+
+  /**
+   * Records one batch, the last one including the final transitions. The
+   * batches are submitted in order, each after its wait. Recording the last
+   * batch ends the execution.
+   */
+  void execute(VkCommandBuffer commandBuffer, size_t batch);
+
+  /**
+   * Whether the execution being recorded is the first since compile(), the
+   * one persistent images hold nothing in yet
+   */
+  [[nodiscard]] bool isFirstExecution() const { return m_executions == 0; }
+
+  /**
+   * Known after compile(). The last batch is always on the graphics queue.
+   */
+  [[nodiscard]] const std::vector<Batch>& getBatches() const {
+    return m_batches;
+  }
+
+  /**
+   * Batch of the first live pass using the image, the one that has to wait
+   * for an imported image to become available
+   */
+  [[nodiscard]] size_t getFirstBatch(ImageHandle image) const;
+
+  [[nodiscard]] VkImage getImage(ImageHandle image) const;
+
+  /**
+   * View of a transient image, VK_NULL_HANDLE for imported or culled ones
+   */
+  [[nodiscard]] VkImageView getImageView(ImageHandle image) const;
+
+  /**
+   * View of one mip level of a transient image
+   */
+  [[nodiscard]] VkImageView getImageView(
+      ImageHandle image, uint32_t mipLevel
+  ) const;
+
+  /**
+   * View shaders sample a transient image through. Only the depth aspect of
+   * a depth stencil image can be sampled, otherwise it is getImageView().
+   */
+  [[nodiscard]] VkImageView getSampledImageView(ImageHandle image) const;
+
+  [[nodiscard]] const std::vector<MemoryBlock>& getMemoryBlocks() const {
+    return m_memoryBlocks;
+  }
+
+  static bool isSynchronization2Supported(VkPhysicalDevice physicalDevice);
+
+ private:
+  /**
+   * Every access of a pass to one image or buffer, merged
+   */
+  struct Access {
+    uint32_t resource;
+    /**
+     * Bit per ImageUsage or BufferUsage
+     */
+    uint32_t usages;
+    /**
+     * No layout for buffers
+     */
+    ImageState state;
+    bool read;
+    bool write;
+  };
+
+  /**
+   * Image barrier, of which buffers only use the stages and accesses
+   */
+  struct Barrier {
+    uint32_t resource;
+    VkImageMemoryBarrier2KHR barrier;
+  };
+
+  struct Pass {
+    std::string name;
+    RecordFunction record;
+    std::vector<Access> accesses;
+    bool keep = false;
+    /**
+     * Only kept once compile() found a compute queue to run the pass on
+     */
+    bool asyncCompute = false;
+    bool live = false;
+    uint32_t batch = 0;
+    std::vector<Barrier> barriers;
+    /**
+     * Only recorded by the first execution, taking persistent images out of
+     * VK_IMAGE_LAYOUT_UNDEFINED
+     */
+    std::vector<Barrier> initialBarriers;
+  };
+
+  struct Resource {
+    std::string name;
+    bool buffer = false;
+    /**
+     * Only for imported buffers
+     */
+    bool perFrame = false;
+    /**
+     * Only for transient images, which then survive between executions
+     */
+    bool persistent = false;
+    VkImageSubresourceRange range{};
+    ImageState initial;
+    std::optional<ImageState> finalState;
+    std::optional<TransientImageInfo> transient;
+    VkImage handle = VK_NULL_HANDLE;
+    VkBuffer bufferHandle = VK_NULL_HANDLE;
+    std::unique_ptr<Image> image;
+    std::unique_ptr<ImageView> view;
+    /**
+     * Only for images with several mip levels
+     */
+    std::vector<std::unique_ptr<ImageView>> levelViews;
+    /**
+     * Only for sampled depth stencil images
+     */
+    std::unique_ptr<ImageView> depthView;
+    /**
+     * Live passes using the resource, empty range if none does
+     */
+    uint32_t firstPass = UINT32_MAX;
+    uint32_t lastPass = 0;
+    /**
+     * Queues the live passes use the resource on
+     */
+    bool graphicsQueue = false;
+    bool computeQueue = false;
+  };
+
+  /**
+   * Batches of one execution are numbered from 0, the previous execution's
+   * from minus its batch count
+   */
+  static constexpr int32_t NO_BATCH = INT32_MIN;
+
+  /**
+   * What accesses on one queue have to synchronize with
+   */
+  struct QueueTracking {
+    /**
+     * Whether the queue is ordered after the last write or layout
+     * transition, by running it or by waiting for its batch
+     */
+    bool synchronized = true;
+    /**
+     * Last write or layout transition, or the access that waited for it, and
+     * the reads since
+     */
+    VkPipelineStageFlags2KHR writeStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR writeAccess = VK_ACCESS_2_NONE_KHR;
+    VkPipelineStageFlags2KHR readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    /**
+     * Usage bits that already see the last write
+     */
+    uint32_t visibleUsages = 0;
+    /**
+     * Latest batch accessing the resource since the last write
+     */
+    int32_t batch = NO_BATCH;
+  };
+
+  /**
+   * What a pass has to synchronize with when it accesses an image or buffer
+   */
+  struct Tracking {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    int32_t writeBatch = NO_BATCH;
+    /**
+     * Graphics queue, then the compute queue
+     */
+    std::array<QueueTracking, 2> queues;
+  };
+
+  static constexpr VkAccessFlags2KHR WRITE_ACCESS =
+      VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+      VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+      VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+
+  VkDevice m_device;
+  VkPhysicalDevice m_physicalDevice;
+  PFN_vkCmdPipelineBarrier2KHR m_cmdPipelineBarrier2 = nullptr;
+  std::vector<Resource> m_resources;
+  std::vector<Pass> m_passes;
+  std::vector<MemoryBlock> m_memoryBlocks;
+  std::vector<Barrier> m_finalBarriers;
+  /**
+   * Graphics and compute family with a compute queue, empty otherwise
+   */
+  std::vector<uint32_t> m_queueFamilies;
+  std::vector<Batch> m_batches;
+  bool m_compiled = false;
+  uint64_t m_executions = 0;
+
+  /**
+   * Scratch space of execute()
+   */
+  std::vector<VkImageMemoryBarrier2KHR> m_imageBarriers;
+  std::vector<VkBufferMemoryBarrier2KHR> m_bufferBarriers;
+  std::vector<VkImageMemoryBarrier> m_legacyBarriers;
+  std::vector<VkBufferMemoryBarrier> m_legacyBufferBarriers;
+
+  uint32_t addResource(Resource resource);
+
+  void addAccess(
+      uint32_t pass,
+      uint32_t resource,
+      bool buffer,
+      uint32_t usageBit,
+      const ImageState& state,
+      bool write
+  );
+
+  void cull();
+
+  /**
+   * Splits the live passes into batches and finds the queues every resource
+   * is used on
+   */
+  void planBatches();
+
+  void allocate();
+
+  void planBarriers();
+
+  /**
+   * Runs the accesses of the live passes from the given tracking
+   * @param record whether to store the barriers in the passes and the waits
+   * in the batches
+   * @return tracking after the last pass and the final transitions
+   */
+  std::vector<Tracking> simulate(std::vector<Tracking> tracking, bool record);
+
+  /**
+   * Updates the tracking of a resource for an access in a batch, and adds
+   * the barrier and the wait for the other queue it needs, if any
+   * @param barriers where to add the barrier, nullptr to only update the
+   * tracking
+   */
+  void access(
+      Tracking& tracking,
+      const ImageState& state,
+      bool write,
+      uint32_t usages,
+      uint32_t resource,
+      uint32_t batch,
+      std::vector<Barrier>* barriers
+  );
+
+  /**
+   * Makes the batch wait for another one at the given stages as well
+   */
+  void addWait(
+      uint32_t batch, int32_t waitedBatch, VkPipelineStageFlags2KHR stages
+  );
+
+  void recordBarriers(
+      VkCommandBuffer commandBuffer, const std::vector<Barrier>& barriers
+  );
+};
+
+}  // namespace engine
+
+#endif  // RENDER_GRAPH_HPP
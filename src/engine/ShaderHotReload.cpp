@@ -0,0 +1,212 @@
+#include "ShaderHotReload.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "Hash.hpp"
+#include "Profiler.hpp"
+
+namespace engine {
+namespace {
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(250);
+
+std::optional<std::vector<uint32_t>> readSpirv(
+    const std::filesystem::path& path
+) {
+  std::ifstream file(path, std::ios::ate | std::ios::binary);
+
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+
+  auto fileSize = static_cast<std::size_t>(file.tellg());
+
+  if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) {
+    return std::nullopt;
+  }
+
+  std::vector<uint32_t> words(fileSize / sizeof(uint32_t));
+
+  file.seekg(0);
+  file.read(
+      reinterpret_cast<char*>(words.data()),
+      static_cast<std::streamsize>(fileSize)
+  );
+
+  return words;
+}
+}  // namespace
+
+ShaderHotReload::ShaderHotReload(
+    std::vector<std::string> sourcePaths,
+    std::vector<std::string> defines,
+    std::filesystem::path cacheDirectory
+)
+    : m_defines(std::move(defines)),
+      m_cacheDirectory(std::move(cacheDirectory)) {
+  std::error_code error;
+  std::filesystem::create_directories(m_cacheDirectory, error);
+
+  if (error) {
+    SPDLOG_WARN(
+        "Failed to create shader cache {}: {}",
+        m_cacheDirectory.string(),
+        error.message()
+    );
+  }
+
+  for (auto& path : sourcePaths) {
+    auto lastWriteTime = std::filesystem::last_write_time(path, error);
+
+    if (error) {
+      SPDLOG_WARN("Not watching shader {}: {}", path, error.message());
+      continue;
+    }
+
+    m_sources.push_back({std::move(path), lastWriteTime});
+  }
+
+  m_thread = std::thread(&ShaderHotReload::watch, this);
+
+  SPDLOG_DEBUG("Watching {} shader sources", m_sources.size());
+}
+
+ShaderHotReload::~ShaderHotReload() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_running = false;
+  }
+
+  m_wakeUp.notify_all();
+  m_thread.join();
+}
+
+std::vector<ShaderHotReload::Update> ShaderHotReload::takeUpdates() {
+  std::lock_guard lock(m_mutex);
+  return std::exchange(m_updates, {});
+}
+
+void ShaderHotReload::watch() {
+  PROFILE_THREAD_NAME("shader hot reload");
+
+  while (true) {
+    {
+      std::unique_lock lock(m_mutex);
+      m_wakeUp.wait_for(lock, POLL_INTERVAL, [this] { return !m_running; });
+
+      if (!m_running) {
+        return;
+      }
+    }
+
+    for (auto& source : m_sources) {
+      std::error_code error;
+      auto lastWriteTime = std::filesystem::last_write_time(source.path, error);
+
+      if (error || lastWriteTime == source.lastWriteTime) {
+        continue;
+      }
+
+      source.lastWriteTime = lastWriteTime;
+
+      auto spirv = compile(source.path);
+
+      if (!spirv) {
+        continue;
+      }
+
+      std::lock_guard lock(m_mutex);
+      m_updates.push_back({source.path, std::move(*spirv)});
+    }
+  }
+}
+
+std::optional<std::vector<uint32_t>> ShaderHotReload::compile(
+    const std::string& sourcePath
+) {
+  PROFILE_FUNCTION();
+
+  std::ifstream file(sourcePath, std::ios::binary);
+
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open shader {}", sourcePath);
+    return std::nullopt;
+  }
+
+  std::string source(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()
+  );
+
+  // The extension selects the shader stage, so it is part of the hash too
+  Fnv1a hasher;
+  hasher.addString(std::filesystem::path(sourcePath).extension().string());
+  hasher.addString(source);
+
+  for (const auto& define : m_defines) {
+    hasher.add('\0').addString(define);
+  }
+
+  auto cachePath =
+      m_cacheDirectory / fmt::format("{:016x}.spv", hasher.value());
+
+  if (auto cached = readSpirv(cachePath)) {
+    SPDLOG_INFO("Reloaded shader {} from cache", sourcePath);
+    return cached;
+  }
+
+  auto spirv = runCompiler(sourcePath, cachePath);
+
+  if (spirv) {
+    SPDLOG_INFO("Recompiled shader {}", sourcePath);
+  }
+
+  return spirv;
+}
+
+std::optional<std::vector<uint32_t>> ShaderHotReload::runCompiler(
+    const std::string& sourcePath, const std::filesystem::path& outputPath
+) {
+  // Compile next to the cache entry and rename it into place afterwards, so
+  // a failed or interrupted compilation never leaves a truncated entry
+  std::filesystem::path partialPath = outputPath;
+  partialPath += ".partial";
+
+  std::string command = "glslc";
+
+  for (const auto& define : m_defines) {
+    command += " -D" + define;
+  }
+
+  command += fmt::format(
+      " \"{}\" -o \"{}\" 2>&1", sourcePath, partialPath.string()
+  );
+
+  FILE* pipe = popen(command.c_str(), "r");
+
+  if (!pipe) {
+    SPDLOG_ERROR("Failed to run {}", command);
+    return std::nullopt;
+  }
+
+  std::string output;
+  char buffer[256];
+
+  while (fgets(buffer, sizeof(buffer), pipe)) {
+    output += buffer;
+  }
+
+  if (pclose(pipe) != 0) {
+    SPDLOG_ERROR("Failed to compile shader {}:\n{}", sourcePath, output);
+    return std::nullopt;
+  }
+
+  std::error_code error;
+  std::filesystem::rename(partialPath, outputPath, error);
+
+  return readSpirv(error ? partialPath : outputPath);
+}
+}  // namespace engine
@@ -0,0 +1,73 @@
+#ifndef SHADER_HOT_RELOAD_HPP
+#define SHADER_HOT_RELOAD_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Watches GLSL sources and recompiles them with glslc on a background thread
+ * whenever they change on disk. Compiled SPIR-V is cached under a hash of the
+ * source and the defines, so switching back to a previous version of a shader
+ * does not invoke the compiler again.
+ *
+ * Results are handed to the render loop through takeUpdates(), which never
+ * blocks on a compilation.
+ */
+class ShaderHotReload {
+ public:
+  struct Update {
+    std::string sourcePath;
+    std::vector<uint32_t> spirv;
+  };
+
+  ShaderHotReload(
+      std::vector<std::string> sourcePaths,
+      std::vector<std::string> defines,
+      std::filesystem::path cacheDirectory
+  );
+
+  virtual ~ShaderHotReload();
+
+  ShaderHotReload(const ShaderHotReload&) = delete;
+  ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+
+  std::vector<Update> takeUpdates();
+
+ private:
+  struct WatchedSource {
+    std::string path;
+    std::filesystem::file_time_type lastWriteTime;
+  };
+
+  std::vector<WatchedSource> m_sources;
+  std::vector<std::string> m_defines;
+  std::filesystem::path m_cacheDirectory;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::vector<Update> m_updates;
+  std::atomic<bool> m_running = true;
+  std::thread m_thread;
+
+  void watch();
+
+  std::optional<std::vector<uint32_t>> compile(const std::string& sourcePath);
+
+  std::optional<std::vector<uint32_t>> runCompiler(
+      const std::string& sourcePath, const std::filesystem::path& outputPath
+  );
+};
+
+}  // namespace engine
+
+#endif  // SHADER_HOT_RELOAD_HPP
@@ -0,0 +1,134 @@
+#include "Simulation.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+#include "Profiler.hpp"
+
+namespace engine {
+namespace {
+/**
+ * Steps run back to back after a stall, older ones are dropped so a long
+ * hitch does not turn into a burst of catching up
+ */
+constexpr int MAX_CATCH_UP_STEPS = 8;
+}  // namespace
+
+Simulation::Simulation(Camera& camera, uint32_t tickRate)
+    : m_camera(camera),
+      m_timestep(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / tickRate)
+      )) {
+  // Publish the initial state, so there is a packet before the first step
+  FramePacket& packet = m_packets.getWriteBuffer();
+  packet.time = Clock::now();
+  packet.previousCamera = m_camera.getState();
+  packet.camera = packet.previousCamera;
+  m_packets.publish();
+
+  m_thread = std::thread(&Simulation::run, this);
+
+  SPDLOG_DEBUG("Simulating at {} ticks per second", tickRate);
+}
+
+Simulation::~Simulation() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_running = false;
+  }
+
+  m_wakeUp.notify_all();
+  m_thread.join();
+}
+
+void Simulation::setInput(const SimulationInput& input) {
+  std::lock_guard lock(m_mutex);
+  m_input = input;
+}
+
+CameraState Simulation::sampleCamera(const SimulationInput& latest) {
+  m_packets.update();
+
+  const FramePacket& packet = m_packets.getReadBuffer();
+  auto timestep = std::chrono::duration<float>(m_timestep);
+  auto alpha = std::chrono::duration<float>(latest.time - packet.time) /
+               timestep;
+
+  auto state = CameraState::interpolate(
+      packet.previousCamera, packet.camera, std::clamp(alpha, 0.0f, 1.0f)
+  );
+
+  if (latest.cameraActive && packet.input.cameraActive) {
+    auto latched = m_camera.turn(
+        packet.camera,
+        latest.camera.cursor - packet.input.camera.cursor,
+        timestep.count()
+    );
+    state.front = latched.front;
+  }
+
+  return state;
+}
+
+const SimulationInput& Simulation::getSampledInput() const {
+  return m_packets.getReadBuffer().input;
+}
+
+void Simulation::run() {
+  PROFILE_THREAD_NAME("simulation");
+
+  auto nextTick = Clock::now();
+
+  while (true) {
+    SimulationInput input;
+
+    {
+      std::unique_lock lock(m_mutex);
+      nextTick += m_timestep;
+      m_wakeUp.wait_until(lock, nextTick, [this] { return !m_running; });
+
+      if (!m_running) {
+        return;
+      }
+
+      input = m_input;
+    }
+
+    auto now = Clock::now();
+
+    if (now - nextTick > MAX_CATCH_UP_STEPS * m_timestep) {
+      nextTick = now - MAX_CATCH_UP_STEPS * m_timestep;
+    }
+
+    step(input, nextTick);
+
+    // Cursor movement is absolute, so only the first step sees a delta
+    while (nextTick + m_timestep <= now) {
+      nextTick += m_timestep;
+      step(input, nextTick);
+    }
+  }
+}
+
+void Simulation::step(const SimulationInput& input, Clock::time_point time) {
+  PROFILE_FUNCTION();
+
+  FramePacket& packet = m_packets.getWriteBuffer();
+  packet.tick = ++m_tick;
+  packet.time = time;
+  packet.previousCamera = m_camera.getState();
+  packet.input = input;
+
+  m_camera.setActive(input.cameraActive);
+
+  if (input.cameraActive) {
+    m_camera.apply(
+        input.camera, std::chrono::duration<float>(m_timestep).count()
+    );
+  }
+
+  packet.camera = m_camera.getState();
+  m_packets.publish();
+}
+}  // namespace engine
@@ -0,0 +1,107 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "Camera.hpp"
+#include "TripleBuffer.hpp"
+
+namespace engine {
+
+/**
+ * Input gathered on the main thread, where GLFW has to be polled
+ */
+struct SimulationInput {
+  /**
+   * When the input was read
+   */
+  std::chrono::steady_clock::time_point time;
+  bool cameraActive = false;
+  CameraInput camera;
+};
+
+/**
+ * Immutable result of one simulation step, read by the render thread
+ */
+struct FramePacket {
+  uint64_t tick = 0;
+  /**
+   * Time the step simulated up to, camera is the state at this time and
+   * previousCamera the state one timestep earlier
+   */
+  std::chrono::steady_clock::time_point time;
+  CameraState previousCamera;
+  CameraState camera;
+  /**
+   * Input the step consumed
+   */
+  SimulationInput input;
+};
+
+/**
+ * Advances the scene on its own thread with a fixed timestep and hands the
+ * results to the render thread through a TripleBuffer, so simulating the
+ * next step overlaps with recording and submitting the current frame.
+ *
+ * While the simulation runs, it owns the camera it was given.
+ */
+class Simulation {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  Simulation(Camera& camera, uint32_t tickRate);
+
+  /**
+   * Stops and joins the simulation thread
+   */
+  ~Simulation();
+
+  Simulation(const Simulation&) = delete;
+  Simulation& operator=(const Simulation&) = delete;
+
+  /**
+   * Replaces the input used by the following steps
+   */
+  void setInput(const SimulationInput& input);
+
+  /**
+   * Camera at the time of latest, interpolated between the two states of the
+   * newest packet. Rendering trails the simulation by one timestep this way,
+   * but moves smoothly no matter how frames and steps line up.
+   *
+   * Mouse look does not trail: the orientation is the newest step's, turned
+   * by the cursor movement in latest that no step has consumed yet. Render
+   * thread only.
+   */
+  CameraState sampleCamera(const SimulationInput& latest);
+
+  /**
+   * Input behind the packet of the last sampleCamera(). Render thread only.
+   */
+  [[nodiscard]] const SimulationInput& getSampledInput() const;
+
+ private:
+  Camera& m_camera;
+  Clock::duration m_timestep;
+  uint64_t m_tick = 0;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  SimulationInput m_input;
+  bool m_running = true;
+
+  TripleBuffer<FramePacket> m_packets;
+  std::thread m_thread;
+
+  void run();
+
+  void step(const SimulationInput& input, Clock::time_point time);
+};
+
+}  // namespace engine
+
+#endif  // SIMULATION_HPP
@@ -0,0 +1,687 @@
+#include "SoftwareOcclusion.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "Abort.hpp"
+#include "Profiler.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SOFTWARE_OCCLUSION_X86
+#endif
+
+namespace engine {
+namespace {
+constexpr uint32_t FULL_ROW = ~0u;
+
+/**
+ * Stands in for missing edges, far enough that no row is cut by them
+ */
+constexpr float OFF_SCREEN = 1e30f;
+
+/**
+ * Edges flatter than this many pixels are treated as horizontal, their slopes
+ * would overflow
+ */
+constexpr float MIN_EDGE_HEIGHT = 1.0f / 1024.0f;
+
+/**
+ * Bits of a row from column start on, none when start is the tile width
+ */
+uint32_t columnsFrom(int start) {
+  return start >= 32 ? 0u : FULL_ROW << start;
+}
+
+/**
+ * A row covers the pixels whose centers lie between its left and right
+ * edge, columns are counted from the tile's left side
+ */
+uint32_t coverRow(float left, float right) {
+  float start = std::clamp(std::ceil(left - 0.5f), 0.0f, 32.0f);
+  float end = std::clamp(std::floor(right - 0.5f) + 1.0f, 0.0f, 32.0f);
+
+  return columnsFrom(static_cast<int>(start)) &
+         ~columnsFrom(static_cast<int>(end));
+}
+}  // namespace
+
+// The SIMD paths are compiled for their instruction sets function by
+// function, and only picked when the CPU runs them, so the rest of the
+// engine keeps its baseline flags
+struct SoftwareOcclusionKernels {
+  using Triangle = SoftwareOcclusion::Triangle;
+
+  static void coverScalar(
+      const Triangle& triangle, float x, float y, uint32_t* coverage
+  ) {
+    for (uint32_t row = 0; row < SoftwareOcclusion::TILE_HEIGHT; ++row) {
+      float center = y + static_cast<float>(row) + 0.5f;
+
+      if (center < triangle.minY || center > triangle.maxY) {
+        coverage[row] = 0;
+        continue;
+      }
+
+      float left = std::max(
+          triangle.leftSlope[0] * center + triangle.leftOffset[0],
+          triangle.leftSlope[1] * center + triangle.leftOffset[1]
+      );
+      float right = std::min(
+          triangle.rightSlope[0] * center + triangle.rightOffset[0],
+          triangle.rightSlope[1] * center + triangle.rightOffset[1]
+      );
+
+      coverage[row] = coverRow(left - x, right - x);
+    }
+  }
+
+#ifdef SOFTWARE_OCCLUSION_X86
+  /**
+   * Bits from column start on for four rows. SSE has no per-lane shifts, so
+   * 1 << start comes from the exponent of a float and is negated.
+   */
+  __attribute__((target("sse4.1"))) static __m128i columnsFromSse41(
+      __m128i start
+  ) {
+    __m128i exponent =
+        _mm_slli_epi32(_mm_add_epi32(start, _mm_set1_epi32(127)), 23);
+    __m128i power = _mm_cvttps_epi32(_mm_castsi128_ps(exponent));
+    __m128i inside = _mm_cmplt_epi32(start, _mm_set1_epi32(32));
+
+    return _mm_and_si128(_mm_sub_epi32(_mm_setzero_si128(), power), inside);
+  }
+
+  __attribute__((target("sse4.1"))) static void coverSse41(
+      const Triangle& triangle, float x, float y, uint32_t* coverage
+  ) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 width = _mm_set1_ps(32.0f);
+    const __m128 origin = _mm_set1_ps(x + 0.5f);
+
+    for (uint32_t half = 0; half < 2; ++half) {
+      __m128 center = _mm_add_ps(
+          _mm_set1_ps(y + static_cast<float>(half * 4) + 0.5f),
+          _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)
+      );
+
+      __m128 left = _mm_max_ps(
+          _mm_add_ps(
+              _mm_mul_ps(_mm_set1_ps(triangle.leftSlope[0]), center),
+              _mm_set1_ps(triangle.leftOffset[0])
+          ),
+          _mm_add_ps(
+              _mm_mul_ps(_mm_set1_ps(triangle.leftSlope[1]), center),
+              _mm_set1_ps(triangle.leftOffset[1])
+          )
+      );
+      __m128 right = _mm_min_ps(
+          _mm_add_ps(
+              _mm_mul_ps(_mm_set1_ps(triangle.rightSlope[0]), center),
+              _mm_set1_ps(triangle.rightOffset[0])
+          ),
+          _mm_add_ps(
+              _mm_mul_ps(_mm_set1_ps(triangle.rightSlope[1]), center),
+              _mm_set1_ps(triangle.rightOffset[1])
+          )
+      );
+
+      __m128 start = _mm_ceil_ps(_mm_sub_ps(left, origin));
+      __m128 end = _mm_add_ps(
+          _mm_floor_ps(_mm_sub_ps(right, origin)), _mm_set1_ps(1.0f)
+      );
+      start = _mm_min_ps(_mm_max_ps(start, zero), width);
+      end = _mm_min_ps(_mm_max_ps(end, zero), width);
+
+      // Rows outside the bounds end before they start
+      __m128 inside = _mm_and_ps(
+          _mm_cmpge_ps(center, _mm_set1_ps(triangle.minY)),
+          _mm_cmple_ps(center, _mm_set1_ps(triangle.maxY))
+      );
+      end = _mm_blendv_ps(zero, end, inside);
+
+      __m128i mask = _mm_andnot_si128(
+          columnsFromSse41(_mm_cvttps_epi32(end)),
+          columnsFromSse41(_mm_cvttps_epi32(start))
+      );
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(coverage + half * 4), mask
+      );
+    }
+  }
+
+  __attribute__((target("avx2"))) static void coverAvx2(
+      const Triangle& triangle, float x, float y, uint32_t* coverage
+  ) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 width = _mm256_set1_ps(32.0f);
+    const __m256 origin = _mm256_set1_ps(x + 0.5f);
+    const __m256i ones = _mm256_set1_epi32(-1);
+
+    __m256 center = _mm256_add_ps(
+        _mm256_set1_ps(y + 0.5f),
+        _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)
+    );
+
+    __m256 left = _mm256_max_ps(
+        _mm256_add_ps(
+            _mm256_mul_ps(_mm256_set1_ps(triangle.leftSlope[0]), center),
+            _mm256_set1_ps(triangle.leftOffset[0])
+        ),
+        _mm256_add_ps(
+            _mm256_mul_ps(_mm256_set1_ps(triangle.leftSlope[1]), center),
+            _mm256_set1_ps(triangle.leftOffset[1])
+        )
+    );
+    __m256 right = _mm256_min_ps(
+        _mm256_add_ps(
+            _mm256_mul_ps(_mm256_set1_ps(triangle.rightSlope[0]), center),
+            _mm256_set1_ps(triangle.rightOffset[0])
+        ),
+        _mm256_add_ps(
+            _mm256_mul_ps(_mm256_set1_ps(triangle.rightSlope[1]), center),
+            _mm256_set1_ps(triangle.rightOffset[1])
+        )
+    );
+
+    __m256 start = _mm256_ceil_ps(_mm256_sub_ps(left, origin));
+    __m256 end = _mm256_add_ps(
+        _mm256_floor_ps(_mm256_sub_ps(right, origin)), _mm256_set1_ps(1.0f)
+    );
+    start = _mm256_min_ps(_mm256_max_ps(start, zero), width);
+    end = _mm256_min_ps(_mm256_max_ps(end, zero), width);
+
+    __m256 inside = _mm256_and_ps(
+        _mm256_cmp_ps(center, _mm256_set1_ps(triangle.minY), _CMP_GE_OQ),
+        _mm256_cmp_ps(center, _mm256_set1_ps(triangle.maxY), _CMP_LE_OQ)
+    );
+    end = _mm256_blendv_ps(zero, end, inside);
+
+    // Shifts by 32 or more give 0, which is what a row ending at the tile's
+    // right side needs
+    __m256i mask = _mm256_andnot_si256(
+        _mm256_sllv_epi32(ones, _mm256_cvttps_epi32(end)),
+        _mm256_sllv_epi32(ones, _mm256_cvttps_epi32(start))
+    );
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(coverage), mask);
+  }
+#endif
+};
+
+SoftwareOcclusion::SoftwareOcclusion(
+    uint32_t width,
+    uint32_t height,
+    uint32_t threadCount,
+    std::optional<InstructionSet> instructionSet
+)
+    : m_width((width + TILE_WIDTH - 1) / TILE_WIDTH * TILE_WIDTH),
+      m_height((height + TILE_HEIGHT - 1) / TILE_HEIGHT * TILE_HEIGHT),
+      m_tilesX(m_width / TILE_WIDTH),
+      m_tilesY(m_height / TILE_HEIGHT),
+      m_instructionSet(instructionSet.value_or(detectInstructionSet())),
+      m_tiles(m_tilesX * m_tilesY),
+      m_triangles(std::max(threadCount, 1u)) {
+  if (!isSupported(m_instructionSet)) {
+    ABORT(
+        "Software occlusion path {} is not supported by the CPU",
+        toString(m_instructionSet)
+    );
+  }
+
+  switch (m_instructionSet) {
+#ifdef SOFTWARE_OCCLUSION_X86
+    case InstructionSet::Avx2:
+      m_cover = &SoftwareOcclusionKernels::coverAvx2;
+      break;
+    case InstructionSet::Sse41:
+      m_cover = &SoftwareOcclusionKernels::coverSse41;
+      break;
+#endif
+    default:
+      m_cover = &SoftwareOcclusionKernels::coverScalar;
+      break;
+  }
+
+  clear();
+
+  for (uint32_t worker = 1; worker < m_triangles.size(); ++worker) {
+    m_threads.emplace_back(&SoftwareOcclusion::run, this, worker);
+  }
+
+  SPDLOG_DEBUG(
+      "Software occlusion buffer {}x{} with {} on {} threads",
+      m_width,
+      m_height,
+      toString(m_instructionSet),
+      m_triangles.size()
+  );
+}
+
+SoftwareOcclusion::~SoftwareOcclusion() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_running = false;
+  }
+
+  m_wakeUp.notify_all();
+
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void SoftwareOcclusion::clear() {
+  Tile empty{};
+  empty.reference = 1.0f;
+  empty.working = 0.0f;
+
+  std::fill(m_tiles.begin(), m_tiles.end(), empty);
+}
+
+void SoftwareOcclusion::renderOccluders(
+    const std::vector<glm::vec3>& positions,
+    const std::vector<uint32_t>& indices,
+    const glm::mat4& transform,
+    bool cullBackFaces
+) {
+  PROFILE_FUNCTION();
+
+  auto workers = static_cast<uint32_t>(m_triangles.size());
+  size_t triangleCount = indices.size() / 3;
+
+  dispatch([&](uint32_t worker) {
+    setup(
+        positions,
+        indices,
+        triangleCount * worker / workers,
+        triangleCount * (worker + 1) / workers,
+        transform,
+        cullBackFaces,
+        m_triangles[worker]
+    );
+  });
+
+  dispatch([&](uint32_t worker) {
+    uint32_t firstRow = m_tilesY * worker / workers;
+    uint32_t lastRow = m_tilesY * (worker + 1) / workers;
+
+    for (const auto& triangles : m_triangles) {
+      for (const Triangle& triangle : triangles) {
+        rasterize(triangle, firstRow, lastRow);
+      }
+    }
+  });
+}
+
+bool SoftwareOcclusion::isVisible(
+    const glm::vec3& min, const glm::vec3& max, const glm::mat4& transform
+) const {
+  float minX = OFF_SCREEN;
+  float minY = OFF_SCREEN;
+  float maxX = -OFF_SCREEN;
+  float maxY = -OFF_SCREEN;
+  float minDepth = std::numeric_limits<float>::max();
+
+  for (uint32_t corner = 0; corner < 8; ++corner) {
+    glm::vec4 point(
+        corner & 1 ? max.x : min.x,
+        corner & 2 ? max.y : min.y,
+        corner & 4 ? max.z : min.z,
+        1.0f
+    );
+    glm::vec4 clip = transform * point;
+
+    if (clip.z < 0.0f || clip.w <= 0.0f) {
+      return true;
+    }
+
+    float x = (clip.x / clip.w * 0.5f + 0.5f) * m_width;
+    float y = (clip.y / clip.w * 0.5f + 0.5f) * m_height;
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+    minDepth = std::min(minDepth, clip.z / clip.w);
+  }
+
+  // Past the far plane when even the nearest corner is
+  if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height ||
+      minDepth > 1.0f) {
+    return false;
+  }
+
+  // Every pixel the box touches, not only the ones whose center it covers
+  auto firstX = static_cast<uint32_t>(std::max(minX, 0.0f));
+  auto firstY = static_cast<uint32_t>(std::max(minY, 0.0f));
+  auto lastX = static_cast<uint32_t>(std::min(maxX, m_width - 1.0f));
+  auto lastY = static_cast<uint32_t>(std::min(maxY, m_height - 1.0f));
+
+  for (uint32_t tileY = firstY / TILE_HEIGHT; tileY <= lastY / TILE_HEIGHT;
+       ++tileY) {
+    for (uint32_t tileX = firstX / TILE_WIDTH; tileX <= lastX / TILE_WIDTH;
+         ++tileX) {
+      const Tile& tile = m_tiles[tileY * m_tilesX + tileX];
+
+      int left = static_cast<int>(tileX * TILE_WIDTH);
+      int startX = std::max(static_cast<int>(firstX) - left, 0);
+      int endX = std::min(static_cast<int>(lastX) + 1 - left, 32);
+      uint32_t columns = columnsFrom(startX) & ~columnsFrom(endX);
+
+      // The working depth only helps when the box stays within its pixels
+      bool insideWorking = true;
+
+      for (uint32_t row = 0; row < TILE_HEIGHT; ++row) {
+        uint32_t y = tileY * TILE_HEIGHT + row;
+
+        if (y >= firstY && y <= lastY && (columns & ~tile.mask[row]) != 0) {
+          insideWorking = false;
+          break;
+        }
+      }
+
+      float depth = insideWorking ? std::min(tile.reference, tile.working)
+                                  : tile.reference;
+
+      if (minDepth <= depth) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+float SoftwareOcclusion::getDepth(uint32_t x, uint32_t y) const {
+  const Tile& tile = m_tiles[y / TILE_HEIGHT * m_tilesX + x / TILE_WIDTH];
+
+  if (tile.mask[y % TILE_HEIGHT] & (1u << (x % TILE_WIDTH))) {
+    return std::min(tile.reference, tile.working);
+  }
+
+  return tile.reference;
+}
+
+SoftwareOcclusion::InstructionSet SoftwareOcclusion::detectInstructionSet() {
+#ifdef SOFTWARE_OCCLUSION_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    return InstructionSet::Avx2;
+  }
+
+  if (__builtin_cpu_supports("sse4.1")) {
+    return InstructionSet::Sse41;
+  }
+#endif
+
+  return InstructionSet::Scalar;
+}
+
+bool SoftwareOcclusion::isSupported(InstructionSet instructionSet) {
+  return static_cast<int>(instructionSet) <=
+         static_cast<int>(detectInstructionSet());
+}
+
+const char* SoftwareOcclusion::toString(InstructionSet instructionSet) {
+  switch (instructionSet) {
+    case InstructionSet::Scalar:
+      return "scalar";
+    case InstructionSet::Sse41:
+      return "SSE4.1";
+    case InstructionSet::Avx2:
+      return "AVX2";
+  }
+
+  return "unknown";
+}
+
+void SoftwareOcclusion::run(uint32_t worker) {
+  PROFILE_THREAD_NAME("software occlusion");
+
+  uint64_t generation = 0;
+
+  while (true) {
+    const std::function<void(uint32_t)>* job;
+
+    {
+      std::unique_lock lock(m_mutex);
+      m_wakeUp.wait(lock, [&] {
+        return !m_running || m_generation != generation;
+      });
+
+      if (!m_running) {
+        return;
+      }
+
+      generation = m_generation;
+      job = m_job;
+    }
+
+    (*job)(worker);
+
+    {
+      std::lock_guard lock(m_mutex);
+
+      if (--m_pendingWorkers == 0) {
+        m_finished.notify_one();
+      }
+    }
+  }
+}
+
+void SoftwareOcclusion::dispatch(const std::function<void(uint32_t)>& job) {
+  if (m_threads.empty()) {
+    job(0);
+    return;
+  }
+
+  {
+    std::lock_guard lock(m_mutex);
+    m_job = &job;
+    m_pendingWorkers = static_cast<uint32_t>(m_threads.size());
+    ++m_generation;
+  }
+
+  m_wakeUp.notify_all();
+
+  job(0);
+
+  std::unique_lock lock(m_mutex);
+  m_finished.wait(lock, [this] { return m_pendingWorkers == 0; });
+}
+
+void SoftwareOcclusion::setup(
+    const std::vector<glm::vec3>& positions,
+    const std::vector<uint32_t>& indices,
+    size_t firstTriangle,
+    size_t lastTriangle,
+    const glm::mat4& transform,
+    bool cullBackFaces,
+    std::vector<Triangle>& triangles
+) const {
+  triangles.clear();
+
+  for (size_t index = firstTriangle; index < lastTriangle; ++index) {
+    std::array<glm::vec3, 3> screen;
+    bool behindNearPlane = false;
+
+    for (uint32_t corner = 0; corner < 3; ++corner) {
+      glm::vec4 clip =
+          transform * glm::vec4(positions[indices[index * 3 + corner]], 1.0f);
+
+      if (clip.z < 0.0f || clip.w <= 0.0f) {
+        behindNearPlane = true;
+        break;
+      }
+
+      screen[corner] = {
+          (clip.x / clip.w * 0.5f + 0.5f) * m_width,
+          (clip.y / clip.w * 0.5f + 0.5f) * m_height,
+          clip.z / clip.w,
+      };
+    }
+
+    if (behindNearPlane) {
+      continue;
+    }
+
+    glm::vec3 edge1 = screen[1] - screen[0];
+    glm::vec3 edge2 = screen[2] - screen[0];
+    float area = edge1.x * edge2.y - edge2.x * edge1.y;
+
+    // Negative areas are counter-clockwise with y pointing down
+    if (area == 0.0f || (cullBackFaces && area > 0.0f)) {
+      continue;
+    }
+
+    Triangle triangle{};
+    triangle.minX = std::max(
+        std::min({screen[0].x, screen[1].x, screen[2].x}), 0.0f
+    );
+    triangle.minY = std::max(
+        std::min({screen[0].y, screen[1].y, screen[2].y}), 0.0f
+    );
+    triangle.maxX = std::min(
+        std::max({screen[0].x, screen[1].x, screen[2].x}),
+        static_cast<float>(m_width)
+    );
+    triangle.maxY = std::min(
+        std::max({screen[0].y, screen[1].y, screen[2].y}),
+        static_cast<float>(m_height)
+    );
+
+    if (triangle.minX >= triangle.maxX ||
+        triangle.maxY - triangle.minY < MIN_EDGE_HEIGHT) {
+      continue;
+    }
+
+    triangle.firstTileX = static_cast<uint32_t>(triangle.minX) / TILE_WIDTH;
+    triangle.firstTileY = static_cast<uint32_t>(triangle.minY) / TILE_HEIGHT;
+    triangle.lastTileX =
+        std::min(static_cast<uint32_t>(triangle.maxX), m_width - 1) /
+        TILE_WIDTH;
+    triangle.lastTileY =
+        std::min(static_cast<uint32_t>(triangle.maxY), m_height - 1) /
+        TILE_HEIGHT;
+
+    uint32_t leftEdges = 0;
+    uint32_t rightEdges = 0;
+
+    for (uint32_t corner = 0; corner < 3; ++corner) {
+      const glm::vec3& from = screen[corner];
+      const glm::vec3& to = screen[(corner + 1) % 3];
+
+      // Horizontal edges lie on the bounds, and ones that are nearly so
+      // would only be off by less than a pixel
+      if (std::abs(to.y - from.y) < MIN_EDGE_HEIGHT) {
+        continue;
+      }
+
+      float slope = (to.x - from.x) / (to.y - from.y);
+      float offset = from.x - from.y * slope;
+
+      // Walking clockwise on screen, edges going up bound rows on the left
+      if ((to.y < from.y) == (area > 0.0f)) {
+        triangle.leftSlope[leftEdges] = slope;
+        triangle.leftOffset[leftEdges++] = offset;
+      } else {
+        triangle.rightSlope[rightEdges] = slope;
+        triangle.rightOffset[rightEdges++] = offset;
+      }
+    }
+
+    for (; leftEdges < 2; ++leftEdges) {
+      triangle.leftOffset[leftEdges] = -OFF_SCREEN;
+    }
+
+    for (; rightEdges < 2; ++rightEdges) {
+      triangle.rightOffset[rightEdges] = OFF_SCREEN;
+    }
+
+    triangle.depthX = (edge1.z * edge2.y - edge2.z * edge1.y) / area;
+    triangle.depthY = (edge1.x * edge2.z - edge2.x * edge1.z) / area;
+    triangle.depthOffset = screen[0].z - triangle.depthX * screen[0].x -
+                           triangle.depthY * screen[0].y;
+    triangle.maxDepth = std::max({screen[0].z, screen[1].z, screen[2].z});
+
+    triangles.push_back(triangle);
+  }
+}
+
+void SoftwareOcclusion::rasterize(
+    const Triangle& triangle, uint32_t firstRow, uint32_t lastRow
+) {
+  uint32_t firstTileY = std::max(triangle.firstTileY, firstRow);
+  uint32_t lastTileY = std::min(triangle.lastTileY + 1, lastRow);
+
+  alignas(32) uint32_t coverage[TILE_HEIGHT];
+
+  for (uint32_t tileY = firstTileY; tileY < lastTileY; ++tileY) {
+    auto y = static_cast<float>(tileY * TILE_HEIGHT);
+    float minY = std::max(y, triangle.minY);
+    float maxY = std::min(y + TILE_HEIGHT, triangle.maxY);
+
+    for (uint32_t tileX = triangle.firstTileX; tileX <= triangle.lastTileX;
+         ++tileX) {
+      auto x = static_cast<float>(tileX * TILE_WIDTH);
+      float minX = std::max(x, triangle.minX);
+      float maxX = std::min(x + TILE_WIDTH, triangle.maxX);
+
+      m_cover(triangle, x, y, coverage);
+
+      // Farthest the triangle gets within the tile, at one of the corners
+      // of the part of the tile it can cover
+      float depth = triangle.depthOffset +
+                    triangle.depthX * (triangle.depthX > 0.0f ? maxX : minX) +
+                    triangle.depthY * (triangle.depthY > 0.0f ? maxY : minY);
+
+      merge(
+          m_tiles[tileY * m_tilesX + tileX],
+          coverage,
+          std::min(depth, triangle.maxDepth)
+      );
+    }
+  }
+}
+
+void SoftwareOcclusion::merge(
+    Tile& tile, const uint32_t* coverage, float depth
+) {
+  uint32_t covered = 0;
+
+  for (uint32_t row = 0; row < TILE_HEIGHT; ++row) {
+    covered |= coverage[row];
+  }
+
+  // Pixels the reference already bounds more tightly gain nothing
+  if (covered == 0 || depth >= tile.reference) {
+    return;
+  }
+
+  // A triangle much nearer than the working layer starts a new one, the
+  // old one would only hold it back
+  if (tile.working - depth > tile.reference - tile.working) {
+    std::fill(std::begin(tile.mask), std::end(tile.mask), 0u);
+    tile.working = 0.0f;
+  }
+
+  tile.working = std::max(tile.working, depth);
+
+  uint32_t full = FULL_ROW;
+
+  for (uint32_t row = 0; row < TILE_HEIGHT; ++row) {
+    tile.mask[row] |= coverage[row];
+    full &= tile.mask[row];
+  }
+
+  if (full == FULL_ROW) {
+    tile.reference = tile.working;
+    tile.working = 0.0f;
+    std::fill(std::begin(tile.mask), std::end(tile.mask), 0u);
+  }
+}
+}  // namespace engine
@@ -0,0 +1,223 @@
+#ifndef SOFTWARE_OCCLUSION_HPP
+#define SOFTWARE_OCCLUSION_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Occlusion culling on the CPU, for when waiting a frame for results from the
+ * GPU is not an option. Occluders are rasterized into a small depth buffer,
+ * and boxes are tested against it before their draws are recorded. Nothing
+ * here touches Vulkan.
+ *
+ * The buffer is a masked occlusion buffer: instead of a depth per pixel,
+ * every tile of 32x8 pixels keeps a coverage bit per pixel and two depths.
+ * The reference depth bounds every pixel of the tile, the working depth the
+ * pixels whose bit is set. Triangles merge into the working layer, and once it
+ * covers the whole tile it becomes the reference. Both are the farthest depth
+ * of what they bound, so the buffer never claims more occlusion than there is.
+ *
+ * The rows of a tile are rasterized all eight at once with AVX2, four at once
+ * with SSE4.1, or one by one, whichever the CPU supports. Every thread sets up
+ * its share of the triangles, then rasterizes all of them into its own band
+ * of tile rows, so the result does not depend on the thread count.
+ */
+class SoftwareOcclusion {
+ public:
+  static constexpr uint32_t TILE_WIDTH = 32;
+  static constexpr uint32_t TILE_HEIGHT = 8;
+
+  /**
+   * Rasterization paths, from the narrowest to the widest
+   */
+  enum class InstructionSet {
+    Scalar,
+    Sse41,
+    Avx2,
+  };
+
+  /**
+   * @param width rounded up to whole tiles, like height
+   * @param threadCount threads rasterizing, including the calling one
+   * @param instructionSet path to rasterize with instead of the one
+   * detectInstructionSet() picks, which the CPU has to support
+   */
+  SoftwareOcclusion(
+      uint32_t width,
+      uint32_t height,
+      uint32_t threadCount,
+      std::optional<InstructionSet> instructionSet = std::nullopt
+  );
+
+  /**
+   * Stops and joins the worker threads
+   */
+  ~SoftwareOcclusion();
+
+  SoftwareOcclusion(const SoftwareOcclusion&) = delete;
+  SoftwareOcclusion& operator=(const SoftwareOcclusion&) = delete;
+
+  /**
+   * Removes every occluder
+   */
+  void clear();
+
+  /**
+   * Rasterizes a triangle list as occluders. Triangles crossing the near
+   * plane are skipped instead of clipped.
+   *
+   * @param transform model space to clip space, with depth from 0 to 1
+   * @param cullBackFaces whether to skip triangles that are clockwise in
+   * framebuffer coordinates, like VK_FRONT_FACE_COUNTER_CLOCKWISE does
+   */
+  void renderOccluders(
+      const std::vector<glm::vec3>& positions,
+      const std::vector<uint32_t>& indices,
+      const glm::mat4& transform,
+      bool cullBackFaces
+  );
+
+  /**
+   * Whether some of a model space box may be visible, inside the frustum and
+   * not behind the occluders. Boxes crossing the near plane always are.
+   */
+  [[nodiscard]] bool isVisible(
+      const glm::vec3& min, const glm::vec3& max, const glm::mat4& transform
+  ) const;
+
+  /**
+   * Farthest depth the occluders allow at a pixel, 1 if none covers it
+   */
+  [[nodiscard]] float getDepth(uint32_t x, uint32_t y) const;
+
+  [[nodiscard]] uint32_t getWidth() const { return m_width; }
+
+  [[nodiscard]] uint32_t getHeight() const { return m_height; }
+
+  [[nodiscard]] uint32_t getThreadCount() const {
+    return static_cast<uint32_t>(m_triangles.size());
+  }
+
+  [[nodiscard]] InstructionSet getInstructionSet() const {
+    return m_instructionSet;
+  }
+
+  /**
+   * Widest instruction set the rasterizer has a path for and the CPU runs
+   */
+  static InstructionSet detectInstructionSet();
+
+  /**
+   * Whether the CPU runs the path, every narrower one than
+   * detectInstructionSet() included
+   */
+  static bool isSupported(InstructionSet instructionSet);
+
+  static const char* toString(InstructionSet instructionSet);
+
+ private:
+  friend struct SoftwareOcclusionKernels;
+
+  struct Tile {
+    /**
+     * Pixels of the working layer, an element per row and a bit per column
+     */
+    uint32_t mask[TILE_HEIGHT];
+    float reference;
+    float working;
+  };
+
+  /**
+   * Triangle set up for rasterization, in pixels. A row of it spans from the
+   * farther of its left edges to the nearer of its right edges, missing edges
+   * are vertical lines far off screen.
+   */
+  struct Triangle {
+    float leftSlope[2];
+    float leftOffset[2];
+    float rightSlope[2];
+    float rightOffset[2];
+    /**
+     * Bounds, horizontal edges only limit these
+     */
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+    /**
+     * Depth as a plane over the screen, and its largest value on the triangle
+     */
+    float depthX;
+    float depthY;
+    float depthOffset;
+    float maxDepth;
+    uint32_t firstTileX;
+    uint32_t lastTileX;
+    uint32_t firstTileY;
+    uint32_t lastTileY;
+  };
+
+  /**
+   * Writes the coverage of every row of a tile, the tile's origin in pixels
+   */
+  using CoverFunction =
+      void (*)(const Triangle& triangle, float x, float y, uint32_t* coverage);
+
+  uint32_t m_width;
+  uint32_t m_height;
+  uint32_t m_tilesX;
+  uint32_t m_tilesY;
+  InstructionSet m_instructionSet;
+  CoverFunction m_cover;
+  std::vector<Tile> m_tiles;
+  /**
+   * Set up triangles of every thread, in the order they were submitted
+   */
+  std::vector<std::vector<Triangle>> m_triangles;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::condition_variable m_finished;
+  const std::function<void(uint32_t)>* m_job = nullptr;
+  uint64_t m_generation = 0;
+  uint32_t m_pendingWorkers = 0;
+  bool m_running = true;
+  std::vector<std::thread> m_threads;
+
+  void run(uint32_t worker);
+
+  /**
+   * Runs the job once on every worker and waits for all of them, the calling
+   * thread is worker 0
+   */
+  void dispatch(const std::function<void(uint32_t)>& job);
+
+  void setup(
+      const std::vector<glm::vec3>& positions,
+      const std::vector<uint32_t>& indices,
+      size_t firstTriangle,
+      size_t lastTriangle,
+      const glm::mat4& transform,
+      bool cullBackFaces,
+      std::vector<Triangle>& triangles
+  ) const;
+
+  /**
+   * Rasterizes into the tile rows from firstRow up to lastRow
+   */
+  void rasterize(const Triangle& triangle, uint32_t firstRow, uint32_t lastRow);
+
+  static void merge(Tile& tile, const uint32_t* coverage, float depth);
+};
+
+}  // namespace engine
+
+#endif  // SOFTWARE_OCCLUSION_HPP
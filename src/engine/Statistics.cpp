@@ -0,0 +1,64 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace engine {
+RollingStatistics::RollingStatistics(std::size_t windowSize)
+    : m_windowSize(std::max<std::size_t>(windowSize, 1)) {
+  m_samples.reserve(m_windowSize);
+}
+
+void RollingStatistics::add(double sample) {
+  if (m_samples.size() < m_windowSize) {
+    m_samples.push_back(sample);
+  } else {
+    m_samples[m_next] = sample;
+  }
+
+  m_next = (m_next + 1) % m_windowSize;
+}
+
+double RollingStatistics::min() const {
+  if (m_samples.empty()) {
+    return 0.0;
+  }
+
+  return *std::min_element(m_samples.begin(), m_samples.end());
+}
+
+double RollingStatistics::max() const {
+  if (m_samples.empty()) {
+    return 0.0;
+  }
+
+  return *std::max_element(m_samples.begin(), m_samples.end());
+}
+
+double RollingStatistics::average() const {
+  if (m_samples.empty()) {
+    return 0.0;
+  }
+
+  double sum = std::accumulate(m_samples.begin(), m_samples.end(), 0.0);
+  return sum / static_cast<double>(m_samples.size());
+}
+
+double RollingStatistics::percentile(double percentile) const {
+  if (m_samples.empty()) {
+    return 0.0;
+  }
+
+  // Nearest rank, so the result is always one of the recorded samples
+  double rank = std::ceil(percentile / 100.0 * m_samples.size());
+  auto index = static_cast<std::size_t>(
+      std::clamp(rank, 1.0, static_cast<double>(m_samples.size()))
+  ) - 1;
+
+  std::vector<double> sorted = m_samples;
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+  return sorted[index];
+}
+}  // namespace engine
@@ -0,0 +1,40 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Summary of the most recent samples of a measurement. Once the window is
+ * full every new sample replaces the oldest one.
+ */
+class RollingStatistics {
+ public:
+  explicit RollingStatistics(std::size_t windowSize = 256);
+
+  void add(double sample);
+
+  [[nodiscard]] std::size_t count() const { return m_samples.size(); }
+
+  [[nodiscard]] double min() const;
+
+  [[nodiscard]] double max() const;
+
+  [[nodiscard]] double average() const;
+
+  /**
+   * @param percentile in the range [0, 100]
+   */
+  [[nodiscard]] double percentile(double percentile) const;
+
+ private:
+  std::size_t m_windowSize;
+  std::size_t m_next = 0;
+  std::vector<double> m_samples;
+};
+
+}  // namespace engine
+
+#endif  // STATISTICS_HPP
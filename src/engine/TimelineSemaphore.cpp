@@ -0,0 +1,120 @@
+#include "TimelineSemaphore.hpp"
+
+#include <algorithm>
+
+#include "Abort.hpp"
+
+namespace engine {
+namespace {
+Semaphore createTimelineSemaphore(VkDevice device) {
+  VkSemaphoreTypeCreateInfo typeInfo{};
+  typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  typeInfo.initialValue = 0;
+
+  VkSemaphoreCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  createInfo.pNext = &typeInfo;
+
+  return Semaphore(device, createInfo);
+}
+}  // namespace
+
+TimelineSemaphore::TimelineSemaphore(VkDevice device, VkQueue queue)
+    : m_device(device),
+      m_queue(queue),
+      m_semaphore(createTimelineSemaphore(device)) {}
+
+uint64_t TimelineSemaphore::submit(
+    const VkSubmitInfo& submitInfo, const std::vector<Wait>& waits
+) {
+  uint64_t value = m_lastSubmittedValue + 1;
+
+  // Values of binary semaphores are ignored, but every semaphore needs one
+  std::vector<VkSemaphore> waitSemaphores(
+      submitInfo.pWaitSemaphores,
+      submitInfo.pWaitSemaphores + submitInfo.waitSemaphoreCount
+  );
+  std::vector<VkPipelineStageFlags> waitStages(
+      submitInfo.pWaitDstStageMask,
+      submitInfo.pWaitDstStageMask + submitInfo.waitSemaphoreCount
+  );
+  std::vector<uint64_t> waitValues(submitInfo.waitSemaphoreCount, 0);
+
+  for (const auto& wait : waits) {
+    waitSemaphores.push_back(wait.timeline->getHandle());
+    waitStages.push_back(wait.stages);
+    waitValues.push_back(wait.value);
+  }
+
+  std::vector<VkSemaphore> signalSemaphores(
+      submitInfo.pSignalSemaphores,
+      submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount
+  );
+  std::vector<uint64_t> signalValues(submitInfo.signalSemaphoreCount, 0);
+
+  signalSemaphores.push_back(m_semaphore);
+  signalValues.push_back(value);
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.pNext = submitInfo.pNext;
+  timelineInfo.waitSemaphoreValueCount =
+      static_cast<uint32_t>(waitValues.size());
+  timelineInfo.pWaitSemaphoreValues = waitValues.data();
+  timelineInfo.signalSemaphoreValueCount =
+      static_cast<uint32_t>(signalValues.size());
+  timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+  VkSubmitInfo timelineSubmitInfo = submitInfo;
+  timelineSubmitInfo.pNext = &timelineInfo;
+  timelineSubmitInfo.waitSemaphoreCount =
+      static_cast<uint32_t>(waitSemaphores.size());
+  timelineSubmitInfo.pWaitSemaphores = waitSemaphores.data();
+  timelineSubmitInfo.pWaitDstStageMask = waitStages.data();
+  timelineSubmitInfo.signalSemaphoreCount =
+      static_cast<uint32_t>(signalSemaphores.size());
+  timelineSubmitInfo.pSignalSemaphores = signalSemaphores.data();
+
+  ABORT_ON_FAIL(
+      vkQueueSubmit(m_queue, 1, &timelineSubmitInfo, VK_NULL_HANDLE),
+      "Failed to submit to queue"
+  );
+
+  m_lastSubmittedValue = value;
+
+  return value;
+}
+
+uint64_t TimelineSemaphore::getCompletedValue() const {
+  if (m_completedValue < m_lastSubmittedValue) {
+    ABORT_ON_FAIL(
+        vkGetSemaphoreCounterValue(m_device, m_semaphore, &m_completedValue),
+        "Failed to query timeline semaphore"
+    );
+  }
+
+  return m_completedValue;
+}
+
+void TimelineSemaphore::wait(uint64_t value) const {
+  if (isComplete(value)) {
+    return;
+  }
+
+  VkSemaphore semaphore = m_semaphore;
+
+  VkSemaphoreWaitInfo waitInfo{};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &semaphore;
+  waitInfo.pValues = &value;
+
+  ABORT_ON_FAIL(
+      vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX),
+      "Failed to wait for timeline semaphore"
+  );
+
+  m_completedValue = std::max(m_completedValue, value);
+}
+}  // namespace engine
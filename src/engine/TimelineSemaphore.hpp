@@ -0,0 +1,74 @@
+#ifndef TIMELINE_SEMAPHORE_HPP
+#define TIMELINE_SEMAPHORE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "VulkanWrappers.hpp"
+
+namespace engine {
+
+/**
+ * Tracks the work submitted to one queue with a timeline semaphore. Every
+ * submission made through submit() signals the next value, so any past
+ * submission can be waited for or polled by the value it returned.
+ */
+class TimelineSemaphore {
+ public:
+  /**
+   * Submission to another queue's timeline that a batch waits for
+   */
+  struct Wait {
+    const TimelineSemaphore* timeline;
+    uint64_t value;
+    VkPipelineStageFlags stages;
+  };
+
+  TimelineSemaphore(VkDevice device, VkQueue queue);
+
+  /**
+   * Submits the batch, which additionally signals the next value and waits
+   * for the given timeline values. The batch may also use binary semaphores.
+   * @return the value signaled once the batch has finished
+   */
+  uint64_t submit(
+      const VkSubmitInfo& submitInfo, const std::vector<Wait>& waits = {}
+  );
+
+  /**
+   * Value of the most recent submission, 0 before the first one
+   */
+  [[nodiscard]] uint64_t getLastSubmittedValue() const {
+    return m_lastSubmittedValue;
+  }
+
+  /**
+   * Value of the most recent submission that has finished. Only queries the
+   * device while there are unfinished submissions.
+   */
+  [[nodiscard]] uint64_t getCompletedValue() const;
+
+  [[nodiscard]] bool isComplete(uint64_t value) const {
+    return value <= getCompletedValue();
+  }
+
+  /**
+   * Blocks until the submission that returned value has finished
+   */
+  void wait(uint64_t value) const;
+
+  [[nodiscard]] VkSemaphore getHandle() const { return m_semaphore; }
+
+ private:
+  VkDevice m_device;
+  VkQueue m_queue;
+  Semaphore m_semaphore;
+  uint64_t m_lastSubmittedValue = 0;
+  mutable uint64_t m_completedValue = 0;
+};
+
+}  // namespace engine
+
+#endif  // TIMELINE_SEMAPHORE_HPP
@@ -0,0 +1,77 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace engine {
+
+/**
+ * Lock-free mailbox between exactly one producer and one consumer thread.
+ *
+ * The producer fills getWriteBuffer() and publishes it, the consumer picks up
+ * the newest published value with update() and reads it through
+ * getReadBuffer(). Neither side ever waits for the other: values published
+ * faster than they are consumed are overwritten, and the consumer keeps
+ * reading its current value until a newer one arrives.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  /**
+   * Slot owned by the producer, only the producer may touch it
+   */
+  T& getWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+  /**
+   * Hands the write buffer to the consumer and takes over the previously
+   * published slot for the next write
+   */
+  void publish() {
+    auto previous = m_published.exchange(
+        m_writeIndex | FRESH_BIT, std::memory_order_acq_rel
+    );
+    m_writeIndex = previous & INDEX_MASK;
+  }
+
+  /**
+   * Swaps in the newest published value, if there is one. Consumer only.
+   * @return whether the read buffer changed
+   */
+  bool update() {
+    if (!(m_published.load(std::memory_order_relaxed) & FRESH_BIT)) {
+      return false;
+    }
+
+    auto published =
+        m_published.exchange(m_readIndex, std::memory_order_acq_rel);
+    m_readIndex = published & INDEX_MASK;
+
+    return true;
+  }
+
+  /**
+   * Slot owned by the consumer, only the consumer may touch it
+   */
+  [[nodiscard]] const T& getReadBuffer() const {
+    return m_buffers[m_readIndex];
+  }
+
+ private:
+  static constexpr uint8_t INDEX_MASK = 0x3;
+  static constexpr uint8_t FRESH_BIT = 0x4;
+
+  std::array<T, 3> m_buffers{};
+  uint8_t m_writeIndex = 0;
+  /**
+   * Index of the slot in between the two threads, with FRESH_BIT set while
+   * the consumer has not picked it up yet
+   */
+  std::atomic<uint8_t> m_published = 1;
+  uint8_t m_readIndex = 2;
+};
+
+}  // namespace engine
+
+#endif  // TRIPLE_BUFFER_HPP
@@ -0,0 +1,23 @@
+#include "UniformBufferObject.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace engine {
+UniformBufferObject UniformBufferObject::create(
+    const glm::mat4& view, VkExtent2D extent
+) {
+  float aspect = (float)extent.width / (float)extent.height;
+
+  float fov = glm::radians(45.0f);
+
+  UniformBufferObject ubo{};
+  ubo.model = glm::mat4(1.0f);
+  ubo.view = view;
+  ubo.proj = glm::perspective(fov, aspect, 0.1f, 10.0f);
+
+  // Prevent image to be rendered upside down
+  ubo.proj[1][1] *= -1;
+
+  return ubo;
+}
+}  // namespace engine
@@ -0,0 +1,24 @@
+#ifndef UNIFORM_BUFFER_OBJECT_HPP
+#define UNIFORM_BUFFER_OBJECT_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+namespace engine {
+
+struct UniformBufferObject {
+  glm::mat4 model;
+  glm::mat4 view;
+  glm::mat4 proj;
+
+  /**
+   * Per-frame transforms for a model at the origin, seen through view and
+   * projected onto a render target of the given extent
+   */
+  static UniformBufferObject create(const glm::mat4& view, VkExtent2D extent);
+};
+
+}  // namespace engine
+
+#endif  // UNIFORM_BUFFER_OBJECT_HPP
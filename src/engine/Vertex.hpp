@@ -51,6 +51,35 @@ struct Vertex {
   }
 };
 
+/**
+ * Position stream split out of Vertex, for passes that only need positions
+ * like the depth pre-pass. Fetches 12 bytes per vertex instead of 32.
+ */
+struct VertexPosition {
+  glm::vec3 pos;
+
+  static constexpr VkVertexInputBindingDescription getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(VertexPosition);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+  }
+
+  static constexpr std::array<VkVertexInputAttributeDescription, 1>
+  getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(VertexPosition, pos);
+
+    return attributeDescriptions;
+  }
+};
+
 }  // namespace engine
 
 namespace std {
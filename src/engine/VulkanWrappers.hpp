@@ -13,7 +13,7 @@
  * parameter should be default initialized. Note that this function creates only
  * one pipeline at a time.
  */
-VKAPI_ATTR VkResult VKAPI_CALL createPipeline(
+inline VKAPI_ATTR VkResult VKAPI_CALL createPipeline(
     VkDevice device,
     const VkGraphicsPipelineCreateInfo* pCreateInfos,
     const VkAllocationCallbacks* pAllocator,
@@ -24,6 +24,20 @@ VKAPI_ATTR VkResult VKAPI_CALL createPipeline(
   );
 }
 
+/**
+ * Same as createPipeline, for vkCreateComputePipelines
+ */
+inline VKAPI_ATTR VkResult VKAPI_CALL createComputePipeline(
+    VkDevice device,
+    const VkComputePipelineCreateInfo* pCreateInfos,
+    const VkAllocationCallbacks* pAllocator,
+    VkPipeline* pPipelines
+) {
+  return vkCreateComputePipelines(
+      device, VK_NULL_HANDLE, 1, pCreateInfos, pAllocator, pPipelines
+  );
+}
+
 using ImageView = VkWrapper<
     VkImageView,
     VkImageViewCreateInfo,
@@ -63,6 +77,12 @@ using SwapChain = VkWrapper<
 using Fence =
     VkWrapper<VkFence, VkFenceCreateInfo, vkCreateFence, vkDestroyFence>;
 
+using QueryPool = VkWrapper<
+    VkQueryPool,
+    VkQueryPoolCreateInfo,
+    vkCreateQueryPool,
+    vkDestroyQueryPool>;
+
 using PipelineLayout = VkWrapper<
     VkPipelineLayout,
     VkPipelineLayoutCreateInfo,
@@ -75,6 +95,12 @@ using GraphicsPipeline = VkWrapper<
     createPipeline,
     vkDestroyPipeline>;
 
+using ComputePipeline = VkWrapper<
+    VkPipeline,
+    VkComputePipelineCreateInfo,
+    createComputePipeline,
+    vkDestroyPipeline>;
+
 using CommandPool = VkWrapper<
     VkCommandPool,
     VkCommandPoolCreateInfo,
@@ -105,6 +131,12 @@ using DescriptorPool = VkWrapper<
 using Image =
     VkWrapper<VkImage, VkImageCreateInfo, vkCreateImage, vkDestroyImage>;
 
+using DescriptorUpdateTemplate = VkWrapper<
+    VkDescriptorUpdateTemplate,
+    VkDescriptorUpdateTemplateCreateInfo,
+    vkCreateDescriptorUpdateTemplate,
+    vkDestroyDescriptorUpdateTemplate>;
+
 using Sampler = VkWrapper<
     VkSampler,
     VkSamplerCreateInfo,
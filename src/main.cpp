@@ -2,17 +2,27 @@
 #include <unistd.h>
 
 #include <exception>
+#include <iostream>
+#include <utility>
 
 #include "Application.h"
 
 void configureLogger();
 
-int main() {
+int main(int argc, char **argv) {
   SPDLOG_INFO("Process id {}", getpid());
   configureLogger();
+  PROFILE_THREAD_NAME("main");
 
   try {
-    app::Application app{};
+    auto options = engine::LaunchOptions::parse(argc, argv);
+
+    if (options.showHelp) {
+      std::cout << engine::LaunchOptions::getUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+
+    app::Application app{std::move(options)};
     app.run();
   } catch (const std::exception &e) {
     SPDLOG_CRITICAL(e.what());